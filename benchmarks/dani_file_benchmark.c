@@ -0,0 +1,280 @@
+// Danilib - dani_file_benchmark.c
+// Compares ways of reading a whole file sequentially by bandwidth and page faults: one big ReadFile, positioned ReadFile calls with different buffer sizes, and the strategies of dani_file.h.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_file_benchmark.c
+//
+// Usage:
+// dani_file_benchmark.exe [file name, default dani_file_benchmark.bin] [file size in MiB if the file is created, default 1024] [seconds to try for a new minimum, default 10]
+//
+// If the file doesn't exist it is created and filled with random bytes. An existing file is read as it is and the size is ignored.
+// Every test opens the file, reads all of it, adds it up as 64 bit words, and closes it again. The sums have to match between the tests.
+// ReadFile whole - one ReadFile call into a buffer that holds the whole file, the Windows version of a single read().
+// ReadFile at offsets - ReadFile calls with an explicit offset into a buffer of the given size, the Windows version of pread().
+// dani_file read - DANI_FILE_STRATEGY_READ, overlapped reads into two buffers of 1MiB.
+// dani_file map - DANI_FILE_STRATEGY_MAP with and without prefetching, in chunks of 1MiB.
+// After the first run the file is usually in the file cache, so unless the file is bigger than the memory of the machine this measures how fast cached data reaches the process and not the disk.
+// The buffers are allocated once and reused between the runs, so the page faults of the ReadFile tests are the ones of the file system and not of the buffers. dani_file allocates its two buffers on every open, so its read strategy also pays for faulting them in.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <psapi.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_PROFILER_PAGE_FAULTS 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_REPETITION_IMPLEMENTATION
+#include "dani_repetition.h"
+
+#define DANI_LIB_FILE_IMPLEMENTATION
+#include "dani_file.h"
+
+#define FILE_TEST_READ_WHOLE 0
+#define FILE_TEST_READ_AT_OFFSETS 1
+#define FILE_TEST_DANI_FILE 2
+
+typedef struct {
+    const s8 *name;
+    u32 type;
+    u64 buffer_size;
+    u32 strategy;
+    u32 flags;
+} file_test;
+
+static file_test g_file_tests[] = {
+    {"ReadFile whole", FILE_TEST_READ_WHOLE, 0, 0, 0},
+    {"ReadFile at offsets 4KiB", FILE_TEST_READ_AT_OFFSETS, KiB(4), 0, 0},
+    {"ReadFile at offsets 64KiB", FILE_TEST_READ_AT_OFFSETS, KiB(64), 0, 0},
+    {"ReadFile at offsets 1MiB", FILE_TEST_READ_AT_OFFSETS, MiB(1), 0, 0},
+    {"ReadFile at offsets 16MiB", FILE_TEST_READ_AT_OFFSETS, MiB(16), 0, 0},
+    {"dani_file read", FILE_TEST_DANI_FILE, MiB(1), DANI_FILE_STRATEGY_READ, 0},
+    {"dani_file map", FILE_TEST_DANI_FILE, MiB(1), DANI_FILE_STRATEGY_MAP, 0},
+    {"dani_file map no prefetch", FILE_TEST_DANI_FILE, MiB(1), DANI_FILE_STRATEGY_MAP, DANI_FILE_FLAG_NO_PREFETCH},
+};
+
+static u64 g_random_state = 0x9E3779B97F4A7C15ull;
+
+static u64 GetRandomFileValue(void) {
+    // xorshift64*
+    g_random_state ^= g_random_state >> 12;
+    g_random_state ^= g_random_state << 25;
+    g_random_state ^= g_random_state >> 27;
+    return (g_random_state * 0x2545F4914F6CDD1Dull);
+}
+
+static u64 SumFileData(u8 *data, u64 size) {
+    // All buffers and chunks start at least 8 byte aligned, only the last one can end on a partial word
+    u64 result = 0;
+    u64 word_count = size / sizeof(u64);
+    for (u64 index = 0; index < word_count; index += 1) {
+        result += ((u64 *)data)[index];
+    }
+    for (u64 index = word_count * sizeof(u64); index < size; index += 1) {
+        result += data[index];
+    }
+
+    return (result);
+}
+
+static b32 CreateBenchmarkFile(const s8 *file_name, u64 size) {
+    HANDLE handle = CreateFileA((const char *)file_name, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = B32_SUCCESS;
+
+    u64 *words = (u64 *)malloc(MiB(1));
+    for (u64 offset = 0; offset < size && IsSuccess(result); offset += MiB(1)) {
+        for (u64 index = 0; index < MiB(1) / sizeof(u64); index += 1) {
+            words[index] = GetRandomFileValue();
+        }
+
+        DWORD write_size = (DWORD)Min(MiB(1), size - offset);
+        DWORD written_size = 0;
+        result = (WriteFile(handle, words, write_size, &written_size, 0) && written_size == write_size);
+    }
+
+    free(words);
+    CloseHandle(handle);
+
+    return (result);
+}
+
+static b32 ReadFileWhole(const s8 *file_name, u8 *buffer, u64 file_size, u64 *sum) {
+    HANDLE handle = CreateFileA((const char *)file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    // A single ReadFile call can't read more than 4GiB, bigger files take a few calls
+    b32 result = B32_SUCCESS;
+    for (u64 offset = 0; offset < file_size && IsSuccess(result); ) {
+        DWORD read_size = 0;
+        result = (ReadFile(handle, buffer + offset, (DWORD)Min(GiB(1), file_size - offset), &read_size, 0) && read_size);
+        offset += read_size;
+    }
+
+    if (IsSuccess(result)) {
+        *sum = SumFileData(buffer, file_size);
+    }
+
+    CloseHandle(handle);
+    return (result);
+}
+
+static b32 ReadFileAtOffsets(const s8 *file_name, u8 *buffer, u64 buffer_size, u64 file_size, u64 *sum) {
+    HANDLE handle = CreateFileA((const char *)file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = B32_SUCCESS;
+    u64 total = 0;
+    for (u64 offset = 0; offset < file_size && IsSuccess(result); ) {
+        // On a handle without FILE_FLAG_OVERLAPPED this is a synchronous read at the offset in the OVERLAPPED structure
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+        DWORD read_size = 0;
+        result = (ReadFile(handle, buffer, (DWORD)Min(buffer_size, file_size - offset), &read_size, &overlapped) && read_size);
+        total += SumFileData(buffer, read_size);
+        offset += read_size;
+    }
+
+    if (IsSuccess(result)) {
+        *sum = total;
+    }
+
+    CloseHandle(handle);
+    return (result);
+}
+
+static b32 ReadDaniFile(const s8 *file_name, file_test *test, u64 *sum) {
+    dani_file file;
+    if (IsFailure(dani_OpenFile(&file, file_name, test->strategy, test->buffer_size, test->flags))) {
+        return (B32_FAILURE);
+    }
+
+    u64 total = 0;
+    dani_file_chunk chunk;
+    while (dani_NextFileChunk(&file, &chunk)) {
+        total += SumFileData(chunk.data, chunk.size);
+    }
+
+    b32 result = IsFalse(file.is_failed);
+    if (IsSuccess(result)) {
+        *sum = total;
+    }
+
+    dani_CloseFile(&file);
+    return (result);
+}
+
+int main(int argument_count, char **arguments) {
+    const s8 *file_name = (argument_count > 1) ? (const s8 *)arguments[1] : "dani_file_benchmark.bin";
+    u64 create_size = MiB((argument_count > 2) ? atoi(arguments[2]) : 1024);
+    u32 seconds_to_try = (argument_count > 3) ? atoi(arguments[3]) : 10;
+
+    u64 cpu_frequency = ReadCPUTimerFrequency(100);
+    if (create_size == 0 || cpu_frequency == 0) {
+        printf("Invalid file size or failed to estimate the CPU frequency!\n");
+        return (1);
+    }
+
+    if (GetFileAttributesA((const char *)file_name) == INVALID_FILE_ATTRIBUTES) {
+        printf("Creating %s with %lluMiB...\n", file_name, create_size / MiB(1));
+        if (IsFailure(CreateBenchmarkFile(file_name, create_size))) {
+            printf("Failed to create the file!\n");
+            return (1);
+        }
+    }
+
+    // The size comes from a strategy that doesn't read anything yet
+    dani_file probe;
+    if (IsFailure(dani_OpenFile(&probe, file_name, DANI_FILE_STRATEGY_MAP, 0, DANI_FILE_FLAG_NO_PREFETCH))) {
+        printf("Failed to open the file!\n");
+        return (1);
+    }
+    u64 file_size = probe.size;
+    dani_CloseFile(&probe);
+
+    if (file_size == 0) {
+        printf("The file is empty!\n");
+        return (1);
+    }
+
+    u8 *whole_buffer = (u8 *)VirtualAlloc(0, file_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    u8 *offset_buffer = (u8 *)VirtualAlloc(0, MiB(16), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (whole_buffer == 0 || offset_buffer == 0) {
+        printf("Failed to allocate the buffers!\n");
+        return (1);
+    }
+
+    // Fault the buffers in once, so none of the tests pays for it
+    memset(whole_buffer, 0, file_size);
+    memset(offset_buffer, 0, MiB(16));
+
+    printf("File: %s, %0.2fMiB\n", file_name, (f64)file_size / (f64)MiB(1));
+
+    dani_repetition_tester testers[ArrayCount(g_file_tests)] = {0};
+    u64 expected_sum = 0;
+    b32 has_expected_sum = B32_FALSE;
+
+    for (u32 test_index = 0; test_index < ArrayCount(g_file_tests); test_index += 1) {
+        file_test *test = &g_file_tests[test_index];
+        printf("\n--- %s ---\n", test->name);
+
+        dani_repetition_tester *tester = &testers[test_index];
+        dani_NewRepetitionTestWave(tester, file_size, cpu_frequency, seconds_to_try);
+        while (dani_IsRepetitionTesting(tester)) {
+            u64 sum = 0;
+            b32 result;
+
+            dani_BeginRepetitionTime(tester);
+            if (test->type == FILE_TEST_READ_WHOLE) {
+                result = ReadFileWhole(file_name, whole_buffer, file_size, &sum);
+            } else if (test->type == FILE_TEST_READ_AT_OFFSETS) {
+                result = ReadFileAtOffsets(file_name, offset_buffer, test->buffer_size, file_size, &sum);
+            } else {
+                result = ReadDaniFile(file_name, test, &sum);
+            }
+            dani_EndRepetitionTime(tester);
+            dani_CountRepetitionBytes(tester, file_size);
+
+            if (IsFailure(result)) {
+                dani_SetRepetitionError(tester, "Failed to read the file");
+            } else if (IsFalse(has_expected_sum)) {
+                expected_sum = sum;
+                has_expected_sum = B32_TRUE;
+            } else if (sum != expected_sum) {
+                dani_SetRepetitionError(tester, "The sum doesn't match the first test");
+            }
+        }
+
+        if (tester->state == DANI_REPETITION_STATE_ERROR) {
+            return (1);
+        }
+    }
+
+    printf("\nBest runs:\n%-28s%10s%16s\n", "", "GB/s", "Page faults");
+    for (u32 test_index = 0; test_index < ArrayCount(g_file_tests); test_index += 1) {
+        dani_repetition_value *min = &testers[test_index].results.min;
+        f64 seconds = (f64)min->ticks / (f64)cpu_frequency;
+        printf("%-28s%10.2f%16llu\n", g_file_tests[test_index].name, (f64)min->byte_count / seconds / 1000000000.0, min->page_fault_count);
+    }
+
+    return (0);
+}
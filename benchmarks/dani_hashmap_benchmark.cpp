@@ -0,0 +1,229 @@
+// Danilib - dani_hashmap_benchmark.cpp
+// Compares dani_hashmap.h with std::unordered_map on insert, hit, miss, and erase workloads.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /EHsc /I..\src dani_hashmap_benchmark.cpp Advapi32.lib
+//
+// Usage:
+// dani_hashmap_benchmark.exe [key count, default 4000000]
+//
+// Both maps start empty and grow while the keys are inserted. Both use dani_HashMapKey as the hash function, so the results only compare the data structures and not the quality of the hashes.
+// Lookups and erases go through the keys in a different random order than they were inserted in. Misses look up keys that were never inserted.
+// The memory of std::unordered_map is counted with an allocator that tracks every allocation. The memory of dani_hashmap is the size of the arena, which includes the tables that were left behind while growing.
+// dani_profiler.h uses s8 strings, which C++ doesn't convert string literals to, so this benchmark uses QueryPerformanceCounter for its timings.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unordered_map>
+
+#include "dani_base.h"
+
+#define DANI_LIB_ARENA_IMPLEMENTATION
+#include "dani_arena.h"
+
+#define DANI_LIB_HASHMAP_IMPLEMENTATION
+#include "dani_hashmap.h"
+
+static u64 g_std_allocated_bytes = 0;
+static u64 g_std_allocated_bytes_max = 0;
+static u64 g_std_allocation_count = 0;
+
+template <typename T>
+struct counting_allocator {
+    typedef T value_type;
+
+    counting_allocator() {}
+    template <typename U> counting_allocator(const counting_allocator<U> &) {}
+
+    T *allocate(size_t count) {
+        g_std_allocated_bytes += count * sizeof(T);
+        g_std_allocated_bytes_max = Max(g_std_allocated_bytes_max, g_std_allocated_bytes);
+        g_std_allocation_count += 1;
+        return ((T *)malloc(count * sizeof(T)));
+    }
+
+    void deallocate(T *memory, size_t count) {
+        g_std_allocated_bytes -= count * sizeof(T);
+        free(memory);
+    }
+};
+
+template <typename T, typename U> bool operator==(const counting_allocator<T> &, const counting_allocator<U> &) { return (true); }
+template <typename T, typename U> bool operator!=(const counting_allocator<T> &, const counting_allocator<U> &) { return (false); }
+
+struct hashmap_benchmark_hash {
+    size_t operator()(u64 key) const { return ((size_t)dani_HashMapKey(key)); }
+};
+
+typedef std::unordered_map<u64, u64, hashmap_benchmark_hash, std::equal_to<u64>, counting_allocator<std::pair<const u64, u64>>> std_map;
+
+static u64 g_random_state = 0x9E3779B97F4A7C15ull;
+
+static u64 GetRandomHashMapKey(void) {
+    // xorshift64*
+    g_random_state ^= g_random_state >> 12;
+    g_random_state ^= g_random_state << 25;
+    g_random_state ^= g_random_state >> 27;
+    return (g_random_state * 0x2545F4914F6CDD1Dull);
+}
+
+static void ShuffleHashMapKeys(u64 *keys, u64 count) {
+    for (u64 index = count - 1; index > 0; index -= 1) {
+        u64 other_index = GetRandomHashMapKey() % (index + 1);
+        u64 key = keys[index];
+        keys[index] = keys[other_index];
+        keys[other_index] = key;
+    }
+}
+
+static u64 ReadHashMapTimer(void) {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return ((u64)counter.QuadPart);
+}
+
+static void PrintHashMapResult(const char *label, u64 elapsed_ticks, u64 operation_count, u64 timer_frequency) {
+    f64 seconds = (f64)elapsed_ticks / (f64)timer_frequency;
+    printf("  %-14s: %8.2fMop/s, %6.1fns per operation\n", label, (f64)operation_count / seconds / 1000000.0, seconds * 1000000000.0 / (f64)operation_count);
+}
+
+int main(int argument_count, char **arguments) {
+    u64 key_count = (argument_count > 1) ? atoi(arguments[1]) : Million(4);
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    u64 timer_frequency = (u64)frequency.QuadPart;
+
+    if (key_count == 0) {
+        printf("Invalid arguments!\n");
+        return (1);
+    }
+
+    u64 *keys = (u64 *)malloc(key_count * sizeof(u64));
+    u64 *shuffled_keys = (u64 *)malloc(key_count * sizeof(u64));
+    u64 *missing_keys = (u64 *)malloc(key_count * sizeof(u64));
+    u64 **found_values = (u64 **)malloc(key_count * sizeof(u64 *));
+    for (u64 index = 0; index < key_count; index += 1) {
+        keys[index] = GetRandomHashMapKey();
+        shuffled_keys[index] = keys[index];
+    }
+    for (u64 index = 0; index < key_count; index += 1) {
+        missing_keys[index] = GetRandomHashMapKey();
+    }
+    ShuffleHashMapKeys(shuffled_keys, key_count);
+
+    printf("Keys: %llu\n", key_count);
+
+    // The checksums keep the lookups from being optimised away and have to match between the maps
+    u64 dani_checksum = 0;
+    u64 std_checksum = 0;
+
+    {
+        printf("dani_hashmap (group width %u):\n", DANI_HASHMAP_GROUP_WIDTH);
+
+        dani_arena arena;
+        dani_hashmap map;
+        if (IsFailure(dani_InitialiseArena(&arena, GiB(4), MiB(4), 0)) || IsFailure(dani_InitialiseHashMap(&map, &arena, 0))) {
+            printf("Failed to initialise the hash map!\n");
+            return (1);
+        }
+
+        u64 start_ticks = ReadHashMapTimer();
+        for (u64 index = 0; index < key_count; index += 1) {
+            *dani_InsertHashMap(&map, keys[index]) = index;
+        }
+        PrintHashMapResult("Insert", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        start_ticks = ReadHashMapTimer();
+        for (u64 index = 0; index < key_count; index += 1) {
+            dani_checksum += *dani_FindHashMap(&map, shuffled_keys[index]);
+        }
+        PrintHashMapResult("Hit", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        start_ticks = ReadHashMapTimer();
+        u64 found_count = 0;
+        for (u64 index = 0; index < key_count; index += 1) {
+            found_count += (dani_FindHashMap(&map, missing_keys[index]) != 0);
+        }
+        PrintHashMapResult("Miss", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        start_ticks = ReadHashMapTimer();
+        u64 batch_checksum = 0;
+        for (u64 first_index = 0; first_index < key_count; first_index += 4096) {
+            u32 batch_count = (u32)Min(key_count - first_index, 4096);
+            dani_FindHashMapBatch(&map, shuffled_keys + first_index, found_values + first_index, batch_count);
+            for (u32 batch_index = 0; batch_index < batch_count; batch_index += 1) {
+                batch_checksum += *found_values[first_index + batch_index];
+            }
+        }
+        PrintHashMapResult("Hit (batched)", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        start_ticks = ReadHashMapTimer();
+        for (u64 index = 0; index < key_count; index += 1) {
+            found_count += IsFalse(dani_RemoveHashMap(&map, shuffled_keys[index]));
+        }
+        PrintHashMapResult("Erase", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        printf("  Memory: %0.2fMiB in 1 arena, capacity %llu\n", (f64)arena.high_water_mark / (f64)MiB(1), map.capacity);
+
+        if (found_count != 0 || map.count != 0 || batch_checksum != dani_checksum) {
+            printf("  ERROR: the map returned wrong results\n");
+        }
+
+        dani_ReleaseArena(&arena);
+    }
+
+    {
+        printf("std::unordered_map:\n");
+
+        std_map map;
+
+        u64 start_ticks = ReadHashMapTimer();
+        for (u64 index = 0; index < key_count; index += 1) {
+            map[keys[index]] = index;
+        }
+        PrintHashMapResult("Insert", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        start_ticks = ReadHashMapTimer();
+        for (u64 index = 0; index < key_count; index += 1) {
+            std_checksum += map.find(shuffled_keys[index])->second;
+        }
+        PrintHashMapResult("Hit", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        start_ticks = ReadHashMapTimer();
+        u64 found_count = 0;
+        for (u64 index = 0; index < key_count; index += 1) {
+            found_count += (map.find(missing_keys[index]) != map.end());
+        }
+        PrintHashMapResult("Miss", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        u64 allocated_bytes_max = g_std_allocated_bytes_max;
+
+        start_ticks = ReadHashMapTimer();
+        for (u64 index = 0; index < key_count; index += 1) {
+            found_count += (map.erase(shuffled_keys[index]) == 0);
+        }
+        PrintHashMapResult("Erase", ReadHashMapTimer() - start_ticks, key_count, timer_frequency);
+
+        printf("  Memory: %0.2fMiB in %llu allocations\n", (f64)allocated_bytes_max / (f64)MiB(1), g_std_allocation_count);
+
+        if (found_count != 0 || map.size() != 0) {
+            printf("  ERROR: the map returned wrong results\n");
+        }
+    }
+
+    if (dani_checksum != std_checksum) {
+        printf("ERROR: the maps returned different values\n");
+    }
+
+    free(found_values);
+    free(missing_keys);
+    free(shuffled_keys);
+    free(keys);
+
+    return (0);
+}
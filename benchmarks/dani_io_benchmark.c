@@ -0,0 +1,252 @@
+// Danilib - dani_io_benchmark.c
+// Compares synchronous reads with the I/O ring and thread pool backends of dani_io.h at different pipeline depths, and reports the bandwidth of every test through profiler zones.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_io_benchmark.c Synchronization.lib
+//
+// Usage:
+// dani_io_benchmark.exe [file name, default dani_io_benchmark.bin] [file size in MiB if the file is created, default 1024] [passes per test, default 4] [block size in KiB, default 256]
+//
+// If the file doesn't exist it is created and filled with random bytes. An existing file is read as it is and the size is ignored.
+// Every pass reads the whole file in blocks and adds it up as 64 bit words. The sums have to match between the tests.
+// ReadFile synchronous - one positioned ReadFile call per block on a synchronous handle, so there is never more than one read in flight.
+// I/O ring and thread pool - dani_io.h with the given depth. The I/O ring tests are skipped on systems without I/O rings.
+// Every pass is a bandwidth zone named after its test. DANI_IO_PROFILE is enabled, so the waits for blocks are "dani_IoWait" zones inside of them. The difference between the inclusive and exclusive time of a test is the time it spent waiting, the exclusive time is the time it spent opening the file, submitting reads, and adding up the blocks.
+// After the first pass the file is usually in the file cache, where deeper pipelines matter far less than they do for the disk. To measure the disk use a file that is bigger than the memory of the machine, or empty the file cache before every run.
+//
+#include <Windows.h>
+#include <ioringapi.h>
+#include <Intrin.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_SYNC_IMPLEMENTATION
+#include "dani_sync.h"
+
+#define DANI_IO_PROFILE 1
+#define DANI_LIB_IO_IMPLEMENTATION
+#include "dani_io.h"
+
+#define IO_TEST_SYNCHRONOUS U32_MAX
+
+typedef struct {
+    const s8 *name;
+    u32 backend;
+    u32 depth;
+} io_test;
+
+static io_test g_io_tests[] = {
+    {"ReadFile synchronous", IO_TEST_SYNCHRONOUS, 1},
+    {"I/O ring depth 1", DANI_IO_BACKEND_IORING, 1},
+    {"I/O ring depth 4", DANI_IO_BACKEND_IORING, 4},
+    {"I/O ring depth 16", DANI_IO_BACKEND_IORING, 16},
+    {"I/O ring depth 64", DANI_IO_BACKEND_IORING, 64},
+    {"Thread pool depth 1", DANI_IO_BACKEND_THREADS, 1},
+    {"Thread pool depth 4", DANI_IO_BACKEND_THREADS, 4},
+    {"Thread pool depth 16", DANI_IO_BACKEND_THREADS, 16},
+    {"Thread pool depth 64", DANI_IO_BACKEND_THREADS, 64},
+};
+
+static u64 g_random_state = 0x9E3779B97F4A7C15ull;
+
+static u64 GetRandomIoValue(void) {
+    // xorshift64*
+    g_random_state ^= g_random_state >> 12;
+    g_random_state ^= g_random_state << 25;
+    g_random_state ^= g_random_state >> 27;
+    return (g_random_state * 0x2545F4914F6CDD1Dull);
+}
+
+static u64 SumIoData(u8 *data, u64 size) {
+    // All blocks start at least 8 byte aligned, only the last one can end on a partial word
+    u64 result = 0;
+    u64 word_count = size / sizeof(u64);
+    for (u64 index = 0; index < word_count; index += 1) {
+        result += ((u64 *)data)[index];
+    }
+    for (u64 index = word_count * sizeof(u64); index < size; index += 1) {
+        result += data[index];
+    }
+
+    return (result);
+}
+
+static b32 CreateBenchmarkFile(const s8 *file_name, u64 size) {
+    HANDLE handle = CreateFileA((const char *)file_name, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = B32_SUCCESS;
+
+    u64 *words = (u64 *)malloc(MiB(1));
+    for (u64 offset = 0; offset < size && IsSuccess(result); offset += MiB(1)) {
+        for (u64 index = 0; index < MiB(1) / sizeof(u64); index += 1) {
+            words[index] = GetRandomIoValue();
+        }
+
+        DWORD write_size = (DWORD)Min(MiB(1), size - offset);
+        DWORD written_size = 0;
+        result = (WriteFile(handle, words, write_size, &written_size, 0) && written_size == write_size);
+    }
+
+    free(words);
+    CloseHandle(handle);
+
+    return (result);
+}
+
+static u64 GetBenchmarkFileSize(const s8 *file_name) {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (IsFalse(GetFileAttributesExA((const char *)file_name, GetFileExInfoStandard, &attributes))) {
+        return (0);
+    }
+
+    u64 result = ((u64)attributes.nFileSizeHigh << 32) | (u64)attributes.nFileSizeLow;
+    return (result);
+}
+
+static b32 ReadFileSynchronous(const s8 *file_name, u8 *buffer, u64 block_size, u64 file_size, u64 *sum) {
+    HANDLE handle = CreateFileA((const char *)file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = B32_SUCCESS;
+    u64 total = 0;
+    for (u64 offset = 0; offset < file_size && IsSuccess(result); ) {
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+        DWORD read_size = 0;
+        result = (ReadFile(handle, buffer, (DWORD)Min(block_size, file_size - offset), &read_size, &overlapped) && read_size);
+        total += SumIoData(buffer, read_size);
+        offset += read_size;
+    }
+
+    if (IsSuccess(result)) {
+        *sum = total;
+    }
+
+    CloseHandle(handle);
+    return (result);
+}
+
+static b32 ReadIoFile(dani_io_reader *reader, const s8 *file_name, u64 *sum) {
+    if (IsFailure(dani_OpenIoFile(reader, file_name))) {
+        return (B32_FAILURE);
+    }
+
+    u64 total = 0;
+    dani_io_block block;
+    while (dani_NextIoBlock(reader, &block)) {
+        total += SumIoData(block.data, block.size);
+    }
+
+    b32 result = IsFalse(reader->is_failed);
+    if (IsSuccess(result)) {
+        *sum = total;
+    }
+
+    dani_CloseIoFile(reader);
+    return (result);
+}
+
+int main(int argument_count, char **arguments) {
+    const s8 *file_name = (argument_count > 1) ? (const s8 *)arguments[1] : "dani_io_benchmark.bin";
+    u64 create_size = MiB((argument_count > 2) ? atoi(arguments[2]) : 1024);
+    u32 pass_count = (argument_count > 3) ? atoi(arguments[3]) : 4;
+    u64 block_size = KiB((argument_count > 4) ? atoi(arguments[4]) : 256);
+
+    if (create_size == 0 || pass_count == 0 || block_size == 0) {
+        printf("Invalid arguments!\n");
+        return (1);
+    }
+
+    if (GetFileAttributesA((const char *)file_name) == INVALID_FILE_ATTRIBUTES) {
+        printf("Creating %s with %lluMiB...\n", file_name, create_size / MiB(1));
+        if (IsFailure(CreateBenchmarkFile(file_name, create_size))) {
+            printf("Failed to create the file!\n");
+            return (1);
+        }
+    }
+
+    u64 file_size = GetBenchmarkFileSize(file_name);
+    if (file_size == 0) {
+        printf("Failed to open the file or the file is empty!\n");
+        return (1);
+    }
+
+    printf("File: %s, %0.2fMiB, blocks of %lluKiB\n", file_name, (f64)file_size / (f64)MiB(1), block_size / KiB(1));
+
+    u8 *buffer = (u8 *)VirtualAlloc(0, block_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (buffer == 0) {
+        printf("Failed to allocate the buffer!\n");
+        return (1);
+    }
+
+    u64 expected_sum = 0;
+    b32 has_expected_sum = B32_FALSE;
+
+    dani_BeginProfiling();
+
+    for (u32 test_index = 0; test_index < ArrayCount(g_io_tests); test_index += 1) {
+        io_test *test = &g_io_tests[test_index];
+
+        dani_io_reader reader;
+        if (test->backend != IO_TEST_SYNCHRONOUS && IsFailure(dani_InitialiseIoReader(&reader, test->backend, test->depth, block_size))) {
+            printf("%s: skipped, the backend isn't available\n", test->name);
+            continue;
+        }
+
+        // Every test is its own zone, so it gets its own index
+        u32 zone_index = dani_GetNextProfilerZoneIndex();
+
+        for (u32 pass_index = 0; pass_index < pass_count; pass_index += 1) {
+            u64 sum = 0;
+            b32 result;
+
+            dani_profiler_zone zone = dani_BeginProfilingZone(test->name, zone_index, file_size);
+            if (test->backend == IO_TEST_SYNCHRONOUS) {
+                result = ReadFileSynchronous(file_name, buffer, block_size, file_size, &sum);
+            } else {
+                result = ReadIoFile(&reader, file_name, &sum);
+            }
+            dani_EndProfilingZone(zone);
+
+            if (IsFailure(result)) {
+                printf("%s: failed to read the file!\n", test->name);
+                return (1);
+            }
+
+            if (IsFalse(has_expected_sum)) {
+                expected_sum = sum;
+                has_expected_sum = B32_TRUE;
+            } else if (sum != expected_sum) {
+                printf("%s: the sum doesn't match the first test!\n", test->name);
+                return (1);
+            }
+        }
+
+        if (test->backend != IO_TEST_SYNCHRONOUS) {
+            dani_ReleaseIoReader(&reader);
+        }
+    }
+
+    dani_EndProfiling();
+    dani_PrintProfilingResults();
+
+    return (0);
+}
@@ -0,0 +1,134 @@
+// Danilib - dani_jobs_benchmark.c
+// Measures how dani_ParallelFor from dani_jobs.h scales from 1 worker to one worker per logical processor.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_jobs_benchmark.c Synchronization.lib
+//
+// Usage:
+// dani_jobs_benchmark.exe [element count, default 4000000] [grain size, default 4096] [repetitions, default 10]
+//
+// The compute test runs a short polynomial for every element, so it should scale with the number of cores. The memory test only adds two arrays, so it stops scaling once the memory bandwidth is saturated.
+// Every test is repeated and the fastest run is reported, the speedup is relative to the fastest run with a single worker.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_JOBS_IMPLEMENTATION
+#include "dani_jobs.h"
+
+typedef struct jobs_benchmark_data jobs_benchmark_data;
+struct jobs_benchmark_data {
+    f32 *a;
+    f32 *b;
+    f32 *result;
+};
+
+static void ComputeRange(void *data, u64 first, u64 last) {
+    jobs_benchmark_data *benchmark = (jobs_benchmark_data *)data;
+    for (u64 index = first; index < last; index += 1) {
+        f32 x = benchmark->a[index];
+        f32 y = 0.0f;
+        for (u32 iteration = 0; iteration < 64; iteration += 1) {
+            y = y * x + 0.5f;
+        }
+        benchmark->result[index] = y;
+    }
+}
+
+static void MemoryRange(void *data, u64 first, u64 last) {
+    jobs_benchmark_data *benchmark = (jobs_benchmark_data *)data;
+    for (u64 index = first; index < last; index += 1) {
+        benchmark->result[index] = benchmark->a[index] + benchmark->b[index];
+    }
+}
+
+static u64 RunJobsBenchmark(dani_job_system *job_system, dani_job_range_function *function, jobs_benchmark_data *data, u64 count, u64 grain, u32 repetitions) {
+    u64 min_ticks = U64_MAX;
+
+    for (u32 repetition = 0; repetition < repetitions; repetition += 1) {
+        u64 start_ticks = ReadStartCPUTimer();
+        dani_ParallelFor(job_system, count, grain, function, data);
+        u64 elapsed_ticks = ReadEndCPUTimer() - start_ticks;
+
+        min_ticks = Min(min_ticks, elapsed_ticks);
+    }
+
+    return (min_ticks);
+}
+
+int main(int argument_count, char **arguments) {
+    u64 count = (argument_count > 1) ? atoi(arguments[1]) : Million(4);
+    u64 grain = (argument_count > 2) ? atoi(arguments[2]) : 4096;
+    u32 repetitions = (argument_count > 3) ? atoi(arguments[3]) : 10;
+
+    u64 cpu_frequency = ReadCPUTimerFrequency(100);
+    if (count == 0 || grain == 0 || repetitions == 0 || cpu_frequency == 0) {
+        printf("Invalid arguments or failed to estimate the CPU frequency!\n");
+        return (1);
+    }
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    u32 worker_count_max = Max(system_info.dwNumberOfProcessors, 1);
+
+    jobs_benchmark_data data;
+    data.a = (f32 *)VirtualAlloc(0, 3 * count * sizeof(f32), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (data.a == 0) {
+        printf("Failed to allocate the arrays!\n");
+        return (1);
+    }
+    data.b = data.a + count;
+    data.result = data.b + count;
+
+    for (u64 index = 0; index < count; index += 1) {
+        data.a[index] = (f32)(index & 1023) / 1024.0f;
+        data.b[index] = 1.0f;
+    }
+
+    printf("Elements: %llu, grain: %llu, repetitions: %u\n", count, grain, repetitions);
+
+    u64 single_compute_ticks = 0;
+    u64 single_memory_ticks = 0;
+    for (u32 worker_count = 1; worker_count <= worker_count_max; worker_count += 1) {
+        dani_job_system job_system;
+        if (IsFailure(dani_InitialiseJobSystem(&job_system, worker_count))) {
+            printf("Failed to initialise the job system!\n");
+            return (1);
+        }
+
+        u64 compute_ticks = RunJobsBenchmark(&job_system, ComputeRange, &data, count, grain, repetitions);
+        u64 memory_ticks = RunJobsBenchmark(&job_system, MemoryRange, &data, count, grain, repetitions);
+        dani_ReleaseJobSystem(&job_system);
+
+        if (worker_count == 1) {
+            single_compute_ticks = compute_ticks;
+            single_memory_ticks = memory_ticks;
+        }
+
+        f64 compute_speedup = (f64)single_compute_ticks / (f64)compute_ticks;
+        f64 memory_speedup = (f64)single_memory_ticks / (f64)memory_ticks;
+
+        printf("%3u workers - Compute: %0.4fms (%0.2fx, %0.0f%% efficiency), Memory: %0.4fms (%0.2fx, ",
+            worker_count,
+            (f64)compute_ticks * 1000.0 / (f64)cpu_frequency, compute_speedup, 100.0 * compute_speedup / (f64)worker_count,
+            (f64)memory_ticks * 1000.0 / (f64)cpu_frequency, memory_speedup);
+        PrintProfilingValueAsSIUnit((f64)(3 * count * sizeof(f32)) * (f64)cpu_frequency / (f64)memory_ticks, "byte/s");
+        printf(")\n");
+    }
+
+    VirtualFree(data.a, 0, MEM_RELEASE);
+    return (0);
+}
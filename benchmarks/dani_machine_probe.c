@@ -0,0 +1,51 @@
+// Danilib - dani_machine_probe.c
+// Measures the bandwidth and latency of every cache level and main memory, the TLB miss cost, and the page fault cost of this machine.
+// The results are printed and written to a file that can be loaded with dani_ReadMachineFile.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_machine_probe.c Advapi32.lib
+//
+// Usage:
+// dani_machine_probe.exe [output file, default machine.dprobe]
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_ARENA_IMPLEMENTATION
+#include "dani_arena.h"
+
+#define DANI_LIB_MACHINE_IMPLEMENTATION
+#include "dani_machine.h"
+
+int main(int argument_count, char **arguments) {
+    const s8 *file_name = (argument_count > 1) ? arguments[1] : "machine.dprobe";
+
+    printf("Probing machine, this takes a few seconds...\n");
+
+    dani_machine machine;
+    if (IsFailure(dani_ProbeMachine(&machine))) {
+        printf("Failed to probe the machine!\n");
+        return (1);
+    }
+
+    dani_PrintMachine(&machine);
+
+    if (IsFailure(dani_WriteMachineFile(&machine, file_name))) {
+        printf("Failed to write %s!\n", file_name);
+        return (1);
+    }
+
+    printf("Results written to %s\n", file_name);
+    return (0);
+}
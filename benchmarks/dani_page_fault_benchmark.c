@@ -0,0 +1,185 @@
+// Danilib - dani_page_fault_benchmark.c
+// Compares buffer allocation strategies by the page faults, time, and bandwidth it takes to write a whole buffer.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_page_fault_benchmark.c Advapi32.lib
+//
+// Usage:
+// dani_page_fault_benchmark.exe [buffer size in MiB, default 256] [seconds to try for a new minimum, default 10]
+//
+// Strategies:
+// malloc - fresh malloc and free on every run.
+// reused - one buffer that is allocated and faulted in once, the best case for every other strategy.
+// VirtualAlloc - fresh committed pages on every run, every page faults on its first write.
+// VirtualAlloc + VirtualLock - pages are faulted in by locking them before the write. This is the closest Windows gets to mmap with MAP_POPULATE. The test is skipped if the working set can't be raised to hold the buffer, and fails if a lock fails anyway.
+// VirtualAlloc large pages - fresh MEM_LARGE_PAGES allocation. Windows has no transparent huge pages, so this covers both madvise(MADV_HUGEPAGE) and hugetlbfs. Requires the "Lock pages in memory" user right, otherwise the test is skipped.
+// Pre-touch forward/backward - fresh committed pages that are touched once per page in forward or backward order before the write.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <psapi.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_PROFILER_PAGE_FAULTS 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_REPETITION_IMPLEMENTATION
+#include "dani_repetition.h"
+
+#define DANI_LIB_ARENA_IMPLEMENTATION
+#include "dani_arena.h"
+
+#define BUFFER_STRATEGY_MALLOC 0
+#define BUFFER_STRATEGY_REUSED 1
+#define BUFFER_STRATEGY_VIRTUAL_ALLOC 2
+#define BUFFER_STRATEGY_VIRTUAL_LOCK 3
+#define BUFFER_STRATEGY_LARGE_PAGES 4
+#define BUFFER_STRATEGY_TOUCH_FORWARD 5
+#define BUFFER_STRATEGY_TOUCH_BACKWARD 6
+#define BUFFER_STRATEGY_COUNT 7
+
+static const s8 *g_buffer_strategy_names[BUFFER_STRATEGY_COUNT] = {
+    "malloc",
+    "reused",
+    "VirtualAlloc",
+    "VirtualAlloc + VirtualLock",
+    "VirtualAlloc large pages",
+    "Pre-touch forward",
+    "Pre-touch backward",
+};
+
+static void WriteBuffer(u8 *buffer, u64 size) {
+    for (u64 index = 0; index < size; index += 1) {
+        buffer[index] = (u8)index;
+    }
+}
+
+static void TouchPages(volatile u8 *buffer, u64 size, u64 page_size, b32 is_backward) {
+    u64 page_count = size / page_size;
+    for (u64 page_index = 0; page_index < page_count; page_index += 1) {
+        u64 touch_index = (is_backward) ? (page_count - 1 - page_index) : page_index;
+        buffer[touch_index * page_size] = 0;
+    }
+}
+
+static void RunBufferStrategy(dani_repetition_tester *tester, u32 strategy, u64 size, u64 page_size, u8 *reused_buffer, u64 large_page_size) {
+    while (dani_IsRepetitionTesting(tester)) {
+        dani_BeginRepetitionTime(tester);
+
+        switch (strategy) {
+            case BUFFER_STRATEGY_MALLOC: {
+                u8 *buffer = (u8 *)malloc(size);
+                if (buffer) {
+                    WriteBuffer(buffer, size);
+                    free(buffer);
+                }
+            } break;
+
+            case BUFFER_STRATEGY_REUSED: {
+                WriteBuffer(reused_buffer, size);
+            } break;
+
+            case BUFFER_STRATEGY_VIRTUAL_ALLOC:
+            case BUFFER_STRATEGY_VIRTUAL_LOCK:
+            case BUFFER_STRATEGY_TOUCH_FORWARD:
+            case BUFFER_STRATEGY_TOUCH_BACKWARD: {
+                u8 *buffer = (u8 *)VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+                if (buffer) {
+                    if (strategy == BUFFER_STRATEGY_VIRTUAL_LOCK) {
+                        // Without the lock the write would fault every page in and the row would measure plain VirtualAlloc
+                        if (IsFalse(VirtualLock(buffer, size))) {
+                            VirtualFree(buffer, 0, MEM_RELEASE);
+                            dani_SetRepetitionError(tester, "VirtualLock failed, the buffer doesn't fit into the working set");
+                            break;
+                        }
+                    } else if (strategy == BUFFER_STRATEGY_TOUCH_FORWARD || strategy == BUFFER_STRATEGY_TOUCH_BACKWARD) {
+                        TouchPages(buffer, size, page_size, strategy == BUFFER_STRATEGY_TOUCH_BACKWARD);
+                    }
+
+                    WriteBuffer(buffer, size);
+
+                    if (strategy == BUFFER_STRATEGY_VIRTUAL_LOCK) {
+                        VirtualUnlock(buffer, size);
+                    }
+                    VirtualFree(buffer, 0, MEM_RELEASE);
+                }
+            } break;
+
+            case BUFFER_STRATEGY_LARGE_PAGES: {
+                u64 large_size = AlignPower2(size, large_page_size);
+                u8 *buffer = (u8 *)VirtualAlloc(0, large_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (buffer) {
+                    WriteBuffer(buffer, size);
+                    VirtualFree(buffer, 0, MEM_RELEASE);
+                }
+            } break;
+        }
+
+        dani_EndRepetitionTime(tester);
+        dani_CountRepetitionBytes(tester, size);
+    }
+}
+
+int main(int argument_count, char **arguments) {
+    u64 size = MiB((argument_count > 1) ? atoi(arguments[1]) : 256);
+    u32 seconds_to_try = (argument_count > 2) ? atoi(arguments[2]) : 10;
+
+    u64 cpu_frequency = ReadCPUTimerFrequency(100);
+    if (size == 0 || cpu_frequency == 0) {
+        printf("Invalid buffer size or failed to estimate the CPU frequency!\n");
+        return (1);
+    }
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    u64 page_size = system_info.dwPageSize;
+
+    // VirtualLock can't lock more than the minimum working set size
+    b32 can_lock = SetProcessWorkingSetSize(GetCurrentProcess(), size + MiB(64), size + MiB(128));
+
+    u64 large_page_size = (dani_EnableLargePages()) ? GetLargePageMinimum() : 0;
+
+    u8 *reused_buffer = (u8 *)VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (reused_buffer == 0) {
+        printf("Failed to allocate the buffer!\n");
+        return (1);
+    }
+    WriteBuffer(reused_buffer, size);
+
+    dani_repetition_tester testers[BUFFER_STRATEGY_COUNT] = {0};
+
+    for (u32 strategy = 0; strategy < BUFFER_STRATEGY_COUNT; strategy += 1) {
+        if (strategy == BUFFER_STRATEGY_LARGE_PAGES && large_page_size == 0) {
+            printf("\n--- %s ---\nSkipped, large pages are not available\n", g_buffer_strategy_names[strategy]);
+            continue;
+        }
+
+        if (strategy == BUFFER_STRATEGY_VIRTUAL_LOCK && IsFalse(can_lock)) {
+            printf("\n--- %s ---\nSkipped, the working set can't be raised to lock the buffer\n", g_buffer_strategy_names[strategy]);
+            continue;
+        }
+
+        dani_repetition_tester *tester = &testers[strategy];
+
+        printf("\n--- %s ---\n", g_buffer_strategy_names[strategy]);
+        dani_NewRepetitionTestWave(tester, size, cpu_frequency, seconds_to_try);
+        RunBufferStrategy(tester, strategy, size, page_size, reused_buffer, large_page_size);
+
+        // A failed lock only fails its own row, the other strategies don't lock anything
+        if (tester->state == DANI_REPETITION_STATE_ERROR && strategy != BUFFER_STRATEGY_VIRTUAL_LOCK) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
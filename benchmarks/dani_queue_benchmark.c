@@ -0,0 +1,207 @@
+// Danilib - dani_queue_benchmark.c
+// Measures the throughput and latency of dani_queue.h from 1 to N producers and consumers.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_queue_benchmark.c
+//
+// Usage:
+// dani_queue_benchmark.exe [max threads per side, default half the logical processors] [batch size, default 1] [messages per producer, default 1000000]
+//
+// Every producer enqueues the CPU timestamp at the time of the enqueue. Consumers compare it with the timestamp after the dequeue to get the latency, which includes the time the message waited in the queue.
+// The CPU timestamp is assumed to be synchronised between all cores, which is the case for all recent x64 CPUs.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_QUEUE_IMPLEMENTATION
+#include "dani_queue.h"
+
+#define QUEUE_CAPACITY 4096
+#define BATCH_SIZE_MAX 256
+
+typedef struct queue_benchmark_thread queue_benchmark_thread;
+struct queue_benchmark_thread {
+    dani_queue *queue;
+    volatile b32 *is_started;
+    volatile b32 *is_producing_done;
+    u64 message_count;
+    u32 batch_size;
+
+    // Consumer results
+    u64 received_count;
+    u64 latency_ticks_total;
+    u64 latency_ticks_max;
+
+    u8 padding[64];
+};
+
+static DWORD WINAPI ProducerThread(LPVOID parameter) {
+    queue_benchmark_thread *thread = (queue_benchmark_thread *)parameter;
+    void *messages[BATCH_SIZE_MAX];
+
+    while (IsFalse(*thread->is_started)) {
+        YieldProcessor();
+    }
+
+    u64 sent_count = 0;
+    while (sent_count < thread->message_count) {
+        u32 batch_count = (u32)Min((u64)thread->batch_size, thread->message_count - sent_count);
+        u64 timestamp = ReadStartCPUTimer();
+        for (u32 message_index = 0; message_index < batch_count; message_index += 1) {
+            messages[message_index] = (void *)timestamp;
+        }
+
+        u32 enqueued_count = 0;
+        while (enqueued_count < batch_count) {
+            u32 count = dani_EnqueueBatch(thread->queue, messages + enqueued_count, batch_count - enqueued_count);
+            if (count == 0) {
+                YieldProcessor();
+            }
+            enqueued_count += count;
+        }
+
+        sent_count += batch_count;
+    }
+
+    return (0);
+}
+
+static DWORD WINAPI ConsumerThread(LPVOID parameter) {
+    queue_benchmark_thread *thread = (queue_benchmark_thread *)parameter;
+    void *messages[BATCH_SIZE_MAX];
+
+    while (IsFalse(*thread->is_started)) {
+        YieldProcessor();
+    }
+
+    for (;;) {
+        // All producers are done before the flag is set, so an empty queue after seeing it stays empty
+        b32 is_producing_done = *thread->is_producing_done;
+
+        u32 count = dani_DequeueBatch(thread->queue, messages, thread->batch_size);
+        if (count == 0) {
+            if (is_producing_done) {
+                return (0);
+            }
+
+            YieldProcessor();
+            continue;
+        }
+
+        u64 timestamp = ReadEndCPUTimer();
+        for (u32 message_index = 0; message_index < count; message_index += 1) {
+            u64 latency_ticks = timestamp - (u64)messages[message_index];
+            thread->latency_ticks_total += latency_ticks;
+            thread->latency_ticks_max = Max(thread->latency_ticks_max, latency_ticks);
+            thread->received_count += 1;
+        }
+    }
+}
+
+static void RunQueueBenchmark(u32 producer_count, u32 consumer_count, u32 batch_size, u64 message_count, u64 cpu_frequency) {
+    dani_queue queue;
+    if (IsFailure(dani_InitialiseQueue(&queue, QUEUE_CAPACITY))) {
+        printf("Failed to initialise the queue!\n");
+        return;
+    }
+
+    volatile b32 is_started = B32_FALSE;
+    volatile b32 is_producing_done = B32_FALSE;
+    u32 thread_count = producer_count + consumer_count;
+    queue_benchmark_thread *threads = (queue_benchmark_thread *)calloc(thread_count, sizeof(queue_benchmark_thread));
+    HANDLE *handles = (HANDLE *)calloc(thread_count, sizeof(HANDLE));
+
+    for (u32 thread_index = 0; thread_index < thread_count; thread_index += 1) {
+        queue_benchmark_thread *thread = &threads[thread_index];
+        thread->queue = &queue;
+        thread->is_started = &is_started;
+        thread->is_producing_done = &is_producing_done;
+        thread->message_count = message_count;
+        thread->batch_size = batch_size;
+
+        b32 is_producer = (thread_index < producer_count);
+        handles[thread_index] = CreateThread(0, 0, (is_producer) ? ProducerThread : ConsumerThread, thread, 0, 0);
+    }
+
+    u64 start_ticks = ReadStartCPUTimer();
+    is_started = B32_TRUE;
+
+    for (u32 thread_index = 0; thread_index < producer_count; thread_index += 1) {
+        WaitForSingleObject(handles[thread_index], INFINITE);
+    }
+
+    is_producing_done = B32_TRUE;
+
+    for (u32 thread_index = producer_count; thread_index < thread_count; thread_index += 1) {
+        WaitForSingleObject(handles[thread_index], INFINITE);
+    }
+
+    u64 elapsed_ticks = ReadEndCPUTimer() - start_ticks;
+
+    u64 received_count = 0;
+    u64 latency_ticks_total = 0;
+    u64 latency_ticks_max = 0;
+    for (u32 thread_index = producer_count; thread_index < thread_count; thread_index += 1) {
+        received_count += threads[thread_index].received_count;
+        latency_ticks_total += threads[thread_index].latency_ticks_total;
+        latency_ticks_max = Max(latency_ticks_max, threads[thread_index].latency_ticks_max);
+    }
+
+    f64 seconds = (f64)elapsed_ticks / (f64)cpu_frequency;
+    f64 latency_ticks_average = (received_count) ? (f64)latency_ticks_total / (f64)received_count : 0.0;
+
+    printf("%2u producers, %2u consumers: ", producer_count, consumer_count);
+    PrintProfilingValueAsSIUnit((f64)received_count / seconds, "msg/s");
+    printf(", Latency avg: %0.0f cycles (%0.3fus), max: %llu cycles (%0.3fus)", latency_ticks_average, latency_ticks_average * 1000000.0 / (f64)cpu_frequency, latency_ticks_max, (f64)latency_ticks_max * 1000000.0 / (f64)cpu_frequency);
+
+    if (received_count != (u64)producer_count * message_count) {
+        printf(" - ERROR: received %llu of %llu messages", received_count, (u64)producer_count * message_count);
+    }
+    printf("\n");
+
+    for (u32 thread_index = 0; thread_index < thread_count; thread_index += 1) {
+        CloseHandle(handles[thread_index]);
+    }
+
+    free(handles);
+    free(threads);
+    dani_ReleaseQueue(&queue);
+}
+
+int main(int argument_count, char **arguments) {
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    u32 thread_count_max = (argument_count > 1) ? atoi(arguments[1]) : Max(system_info.dwNumberOfProcessors / 2, 1);
+    u32 batch_size = (argument_count > 2) ? atoi(arguments[2]) : 1;
+    u64 message_count = (argument_count > 3) ? atoi(arguments[3]) : Million(1);
+
+    u64 cpu_frequency = ReadCPUTimerFrequency(100);
+    if (thread_count_max == 0 || batch_size == 0 || batch_size > BATCH_SIZE_MAX || message_count == 0 || cpu_frequency == 0) {
+        printf("Invalid arguments or failed to estimate the CPU frequency!\n");
+        return (1);
+    }
+
+    printf("Queue capacity: %u, batch size: %u, messages per producer: %llu\n", QUEUE_CAPACITY, batch_size, message_count);
+
+    for (u32 producer_count = 1; producer_count <= thread_count_max; producer_count += 1) {
+        for (u32 consumer_count = 1; consumer_count <= thread_count_max; consumer_count += 1) {
+            RunQueueBenchmark(producer_count, consumer_count, batch_size, message_count, cpu_frequency);
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,151 @@
+// Danilib - dani_ring_benchmark.c
+// Measures the throughput of dani_ring.h between a writer and a reader thread for different message sizes.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_ring_benchmark.c onecore.lib
+//
+// Usage:
+// dani_ring_benchmark.exe [messages per size, default 10000000] [ring capacity in KiB, default 64]
+//
+// Messages are written and read in place with reserve/commit and peek/commit. The reader checks every message, so a broken ring shows up as an error.
+// Windows doesn't expose the hardware cache miss counters to user mode, so the benchmark reports how often each side had to reload the position of the other side instead. Every reload fetches a cache line that was last written by the other core, which is where the cache misses of a ring come from.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_RING_STATISTICS
+#define DANI_LIB_RING_IMPLEMENTATION
+#include "dani_ring.h"
+
+typedef struct ring_benchmark_writer ring_benchmark_writer;
+struct ring_benchmark_writer {
+    dani_ring *ring;
+    volatile b32 *is_started;
+    u64 message_count;
+    u64 message_size;
+};
+
+static DWORD WINAPI WriterThread(LPVOID parameter) {
+    ring_benchmark_writer *writer = (ring_benchmark_writer *)parameter;
+
+    while (IsFalse(*writer->is_started)) {
+        YieldProcessor();
+    }
+
+    for (u64 message_index = 0; message_index < writer->message_count; message_index += 1) {
+        u8 *message;
+        while ((message = dani_ReserveRingWrite(writer->ring, writer->message_size)) == 0) {
+            YieldProcessor();
+        }
+
+        // Only the first and last 8 bytes are written, the rest of the message is left as it is
+        *(u64 *)message = message_index;
+        *(u64 *)(message + writer->message_size - sizeof(u64)) = message_index;
+        dani_CommitRingWrite(writer->ring, writer->message_size);
+    }
+
+    return (0);
+}
+
+static b32 RunRingBenchmark(u64 capacity, u64 message_size, u64 message_count, u64 cpu_frequency) {
+    dani_ring ring;
+    if (IsFailure(dani_InitialiseRing(&ring, capacity))) {
+        printf("Failed to initialise the ring!\n");
+        return (B32_FAILURE);
+    }
+
+    volatile b32 is_started = B32_FALSE;
+    ring_benchmark_writer writer = {0};
+    writer.ring = &ring;
+    writer.is_started = &is_started;
+    writer.message_count = message_count;
+    writer.message_size = message_size;
+
+    HANDLE writer_thread = CreateThread(0, 0, WriterThread, &writer, 0, 0);
+
+    u64 start_ticks = ReadStartCPUTimer();
+    is_started = B32_TRUE;
+
+    b32 result = B32_SUCCESS;
+    u64 received_count = 0;
+    while (received_count < message_count) {
+        u64 available_size;
+        u8 *read = dani_PeekRingRead(&ring, &available_size);
+        if (available_size == 0) {
+            YieldProcessor();
+            continue;
+        }
+
+        // Consume every complete message that is available
+        u64 read_size = 0;
+        while (read_size + message_size <= available_size) {
+            u8 *message = read + read_size;
+            if (*(u64 *)message != received_count || *(u64 *)(message + message_size - sizeof(u64)) != received_count) {
+                result = B32_FAILURE;
+            }
+
+            read_size += message_size;
+            received_count += 1;
+        }
+
+        dani_CommitRingRead(&ring, read_size);
+    }
+
+    u64 elapsed_ticks = ReadEndCPUTimer() - start_ticks;
+    WaitForSingleObject(writer_thread, INFINITE);
+    CloseHandle(writer_thread);
+
+    f64 seconds = (f64)elapsed_ticks / (f64)cpu_frequency;
+    printf("%6llubyte messages: ", message_size);
+    PrintProfilingValueAsSIUnit((f64)message_count / seconds, "msg/s");
+    printf(", ");
+    PrintProfilingValueAsSIUnit((f64)(message_count * message_size) / seconds, "byte/s");
+    printf(", Remote loads/msg - Writer: %0.4f, Reader: %0.4f",
+        (f64)ring.read_position_load_count / (f64)message_count,
+        (f64)ring.write_position_load_count / (f64)message_count);
+
+    if (IsFailure(result)) {
+        printf(" - ERROR: corrupted messages");
+    }
+    printf("\n");
+
+    dani_ReleaseRing(&ring);
+    return (result);
+}
+
+int main(int argument_count, char **arguments) {
+    u64 message_count = (argument_count > 1) ? atoi(arguments[1]) : Million(10);
+    u64 capacity = KiB((argument_count > 2) ? atoi(arguments[2]) : 64);
+
+    u64 cpu_frequency = ReadCPUTimerFrequency(100);
+    if (message_count == 0 || capacity == 0 || cpu_frequency == 0) {
+        printf("Invalid arguments or failed to estimate the CPU frequency!\n");
+        return (1);
+    }
+
+    u64 message_sizes[] = { 16, 64, 256, 1024, 4096 };
+    for (u32 size_index = 0; size_index < ArrayCount(message_sizes); size_index += 1) {
+        if (message_sizes[size_index] > capacity) {
+            continue;
+        }
+
+        if (IsFailure(RunRingBenchmark(capacity, message_sizes[size_index], message_count, cpu_frequency))) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
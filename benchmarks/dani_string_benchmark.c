@@ -0,0 +1,288 @@
+// Danilib - dani_string_benchmark.c
+// Compares the SWAR, SSE2, and AVX2 versions of the dani_string.h functions with their libc counterparts by bandwidth.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_string_benchmark.c
+// cl /nologo /O2 /arch:AVX2 /I..\src dani_string_benchmark.c (to include the AVX2 versions)
+//
+// Usage:
+// dani_string_benchmark.exe [text size in MiB, default 64] [seconds to try for a new minimum, default 5]
+//
+// The text is random words of mixed case with a newline roughly every 64 bytes. Find byte and find any byte search for bytes that are not in the text, so every run scans the whole text.
+// The libc counterparts are memchr, strcspn, a memchr loop for counting newlines, memcmp, and tolower on every byte. Compare reads two texts but only counts the bytes of one of them.
+// To lower works in place, so every run after the first sees a text that is already lower case. None of the versions branch on the letters, so this doesn't change their speed.
+// Every version is checked against libc before it is timed. The summary at the end lists the best bandwidth of every version in GB/s.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_PROFILER_PAGE_FAULTS 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_REPETITION_IMPLEMENTATION
+#include "dani_repetition.h"
+
+#define DANI_LIB_STRING_IMPLEMENTATION
+#include "dani_string.h"
+
+#define STRING_OPERATION_FIND_BYTE 0
+#define STRING_OPERATION_FIND_ANY_BYTE 1
+#define STRING_OPERATION_COUNT_NEWLINES 2
+#define STRING_OPERATION_COMPARE 3
+#define STRING_OPERATION_TO_LOWER 4
+#define STRING_OPERATION_COUNT 5
+
+#define STRING_VERSION_LIBC 0
+#define STRING_VERSION_SWAR 1
+#define STRING_VERSION_SSE2 2
+#define STRING_VERSION_AVX2 3
+#define STRING_VERSION_COUNT 4
+
+// Neither of these bytes is ever written into the text
+#define STRING_BENCHMARK_MISSING_BYTE '#'
+#define STRING_BENCHMARK_MISSING_SET "#$%&@"
+
+static const s8 *g_string_operation_names[STRING_OPERATION_COUNT] = {
+    "Find byte",
+    "Find any byte",
+    "Count newlines",
+    "Compare",
+    "To lower",
+};
+
+static const s8 *g_string_version_names[STRING_VERSION_COUNT] = {
+    "libc",
+    "SWAR",
+    "SSE2",
+    "AVX2",
+};
+
+// other is the set for find any byte and the second text for compare
+typedef u64 string_benchmark_function(dani_string text, dani_string other);
+
+static u64 FindByteLibc(dani_string text, dani_string other) {
+    Unused(other);
+    u8 *match = (u8 *)memchr(text.data, STRING_BENCHMARK_MISSING_BYTE, text.length);
+    return ((match) ? (u64)(match - text.data) : text.length);
+}
+
+static u64 FindAnyByteLibc(dani_string text, dani_string other) {
+    // The text is zero terminated for strcspn
+    Unused(other);
+    return ((u64)strcspn((const char *)text.data, STRING_BENCHMARK_MISSING_SET));
+}
+
+static u64 CountNewlinesLibc(dani_string text, dani_string other) {
+    Unused(other);
+    u64 result = 0;
+
+    u8 *at = text.data;
+    u8 *end = text.data + text.length;
+    while ((at = (u8 *)memchr(at, '\n', end - at)) != 0) {
+        result += 1;
+        at += 1;
+    }
+
+    return (result);
+}
+
+static u64 CompareLibc(dani_string text, dani_string other) {
+    s32 result = memcmp(text.data, other.data, text.length);
+    return ((u64)((result > 0) - (result < 0)));
+}
+
+static u64 ToLowerLibc(dani_string text, dani_string other) {
+    Unused(other);
+    for (u64 index = 0; index < text.length; index += 1) {
+        text.data[index] = (u8)tolower(text.data[index]);
+    }
+
+    return (0);
+}
+
+static u64 FindByteSWAR(dani_string text, dani_string other) { Unused(other); return (FindStringByteSWAR(text, STRING_BENCHMARK_MISSING_BYTE)); }
+static u64 FindAnyByteSWAR(dani_string text, dani_string other) { return (FindStringAnyByteSWAR(text, other)); }
+static u64 CountNewlinesSWAR(dani_string text, dani_string other) { Unused(other); return (CountStringByteSWAR(text, '\n')); }
+static u64 CompareSWAR(dani_string text, dani_string other) { s32 result = CompareStringSWAR(text, other); return ((u64)((result > 0) - (result < 0))); }
+static u64 ToLowerSWAR(dani_string text, dani_string other) { Unused(other); ToLowerStringSWAR(text); return (0); }
+
+#ifdef DANI_STRING_SSE2
+static u64 FindByteSSE2(dani_string text, dani_string other) { Unused(other); return (FindStringByteSSE2(text, STRING_BENCHMARK_MISSING_BYTE)); }
+static u64 FindAnyByteSSE2(dani_string text, dani_string other) { return (FindStringAnyByteSSE2(text, other)); }
+static u64 CountNewlinesSSE2(dani_string text, dani_string other) { Unused(other); return (CountStringByteSSE2(text, '\n')); }
+static u64 CompareSSE2(dani_string text, dani_string other) { s32 result = CompareStringSSE2(text, other); return ((u64)((result > 0) - (result < 0))); }
+static u64 ToLowerSSE2(dani_string text, dani_string other) { Unused(other); ToLowerStringSSE2(text); return (0); }
+#else
+#define FindByteSSE2 0
+#define FindAnyByteSSE2 0
+#define CountNewlinesSSE2 0
+#define CompareSSE2 0
+#define ToLowerSSE2 0
+#endif
+
+#ifdef DANI_STRING_AVX2
+static u64 FindByteAVX2(dani_string text, dani_string other) { Unused(other); return (FindStringByteAVX2(text, STRING_BENCHMARK_MISSING_BYTE)); }
+static u64 FindAnyByteAVX2(dani_string text, dani_string other) { return (FindStringAnyByteAVX2(text, other)); }
+static u64 CountNewlinesAVX2(dani_string text, dani_string other) { Unused(other); return (CountStringByteAVX2(text, '\n')); }
+static u64 CompareAVX2(dani_string text, dani_string other) { s32 result = CompareStringAVX2(text, other); return ((u64)((result > 0) - (result < 0))); }
+static u64 ToLowerAVX2(dani_string text, dani_string other) { Unused(other); ToLowerStringAVX2(text); return (0); }
+#else
+#define FindByteAVX2 0
+#define FindAnyByteAVX2 0
+#define CountNewlinesAVX2 0
+#define CompareAVX2 0
+#define ToLowerAVX2 0
+#endif
+
+static string_benchmark_function *g_string_functions[STRING_OPERATION_COUNT][STRING_VERSION_COUNT] = {
+    {FindByteLibc, FindByteSWAR, FindByteSSE2, FindByteAVX2},
+    {FindAnyByteLibc, FindAnyByteSWAR, FindAnyByteSSE2, FindAnyByteAVX2},
+    {CountNewlinesLibc, CountNewlinesSWAR, CountNewlinesSSE2, CountNewlinesAVX2},
+    {CompareLibc, CompareSWAR, CompareSSE2, CompareAVX2},
+    {ToLowerLibc, ToLowerSWAR, ToLowerSSE2, ToLowerAVX2},
+};
+
+static u64 g_random_state = 0x9E3779B97F4A7C15ull;
+
+static u64 GetRandomStringValue(void) {
+    // xorshift64*
+    g_random_state ^= g_random_state >> 12;
+    g_random_state ^= g_random_state << 25;
+    g_random_state ^= g_random_state >> 27;
+    return (g_random_state * 0x2545F4914F6CDD1Dull);
+}
+
+static void FillStringText(u8 *text, u64 size) {
+    u64 line_length = 0;
+    for (u64 index = 0; index < size; index += 1) {
+        u64 random = GetRandomStringValue() >> 32;
+
+        if (line_length >= 56 && (random & 7) == 0) {
+            text[index] = '\n';
+            line_length = 0;
+        } else if ((random & 7) == 1) {
+            text[index] = ' ';
+            line_length += 1;
+        } else {
+            u8 letter = (u8)('a' + (random >> 8) % 26);
+            text[index] = ((random >> 16) & 3) ? letter : (letter - 'a' + 'A');
+            line_length += 1;
+        }
+    }
+}
+
+static b32 IsStringVersionCorrect(string_benchmark_function *function, u32 operation, dani_string text, dani_string other, u8 *scratch, u8 *expected_lower) {
+    b32 result;
+    if (operation == STRING_OPERATION_TO_LOWER) {
+        memcpy(scratch, text.data, text.length);
+        function(dani_MakeString(scratch, text.length), other);
+        result = (memcmp(scratch, expected_lower, text.length) == 0);
+    } else {
+        result = (function(text, other) == g_string_functions[operation][STRING_VERSION_LIBC](text, other));
+    }
+
+    return (result);
+}
+
+int main(int argument_count, char **arguments) {
+    u64 size = MiB((argument_count > 1) ? atoi(arguments[1]) : 64);
+    u32 seconds_to_try = (argument_count > 2) ? atoi(arguments[2]) : 5;
+
+    u64 cpu_frequency = ReadCPUTimerFrequency(100);
+    if (size == 0 || cpu_frequency == 0) {
+        printf("Invalid text size or failed to estimate the CPU frequency!\n");
+        return (1);
+    }
+
+    // One more byte for the zero terminator that strcspn needs
+    u8 *text = (u8 *)VirtualAlloc(0, size + 1, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    u8 *other_text = (u8 *)VirtualAlloc(0, size + 1, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    u8 *lower_text = (u8 *)VirtualAlloc(0, size + 1, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    u8 *expected_lower = (u8 *)VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (text == 0 || other_text == 0 || lower_text == 0 || expected_lower == 0) {
+        printf("Failed to allocate the text!\n");
+        return (1);
+    }
+
+    FillStringText(text, size);
+    memcpy(other_text, text, size);
+    memcpy(expected_lower, text, size);
+    ToLowerLibc(dani_MakeString(expected_lower, size), dani_MakeString(0, 0));
+
+    dani_string text_string = dani_MakeString(text, size);
+    dani_string set_string = dani_StringLiteral(STRING_BENCHMARK_MISSING_SET);
+    dani_string other_string = dani_MakeString(other_text, size);
+
+    dani_repetition_tester testers[STRING_OPERATION_COUNT][STRING_VERSION_COUNT] = {0};
+
+    for (u32 operation = 0; operation < STRING_OPERATION_COUNT; operation += 1) {
+        dani_string other = (operation == STRING_OPERATION_COMPARE) ? other_string : set_string;
+
+        for (u32 version = 0; version < STRING_VERSION_COUNT; version += 1) {
+            string_benchmark_function *function = g_string_functions[operation][version];
+            if (function == 0) {
+                continue;
+            }
+
+            printf("\n--- %s: %s ---\n", g_string_operation_names[operation], g_string_version_names[version]);
+            if (IsFalse(IsStringVersionCorrect(function, operation, text_string, other, lower_text, expected_lower))) {
+                printf("ERROR: the result doesn't match libc\n");
+                return (1);
+            }
+
+            // To lower works on its own copy, so the text stays mixed case for the other versions
+            dani_string input = text_string;
+            if (operation == STRING_OPERATION_TO_LOWER) {
+                memcpy(lower_text, text, size);
+                input = dani_MakeString(lower_text, size);
+            }
+
+            dani_repetition_tester *tester = &testers[operation][version];
+            dani_NewRepetitionTestWave(tester, size, cpu_frequency, seconds_to_try);
+            while (dani_IsRepetitionTesting(tester)) {
+                dani_BeginRepetitionTime(tester);
+                function(input, other);
+                dani_EndRepetitionTime(tester);
+                dani_CountRepetitionBytes(tester, size);
+            }
+
+            if (tester->state == DANI_REPETITION_STATE_ERROR) {
+                return (1);
+            }
+        }
+    }
+
+    printf("\nBest bandwidth in GB/s:\n%-16s", "");
+    for (u32 version = 0; version < STRING_VERSION_COUNT; version += 1) {
+        printf("%10s", g_string_version_names[version]);
+    }
+    printf("\n");
+
+    for (u32 operation = 0; operation < STRING_OPERATION_COUNT; operation += 1) {
+        printf("%-16s", g_string_operation_names[operation]);
+        for (u32 version = 0; version < STRING_VERSION_COUNT; version += 1) {
+            dani_repetition_value *min = &testers[operation][version].results.min;
+            if (min->ticks) {
+                f64 seconds = (f64)min->ticks / (f64)cpu_frequency;
+                printf("%10.2f", (f64)min->byte_count / seconds / 1000000000.0);
+            } else {
+                printf("%10s", "-");
+            }
+        }
+        printf("\n");
+    }
+
+    return (0);
+}
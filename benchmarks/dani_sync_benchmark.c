@@ -0,0 +1,206 @@
+// Danilib - dani_sync_benchmark.c
+// Compares the locks of dani_sync.h with SRWLOCK and CRITICAL_SECTION under low and high contention.
+//
+// Build (from the benchmarks directory):
+// cl /nologo /O2 /I..\src dani_sync_benchmark.c Synchronization.lib
+//
+// Usage:
+// dani_sync_benchmark.exe [max threads, default the logical processors] [acquires per thread, default 1000000] [work outside the lock, default 200]
+//
+// Every thread increments a shared counter inside the lock and then does some private work outside of it. The high contention test skips the private work, so the threads fight for the lock all the time. The low contention test does the given number of iterations of private work between every acquire.
+// The shared counter is checked at the end of every run, so a broken lock shows up as an error.
+//
+#include <Windows.h>
+#include <Intrin.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dani_base.h"
+
+#define DANI_LIB_FORMAT_IMPLEMENTATION
+#include "dani_format.h"
+
+#define DANI_PROFILER_ENABLED 1
+#define DANI_LIB_PROFILER_IMPLEMENTATION
+#include "dani_profiler.h"
+
+#define DANI_LIB_SYNC_IMPLEMENTATION
+#include "dani_sync.h"
+
+typedef void sync_benchmark_lock_function(void *lock);
+
+typedef struct sync_benchmark_lock sync_benchmark_lock;
+struct sync_benchmark_lock {
+    const s8 *name;
+    sync_benchmark_lock_function *lock;
+    sync_benchmark_lock_function *unlock;
+};
+
+typedef struct sync_benchmark_shared sync_benchmark_shared;
+struct sync_benchmark_shared {
+    // The struct is allocated page aligned, the padding keeps the lock, the data it protects, and the start flag on their own cache lines
+    union {
+        dani_sync_mutex sync_mutex;
+        dani_ticket_lock ticket_lock;
+        SRWLOCK srwlock;
+        CRITICAL_SECTION critical_section;
+        u8 padding[2 * CACHE_LINE_SIZE];
+    } lock;
+
+    u64 counter;
+    u8 padding[CACHE_LINE_SIZE - sizeof(u64)];
+
+    volatile s32 is_started;
+};
+
+typedef struct sync_benchmark_thread sync_benchmark_thread;
+struct sync_benchmark_thread {
+    sync_benchmark_shared *shared;
+    sync_benchmark_lock *lock;
+    u64 acquire_count;
+    u32 work_count;
+
+    u8 padding[CACHE_LINE_SIZE];
+};
+
+static void LockSyncMutex(void *lock) { dani_LockSyncMutex((dani_sync_mutex *)lock); }
+static void UnlockSyncMutex(void *lock) { dani_UnlockSyncMutex((dani_sync_mutex *)lock); }
+static void LockTicket(void *lock) { dani_LockTicketLock((dani_ticket_lock *)lock); }
+static void UnlockTicket(void *lock) { dani_UnlockTicketLock((dani_ticket_lock *)lock); }
+static void LockSRW(void *lock) { AcquireSRWLockExclusive((SRWLOCK *)lock); }
+static void UnlockSRW(void *lock) { ReleaseSRWLockExclusive((SRWLOCK *)lock); }
+static void LockCriticalSection(void *lock) { EnterCriticalSection((CRITICAL_SECTION *)lock); }
+static void UnlockCriticalSection(void *lock) { LeaveCriticalSection((CRITICAL_SECTION *)lock); }
+
+static DWORD WINAPI SyncBenchmarkThread(LPVOID parameter) {
+    sync_benchmark_thread *thread = (sync_benchmark_thread *)parameter;
+    sync_benchmark_shared *shared = thread->shared;
+    void *lock = &shared->lock;
+
+    while (AtomicLoad32(&shared->is_started, MEMORY_ORDER_ACQUIRE) == 0) {
+        CpuPause();
+    }
+
+    u32 random_state = (u32)(u64)thread | 1;
+    for (u64 acquire_index = 0; acquire_index < thread->acquire_count; acquire_index += 1) {
+        thread->lock->lock(lock);
+        shared->counter += 1;
+        thread->lock->unlock(lock);
+
+        for (u32 work_index = 0; work_index < thread->work_count; work_index += 1) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 17;
+            random_state ^= random_state << 5;
+        }
+    }
+
+    // Keep the private work from being optimised away
+    return ((DWORD)(random_state == 0));
+}
+
+static b32 RunSyncBenchmark(sync_benchmark_lock *lock, u32 thread_count, u64 acquire_count, u32 work_count, u64 *elapsed_ticks) {
+    sync_benchmark_shared *shared = (sync_benchmark_shared *)VirtualAlloc(0, sizeof(sync_benchmark_shared), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    sync_benchmark_thread *threads = (sync_benchmark_thread *)calloc(thread_count, sizeof(sync_benchmark_thread));
+    HANDLE *handles = (HANDLE *)calloc(thread_count, sizeof(HANDLE));
+
+    if (lock->lock == LockSyncMutex) {
+        dani_InitialiseSyncMutex(&shared->lock.sync_mutex, "Sync Mutex");
+    } else if (lock->lock == LockTicket) {
+        dani_InitialiseTicketLock(&shared->lock.ticket_lock, "Ticket Lock");
+    } else if (lock->lock == LockSRW) {
+        InitializeSRWLock(&shared->lock.srwlock);
+    } else if (lock->lock == LockCriticalSection) {
+        InitializeCriticalSection(&shared->lock.critical_section);
+    }
+
+    for (u32 thread_index = 0; thread_index < thread_count; thread_index += 1) {
+        sync_benchmark_thread *thread = &threads[thread_index];
+        thread->shared = shared;
+        thread->lock = lock;
+        thread->acquire_count = acquire_count;
+        thread->work_count = work_count;
+
+        handles[thread_index] = CreateThread(0, 0, SyncBenchmarkThread, thread, 0, 0);
+    }
+
+    u64 start_ticks = ReadStartCPUTimer();
+    AtomicStore32(&shared->is_started, 1, MEMORY_ORDER_RELEASE);
+
+    for (u32 thread_index = 0; thread_index < thread_count; thread_index += 1) {
+        WaitForSingleObject(handles[thread_index], INFINITE);
+        CloseHandle(handles[thread_index]);
+    }
+
+    *elapsed_ticks = ReadEndCPUTimer() - start_ticks;
+
+    b32 result = (shared->counter == (u64)thread_count * acquire_count);
+
+    if (lock->lock == LockCriticalSection) {
+        DeleteCriticalSection(&shared->lock.critical_section);
+    }
+
+    free(handles);
+    free(threads);
+    VirtualFree(shared, 0, MEM_RELEASE);
+
+    return (result);
+}
+
+int main(int argument_count, char **arguments) {
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    u32 thread_count_max = (argument_count > 1) ? atoi(arguments[1]) : Max(system_info.dwNumberOfProcessors, 1);
+    u64 acquire_count = (argument_count > 2) ? atoi(arguments[2]) : Million(1);
+    u32 work_count = (argument_count > 3) ? atoi(arguments[3]) : 200;
+
+    u64 cpu_frequency = ReadCPUTimerFrequency(100);
+    if (thread_count_max == 0 || acquire_count == 0 || cpu_frequency == 0) {
+        printf("Invalid arguments or failed to estimate the CPU frequency!\n");
+        return (1);
+    }
+
+    sync_benchmark_lock locks[] = {
+        { "dani_sync_mutex", LockSyncMutex, UnlockSyncMutex },
+        { "dani_ticket_lock", LockTicket, UnlockTicket },
+        { "SRWLOCK", LockSRW, UnlockSRW },
+        { "CRITICAL_SECTION", LockCriticalSection, UnlockCriticalSection },
+    };
+
+    u32 work_counts[] = { 0, work_count };
+    const s8 *contention_names[] = { "High", "Low" };
+
+    printf("Acquires per thread: %llu, work outside the lock: %u\n", acquire_count, work_count);
+
+    for (u32 contention_index = 0; contention_index < ArrayCount(work_counts); contention_index += 1) {
+        printf("\n%s contention:\n", contention_names[contention_index]);
+
+        // Double the thread count every step, but make sure the thread count that was asked for is part of the sweep
+        for (u32 thread_count = 1; thread_count <= thread_count_max; thread_count = (thread_count < thread_count_max && thread_count * 2 > thread_count_max) ? thread_count_max : thread_count * 2) {
+            for (u32 lock_index = 0; lock_index < ArrayCount(locks); lock_index += 1) {
+                // The ticket lock never sleeps, so it falls apart once there are more threads than logical processors
+                if (locks[lock_index].lock == LockTicket && thread_count > system_info.dwNumberOfProcessors) {
+                    continue;
+                }
+
+                u64 elapsed_ticks;
+                b32 is_valid = RunSyncBenchmark(&locks[lock_index], thread_count, acquire_count, work_counts[contention_index], &elapsed_ticks);
+
+                f64 seconds = (f64)elapsed_ticks / (f64)cpu_frequency;
+                f64 total_acquire_count = (f64)thread_count * (f64)acquire_count;
+                printf("%3u threads %-16s: ", thread_count, locks[lock_index].name);
+                PrintProfilingValueAsSIUnit(total_acquire_count / seconds, "acquire/s");
+                printf(", %0.1fns per acquire", seconds * 1000000000.0 / total_acquire_count);
+
+                if (IsFalse(is_valid)) {
+                    printf(" - ERROR: lost increments");
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,391 @@
+// Danilib - dani_arena.h
+// Types and functions for linear memory arenas.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types
+// Windows.h - for VirtualAlloc, VirtualFree, GetSystemInfo, and GetLargePageMinimum
+// Windows.h - for OpenProcessToken, LookupPrivilegeValueA, and AdjustTokenPrivileges to enable large pages. Link with Advapi32.lib.
+// string.h - for memset
+// dani_profiler.h - for the commit zone and counter if DANI_ARENA_PROFILE is enabled.
+//
+// Notes:
+// This library is *NOT* thread safe. Every thread should use its own arena.
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_ARENA_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_ARENA_STATIC before including this file.
+// An arena reserves a large range of virtual memory up front and commits it in chunks of commit_size bytes while it grows. Reserving costs no physical memory, so it is fine to reserve a few GiB per arena. Pushing is a pointer bump, only crossing the committed size calls into the OS.
+// Memory is never decommitted when popping, the committed size only grows. Call dani_ReleaseArena to give everything back.
+// Pushed memory is zeroed. Use the NoZero variants if the memory is initialised right away anyway.
+// By default memory is aligned to DANI_ARENA_DEFAULT_ALIGNMENT (default 16) bytes. Use the Aligned variants for other power of 2 alignments.
+// To use large pages pass DANI_ARENA_FLAG_LARGE_PAGES. Windows can't commit large pages on demand, so the whole reserve is committed immediately and rounded up to the large page size. Large pages require the "Lock pages in memory" user right, which the arena enables with dani_EnableLargePages. If they can't be allocated, the arena falls back to regular pages. Windows has no transparent huge pages, so there is no option for those.
+// dani_EnableLargePages enables the "Lock pages in memory" privilege for the process, which has to be done before allocating with MEM_LARGE_PAGES. Other libraries (for example dani_machine.h) use it for their large page allocations. It only asks the OS once and returns the same result afterwards.
+// To move the page faults of a chunk into the commit pass DANI_ARENA_FLAG_PREFAULT. Every committed page is touched once, so pushing never faults afterwards.
+// Every thread has DANI_ARENA_SCRATCH_COUNT (default 2) scratch arenas for temporary allocations. They are created on first use with a reserve of DANI_ARENA_SCRATCH_RESERVE_SIZE (default 1GiB) and a commit size of DANI_ARENA_SCRATCH_COMMIT_SIZE (default 64KiB). Call dani_ReleaseScratchArenas before a thread exits to give their memory back.
+// Every arena tracks its high water mark, the largest position it ever reached. Use it to size reservations, dani_GetScratchHighWaterMark returns the largest one of the scratch arenas of the calling thread.
+// To report commits to the profiler set DANI_ARENA_PROFILE to 1. Every commit is timed as a "dani_ArenaCommit" bandwidth zone (including its page faults with DANI_ARENA_FLAG_PREFAULT and DANI_PROFILER_PAGE_FAULTS) and the committed bytes are added to the "Arena committed bytes" counter.
+//
+// How to use:
+//
+// dani_arena arena;
+// if (dani_InitialiseArena(&arena, GiB(4), MiB(1), 0)) {
+//     my_struct *value = dani_PushStruct(&arena, my_struct);
+//     u32 *values = dani_PushArray(&arena, u32, 1024);
+//
+//     // Temporary scopes give back everything that was pushed inside of them
+//     dani_arena_temp temp = dani_BeginArenaTemp(&arena);
+//     u8 *scratch = dani_PushArrayNoZero(&arena, u8, KiB(64));
+//     dani_EndArenaTemp(temp);
+//
+//     dani_ReleaseArena(&arena);
+// }
+//
+// To use a scratch arena for temporaries pass all arenas the function still needs to return results in as conflicts. This makes sure the scratch arena is never the arena of a caller that is still using its memory:
+//
+// u32 *CollectValues(dani_arena *arena, u32 *count) {
+//     dani_arena_temp scratch = dani_GetScratch(&arena, 1);
+//     u32 *temporary_values = dani_PushArrayNoZero(scratch.arena, u32, 4096);
+//     // Fill temporary_values...
+//     u32 *values = dani_PushArrayNoZero(arena, u32, *count);
+//     // Copy the final values...
+//     dani_ReleaseScratch(scratch);
+//     return (values);
+// }
+//
+// Functions that don't return any memory in an arena can use dani_GetScratch(0, 0).
+//
+#ifndef __DANI_LIB_ARENA_H
+#define __DANI_LIB_ARENA_H
+
+#ifdef DANI_ARENA_STATIC
+#define __DANI_ARENA_DEC static
+#define __DANI_ARENA_DEF static
+#else
+#define __DANI_ARENA_DEC extern
+#define __DANI_ARENA_DEF
+#endif
+
+#ifndef DANI_ARENA_DEFAULT_ALIGNMENT
+#define DANI_ARENA_DEFAULT_ALIGNMENT 16
+#endif
+
+#ifndef DANI_ARENA_SCRATCH_COUNT
+#define DANI_ARENA_SCRATCH_COUNT 2
+#endif
+
+#ifndef DANI_ARENA_SCRATCH_RESERVE_SIZE
+#define DANI_ARENA_SCRATCH_RESERVE_SIZE GiB(1)
+#endif
+
+#ifndef DANI_ARENA_SCRATCH_COMMIT_SIZE
+#define DANI_ARENA_SCRATCH_COMMIT_SIZE KiB(64)
+#endif
+
+#ifndef DANI_ARENA_PROFILE
+#define DANI_ARENA_PROFILE 0
+#endif
+
+#define DANI_ARENA_FLAG_LARGE_PAGES (1 << 0)
+#define DANI_ARENA_FLAG_PREFAULT (1 << 1)
+
+typedef struct __DANI_ARENA dani_arena;
+struct __DANI_ARENA {
+    u8 *base;
+
+    u64 reserve_size;
+    u64 commit_size;
+    u64 committed_size;
+    u64 position;
+    u64 high_water_mark;
+
+    u32 page_size;
+    u32 flags;
+};
+
+typedef struct __DANI_ARENA_TEMP dani_arena_temp;
+struct __DANI_ARENA_TEMP {
+    dani_arena *arena;
+    u64 position;
+};
+
+__DANI_ARENA_DEC b32 dani_EnableLargePages(void);
+
+__DANI_ARENA_DEC b32 dani_InitialiseArena(dani_arena *arena, u64 reserve_size, u64 commit_size, u32 flags);
+__DANI_ARENA_DEC void dani_ReleaseArena(dani_arena *arena);
+
+__DANI_ARENA_DEC void *dani_PushArenaAlignedNoZero(dani_arena *arena, u64 size, u64 alignment);
+__DANI_ARENA_DEC void *dani_PushArenaAligned(dani_arena *arena, u64 size, u64 alignment);
+
+__DANI_ARENA_DEC void dani_PopArena(dani_arena *arena, u64 size);
+__DANI_ARENA_DEC void dani_PopArenaTo(dani_arena *arena, u64 position);
+__DANI_ARENA_DEC void dani_ClearArena(dani_arena *arena);
+
+__DANI_ARENA_DEC dani_arena_temp dani_BeginArenaTemp(dani_arena *arena);
+__DANI_ARENA_DEC void dani_EndArenaTemp(dani_arena_temp temp);
+
+__DANI_ARENA_DEC dani_arena_temp dani_GetScratch(dani_arena **conflicts, u32 conflict_count);
+__DANI_ARENA_DEC u64 dani_GetScratchHighWaterMark(void);
+__DANI_ARENA_DEC void dani_ReleaseScratchArenas(void);
+
+#define dani_ReleaseScratch(scratch) dani_EndArenaTemp(scratch)
+
+#define dani_PushArena(arena, size) dani_PushArenaAligned((arena), (size), DANI_ARENA_DEFAULT_ALIGNMENT)
+#define dani_PushArenaNoZero(arena, size) dani_PushArenaAlignedNoZero((arena), (size), DANI_ARENA_DEFAULT_ALIGNMENT)
+
+#define dani_PushStruct(arena, type) (type *)dani_PushArenaAligned((arena), sizeof(type), Max(__alignof(type), DANI_ARENA_DEFAULT_ALIGNMENT))
+#define dani_PushStructNoZero(arena, type) (type *)dani_PushArenaAlignedNoZero((arena), sizeof(type), Max(__alignof(type), DANI_ARENA_DEFAULT_ALIGNMENT))
+#define dani_PushArray(arena, type, count) (type *)dani_PushArenaAligned((arena), sizeof(type) * (count), Max(__alignof(type), DANI_ARENA_DEFAULT_ALIGNMENT))
+#define dani_PushArrayNoZero(arena, type, count) (type *)dani_PushArenaAlignedNoZero((arena), sizeof(type) * (count), Max(__alignof(type), DANI_ARENA_DEFAULT_ALIGNMENT))
+
+#endif // __DANI_LIB_ARENA_H
+
+#ifdef DANI_LIB_ARENA_IMPLEMENTATION
+
+static void PrefaultArenaPages(volatile u8 *memory, u64 size, u32 page_size) {
+    for (u64 offset = 0; offset < size; offset += page_size) {
+        memory[offset] = 0;
+    }
+}
+
+static b32 CommitArena(dani_arena *arena, u64 required_size) {
+    u64 commit_end = AlignPower2(required_size, arena->commit_size);
+    commit_end = Min(commit_end, arena->reserve_size);
+
+    u64 commit_size = commit_end - arena->committed_size;
+    u8 *commit_start = arena->base + arena->committed_size;
+
+#if DANI_ARENA_PROFILE
+    dani_ProfileBandwidth(arena_commit, "dani_ArenaCommit", commit_size);
+#endif // DANI_ARENA_PROFILE
+
+    b32 result = (VirtualAlloc(commit_start, commit_size, MEM_COMMIT, PAGE_READWRITE) != 0);
+    if (result) {
+        if (arena->flags & DANI_ARENA_FLAG_PREFAULT) {
+            PrefaultArenaPages(commit_start, commit_size, arena->page_size);
+        }
+
+        arena->committed_size = commit_end;
+    }
+
+#if DANI_ARENA_PROFILE
+    dani_ProfileEnd(arena_commit);
+    if (result) {
+        dani_ProfileCounterAdd("Arena committed bytes", commit_size);
+    }
+#endif // DANI_ARENA_PROFILE
+
+    return (result);
+}
+
+__DANI_ARENA_DEF b32 dani_EnableLargePages(void) {
+    static b32 is_requested = B32_FALSE;
+    static b32 is_enabled = B32_FALSE;
+    if (is_requested) {
+        return (is_enabled);
+    }
+
+    is_requested = B32_TRUE;
+
+    HANDLE token;
+    if (OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        TOKEN_PRIVILEGES privileges = {0};
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+        if (LookupPrivilegeValueA(0, "SeLockMemoryPrivilege", &privileges.Privileges[0].Luid)) {
+            // AdjustTokenPrivileges succeeds even if the privilege was not assigned, so GetLastError has to be checked as well
+            AdjustTokenPrivileges(token, FALSE, &privileges, 0, 0, 0);
+            is_enabled = (GetLastError() == ERROR_SUCCESS);
+        }
+
+        CloseHandle(token);
+    }
+
+    return (is_enabled);
+}
+
+__DANI_ARENA_DEF b32 dani_InitialiseArena(dani_arena *arena, u64 reserve_size, u64 commit_size, u32 flags) {
+    memset(arena, 0, sizeof(*arena));
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    // Reserves have to be aligned to the allocation granularity (usually 64KiB) and commits to the page size
+    arena->page_size = system_info.dwPageSize;
+    arena->reserve_size = AlignPower2(reserve_size, (u64)system_info.dwAllocationGranularity);
+    arena->commit_size = AlignPower2(Max(commit_size, 1), (u64)arena->page_size);
+    arena->flags = flags;
+
+    if (flags & DANI_ARENA_FLAG_LARGE_PAGES) {
+        u64 large_page_size = GetLargePageMinimum();
+        if (large_page_size && dani_EnableLargePages()) {
+            u64 large_reserve_size = AlignPower2(reserve_size, large_page_size);
+
+            // Large pages can only be reserved and committed at once
+            arena->base = (u8 *)VirtualAlloc(0, large_reserve_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (arena->base) {
+                arena->reserve_size = large_reserve_size;
+                arena->commit_size = large_page_size;
+                arena->committed_size = large_reserve_size;
+
+#if DANI_ARENA_PROFILE
+                dani_ProfileCounterAdd("Arena committed bytes", large_reserve_size);
+#endif // DANI_ARENA_PROFILE
+
+                return (B32_SUCCESS);
+            }
+        }
+
+        // Fall back to regular pages
+        arena->flags &= ~DANI_ARENA_FLAG_LARGE_PAGES;
+    }
+
+    arena->base = (u8 *)VirtualAlloc(0, arena->reserve_size, MEM_RESERVE, PAGE_NOACCESS);
+    if (arena->base == 0) {
+        return (B32_FAILURE);
+    }
+
+    return (B32_SUCCESS);
+}
+
+__DANI_ARENA_DEF void dani_ReleaseArena(dani_arena *arena) {
+    if (arena->base) {
+        VirtualFree(arena->base, 0, MEM_RELEASE);
+    }
+
+    memset(arena, 0, sizeof(*arena));
+}
+
+__DANI_ARENA_DEF void *dani_PushArenaAlignedNoZero(dani_arena *arena, u64 size, u64 alignment) {
+    Assert(IsPower2(alignment));
+
+    u64 start = AlignPower2(arena->position, alignment);
+    u64 end = start + size;
+
+    if (end > arena->committed_size) {
+        if (end > arena->reserve_size || IsFailure(CommitArena(arena, end))) {
+            return (0);
+        }
+    }
+
+    arena->position = end;
+    if (end > arena->high_water_mark) {
+        arena->high_water_mark = end;
+    }
+
+    void *result = arena->base + start;
+    return (result);
+}
+
+__DANI_ARENA_DEF void *dani_PushArenaAligned(dani_arena *arena, u64 size, u64 alignment) {
+    void *result = dani_PushArenaAlignedNoZero(arena, size, alignment);
+    if (result) {
+        memset(result, 0, size);
+    }
+
+    return (result);
+}
+
+__DANI_ARENA_DEF void dani_PopArena(dani_arena *arena, u64 size) {
+    Assert(size <= arena->position);
+    arena->position -= Min(size, arena->position);
+}
+
+__DANI_ARENA_DEF void dani_PopArenaTo(dani_arena *arena, u64 position) {
+    Assert(position <= arena->position);
+    arena->position = Min(position, arena->position);
+}
+
+__DANI_ARENA_DEF void dani_ClearArena(dani_arena *arena) {
+    arena->position = 0;
+}
+
+__DANI_ARENA_DEF dani_arena_temp dani_BeginArenaTemp(dani_arena *arena) {
+    dani_arena_temp result;
+    result.arena = arena;
+    result.position = arena->position;
+    return (result);
+}
+
+__DANI_ARENA_DEF void dani_EndArenaTemp(dani_arena_temp temp) {
+    dani_PopArenaTo(temp.arena, temp.position);
+}
+
+static ThreadLocal dani_arena g_dani_arena_scratch[DANI_ARENA_SCRATCH_COUNT];
+
+__DANI_ARENA_DEF dani_arena_temp dani_GetScratch(dani_arena **conflicts, u32 conflict_count) {
+    for (u32 scratch_index = 0; scratch_index < DANI_ARENA_SCRATCH_COUNT; scratch_index += 1) {
+        dani_arena *scratch = &g_dani_arena_scratch[scratch_index];
+
+        b32 is_conflicting = B32_FALSE;
+        for (u32 conflict_index = 0; conflict_index < conflict_count; conflict_index += 1) {
+            if (conflicts[conflict_index] == scratch) {
+                is_conflicting = B32_TRUE;
+                break;
+            }
+        }
+
+        if (IsFalse(is_conflicting)) {
+            if (scratch->base == 0) {
+                b32 is_initialised = dani_InitialiseArena(scratch, DANI_ARENA_SCRATCH_RESERVE_SIZE, DANI_ARENA_SCRATCH_COMMIT_SIZE, 0);
+                Assert(is_initialised);
+            }
+
+            dani_arena_temp result = dani_BeginArenaTemp(scratch);
+            return (result);
+        }
+    }
+
+    // More conflicts than scratch arenas, increase DANI_ARENA_SCRATCH_COUNT
+    Assert(!"All scratch arenas are in use");
+
+    dani_arena_temp result = {0};
+    return (result);
+}
+
+__DANI_ARENA_DEF u64 dani_GetScratchHighWaterMark(void) {
+    u64 result = 0;
+    for (u32 scratch_index = 0; scratch_index < DANI_ARENA_SCRATCH_COUNT; scratch_index += 1) {
+        result = Max(result, g_dani_arena_scratch[scratch_index].high_water_mark);
+    }
+
+    return (result);
+}
+
+__DANI_ARENA_DEF void dani_ReleaseScratchArenas(void) {
+    for (u32 scratch_index = 0; scratch_index < DANI_ARENA_SCRATCH_COUNT; scratch_index += 1) {
+        dani_ReleaseArena(&g_dani_arena_scratch[scratch_index]);
+    }
+}
+
+#endif // DANI_LIB_ARENA_IMPLEMENTATION
+
+/*
+Danilib - dani_arena.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
@@ -3,14 +3,38 @@
 //
 // Author: Dani Drywa (dani@drywa.me)
 //
-// Last change: 2024/09/24 (yyyy/mm/dd)
+// Last change: 2026/10/16 (yyyy/mm/dd)
 //
 // License: See end of file
 //
+// Dependencies:
+// intrin.h - for the atomic, fence, pause, prefetch, and bit scan intrinsics on MSVC. It is included by this file.
+//
+// Notes:
+// The atomics support MSVC (x64 and ARM64), GCC, and Clang on 64 bit targets. Every atomic operation takes one of the MEMORY_ORDER_* values. Read-modify-write operations on MSVC are always sequentially consistent, which is what the Interlocked intrinsics provide.
+// Loads and stores are only atomic for naturally aligned values.
+// CACHE_LINE_SIZE is the size of a cache line on all x64 and most ARM64 CPUs. Values that are written by different threads should be at least FALSE_SHARING_SIZE apart, because Intel CPUs prefetch cache lines in pairs.
+//
 #ifndef __DANI_LIB_BASE_H
 #define __DANI_LIB_BASE_H
 
+// Compiler detection
+#if defined(__clang__)
+    #define COMPILER_CLANG 1
+#elif defined(_MSC_VER)
+    #define COMPILER_MSVC 1
+#elif defined(__GNUC__)
+    #define COMPILER_GCC 1
+#else
+    #error "Unsupported compiler"
+#endif
+
+#if defined(COMPILER_MSVC)
+    #include <intrin.h>
+#endif
+
 // Basic integer typedefs
+#if defined(_MSC_VER)
 typedef signed __int8 s8;
 typedef signed __int16 s16;
 typedef signed __int32 s32;
@@ -20,6 +44,17 @@ typedef unsigned __int8 u8;
 typedef unsigned __int16 u16;
 typedef unsigned __int32 u32;
 typedef unsigned __int64 u64;
+#else
+typedef signed char s8;
+typedef signed short s16;
+typedef signed int s32;
+typedef signed long long s64;
+
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+typedef unsigned long long u64;
+#endif
 
 // Known integer values
 #define S8_MIN (-128)
@@ -85,7 +120,11 @@ typedef u32 b32;
 
 // Assert macros
 #define Statement(x) do { x } while(0)
-#define Trap() __debugbreak()
+#if defined(_MSC_VER)
+    #define Trap() __debugbreak()
+#else
+    #define Trap() __builtin_trap()
+#endif
 #define AssertAlways(x) Statement(if (!(x)) { Trap(); })
 #ifndef NDEBUG
     #define Assert(x) AssertAlways(x)
@@ -122,6 +161,199 @@ typedef u32 b32;
 #define ByteSplat32(x) (((~U32_MIN) / 255ul) * (x))
 #define ByteSplat64(x) (((~U64_MIN) / 255ull) * (x))
 
+// Bit scan functions, the result is undefined if value is 0
+#if defined(COMPILER_MSVC)
+static __inline u32 CountTrailingZeros32(u32 value) { unsigned long result; _BitScanForward(&result, value); return ((u32)result); }
+static __inline u32 CountTrailingZeros64(u64 value) { unsigned long result; _BitScanForward64(&result, value); return ((u32)result); }
+static __inline u32 CountLeadingZeros32(u32 value) { unsigned long result; _BitScanReverse(&result, value); return (31 - (u32)result); }
+static __inline u32 CountLeadingZeros64(u64 value) { unsigned long result; _BitScanReverse64(&result, value); return (63 - (u32)result); }
+#else
+static __inline u32 CountTrailingZeros32(u32 value) { return ((u32)__builtin_ctz(value)); }
+static __inline u32 CountTrailingZeros64(u64 value) { return ((u32)__builtin_ctzll(value)); }
+static __inline u32 CountLeadingZeros32(u32 value) { return ((u32)__builtin_clz(value)); }
+static __inline u32 CountLeadingZeros64(u64 value) { return ((u32)__builtin_clzll(value)); }
+#endif
+
+// Cache line and alignment macros
+#define CACHE_LINE_SIZE 64
+#define FALSE_SHARING_SIZE 128
+
+#if defined(_MSC_VER)
+    #define AlignAs(alignment) __declspec(align(alignment))
+    #define AlignOf(type) __alignof(type)
+#else
+    #define AlignAs(alignment) __attribute__((aligned(alignment)))
+    #define AlignOf(type) __alignof__(type)
+#endif
+#define CacheAligned AlignAs(CACHE_LINE_SIZE)
+
+// Thread local storage, MinGW ignores __declspec(thread) so GCC and Clang use __thread
+#if defined(COMPILER_MSVC)
+    #define ThreadLocal __declspec(thread)
+#else
+    #define ThreadLocal __thread
+#endif
+
+// Pads a struct from used_size bytes up to the next multiple of the cache line size
+#define CacheLinePadding(name, used_size) u8 name[CACHE_LINE_SIZE - ((used_size) % CACHE_LINE_SIZE)]
+
+// Memory orders, the values match the GCC and Clang __ATOMIC_* values
+#define MEMORY_ORDER_RELAXED 0
+#define MEMORY_ORDER_ACQUIRE 2
+#define MEMORY_ORDER_RELEASE 3
+#define MEMORY_ORDER_ACQ_REL 4
+#define MEMORY_ORDER_SEQ_CST 5
+
+// Fence and pause macros
+#if defined(COMPILER_MSVC)
+    #define CompilerBarrier() _ReadWriteBarrier()
+    #if defined(_M_ARM64)
+        #define MemoryFence() __dmb(_ARM64_BARRIER_ISH)
+        #define AcquireFence() __dmb(_ARM64_BARRIER_ISH)
+        #define ReleaseFence() __dmb(_ARM64_BARRIER_ISH)
+        #define CpuPause() __yield()
+    #else
+        // x64 only reorders stores with later loads, so acquire and release fences only have to stop the compiler
+        #define MemoryFence() __faststorefence()
+        #define AcquireFence() _ReadWriteBarrier()
+        #define ReleaseFence() _ReadWriteBarrier()
+        #define CpuPause() _mm_pause()
+    #endif
+#else
+    #define CompilerBarrier() __asm__ __volatile__("" ::: "memory")
+    #define MemoryFence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+    #define AcquireFence() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+    #define ReleaseFence() __atomic_thread_fence(__ATOMIC_RELEASE)
+    #if defined(__x86_64__) || defined(__i386__)
+        #define CpuPause() __builtin_ia32_pause()
+    #elif defined(__aarch64__) || defined(__arm__)
+        #define CpuPause() __asm__ __volatile__("yield")
+    #else
+        #define CpuPause() CompilerBarrier()
+    #endif
+#endif
+
+// Prefetches the cache line of address into all cache levels
+#if defined(COMPILER_MSVC)
+    #if defined(_M_ARM64)
+        #define PrefetchCacheLine(address) __prefetch((const void *)(address))
+    #else
+        #define PrefetchCacheLine(address) _mm_prefetch((const char *)(address), _MM_HINT_T0)
+    #endif
+#else
+    #define PrefetchCacheLine(address) __builtin_prefetch((const void *)(address), 0, 3)
+#endif
+
+// Atomic functions
+// Compare exchange and exchange return the previous value. Add returns the previous value, increment and decrement return the new value.
+#if defined(COMPILER_MSVC)
+
+#if defined(_M_ARM64)
+    #define __DANI_BASE_LOAD_FENCE(order) Statement(if ((order) != MEMORY_ORDER_RELAXED) { AcquireFence(); })
+    #define __DANI_BASE_STORE_FENCE(order) Statement(if ((order) != MEMORY_ORDER_RELAXED) { ReleaseFence(); })
+    #define __DANI_BASE_SEQ_CST_STORE_FENCE(order) Statement(if ((order) == MEMORY_ORDER_SEQ_CST) { MemoryFence(); })
+#else
+    #define __DANI_BASE_LOAD_FENCE(order) CompilerBarrier()
+    #define __DANI_BASE_STORE_FENCE(order) CompilerBarrier()
+    #define __DANI_BASE_SEQ_CST_STORE_FENCE(order) Statement(if ((order) == MEMORY_ORDER_SEQ_CST) { MemoryFence(); })
+#endif
+
+static __inline s32 AtomicLoad32(volatile s32 *value, s32 order) {
+    s32 result = __iso_volatile_load32((volatile int *)value);
+    __DANI_BASE_LOAD_FENCE(order);
+    return (result);
+}
+
+static __inline s64 AtomicLoad64(volatile s64 *value, s32 order) {
+    s64 result = __iso_volatile_load64((volatile __int64 *)value);
+    __DANI_BASE_LOAD_FENCE(order);
+    return (result);
+}
+
+static __inline void AtomicStore32(volatile s32 *value, s32 new_value, s32 order) {
+    __DANI_BASE_STORE_FENCE(order);
+    __iso_volatile_store32((volatile int *)value, new_value);
+    __DANI_BASE_SEQ_CST_STORE_FENCE(order);
+}
+
+static __inline void AtomicStore64(volatile s64 *value, s64 new_value, s32 order) {
+    __DANI_BASE_STORE_FENCE(order);
+    __iso_volatile_store64((volatile __int64 *)value, new_value);
+    __DANI_BASE_SEQ_CST_STORE_FENCE(order);
+}
+
+static __inline s32 AtomicExchange32(volatile s32 *value, s32 new_value, s32 order) {
+    Unused(order);
+    s32 result = (s32)_InterlockedExchange((volatile long *)value, (long)new_value);
+    return (result);
+}
+
+static __inline s64 AtomicExchange64(volatile s64 *value, s64 new_value, s32 order) {
+    Unused(order);
+    s64 result = _InterlockedExchange64((volatile __int64 *)value, new_value);
+    return (result);
+}
+
+static __inline s32 AtomicCompareExchange32(volatile s32 *value, s32 expected, s32 new_value, s32 order) {
+    Unused(order);
+    s32 result = (s32)_InterlockedCompareExchange((volatile long *)value, (long)new_value, (long)expected);
+    return (result);
+}
+
+static __inline s64 AtomicCompareExchange64(volatile s64 *value, s64 expected, s64 new_value, s32 order) {
+    Unused(order);
+    s64 result = _InterlockedCompareExchange64((volatile __int64 *)value, new_value, expected);
+    return (result);
+}
+
+static __inline s32 AtomicAdd32(volatile s32 *value, s32 addend, s32 order) {
+    Unused(order);
+    s32 result = (s32)_InterlockedExchangeAdd((volatile long *)value, (long)addend);
+    return (result);
+}
+
+static __inline s64 AtomicAdd64(volatile s64 *value, s64 addend, s32 order) {
+    Unused(order);
+    s64 result = _InterlockedExchangeAdd64((volatile __int64 *)value, addend);
+    return (result);
+}
+
+#else
+
+static __inline s32 AtomicLoad32(volatile s32 *value, s32 order) { return (__atomic_load_n(value, order)); }
+static __inline s64 AtomicLoad64(volatile s64 *value, s32 order) { return (__atomic_load_n(value, order)); }
+
+static __inline void AtomicStore32(volatile s32 *value, s32 new_value, s32 order) { __atomic_store_n(value, new_value, order); }
+static __inline void AtomicStore64(volatile s64 *value, s64 new_value, s32 order) { __atomic_store_n(value, new_value, order); }
+
+static __inline s32 AtomicExchange32(volatile s32 *value, s32 new_value, s32 order) { return (__atomic_exchange_n(value, new_value, order)); }
+static __inline s64 AtomicExchange64(volatile s64 *value, s64 new_value, s32 order) { return (__atomic_exchange_n(value, new_value, order)); }
+
+static __inline s32 AtomicCompareExchange32(volatile s32 *value, s32 expected, s32 new_value, s32 order) {
+    __atomic_compare_exchange_n(value, &expected, new_value, 0, order, (order == MEMORY_ORDER_ACQ_REL || order == MEMORY_ORDER_RELEASE) ? MEMORY_ORDER_ACQUIRE : order);
+    return (expected);
+}
+
+static __inline s64 AtomicCompareExchange64(volatile s64 *value, s64 expected, s64 new_value, s32 order) {
+    __atomic_compare_exchange_n(value, &expected, new_value, 0, order, (order == MEMORY_ORDER_ACQ_REL || order == MEMORY_ORDER_RELEASE) ? MEMORY_ORDER_ACQUIRE : order);
+    return (expected);
+}
+
+static __inline s32 AtomicAdd32(volatile s32 *value, s32 addend, s32 order) { return (__atomic_fetch_add(value, addend, order)); }
+static __inline s64 AtomicAdd64(volatile s64 *value, s64 addend, s32 order) { return (__atomic_fetch_add(value, addend, order)); }
+
+#endif
+
+static __inline s32 AtomicIncrement32(volatile s32 *value) { return (AtomicAdd32(value, 1, MEMORY_ORDER_SEQ_CST) + 1); }
+static __inline s32 AtomicDecrement32(volatile s32 *value) { return (AtomicAdd32(value, -1, MEMORY_ORDER_SEQ_CST) - 1); }
+static __inline s64 AtomicIncrement64(volatile s64 *value) { return (AtomicAdd64(value, 1, MEMORY_ORDER_SEQ_CST) + 1); }
+static __inline s64 AtomicDecrement64(volatile s64 *value) { return (AtomicAdd64(value, -1, MEMORY_ORDER_SEQ_CST) - 1); }
+
+#define AtomicLoadPointer(value, order) ((void *)AtomicLoad64((volatile s64 *)(value), (order)))
+#define AtomicStorePointer(value, new_value, order) AtomicStore64((volatile s64 *)(value), (s64)(new_value), (order))
+#define AtomicExchangePointer(value, new_value, order) ((void *)AtomicExchange64((volatile s64 *)(value), (s64)(new_value), (order)))
+#define AtomicCompareExchangePointer(value, expected, new_value, order) ((void *)AtomicCompareExchange64((volatile s64 *)(value), (s64)(expected), (s64)(new_value), (order)))
+
 #endif // __DANI_LIB_BASE_H
 
 /*
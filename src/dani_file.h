@@ -0,0 +1,379 @@
+// Danilib - dani_file.h
+// Types and functions for reading whole files sequentially through a memory mapped view or double buffered reads.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types
+// Windows.h - for CreateFileA, ReadFile, GetOverlappedResult, CreateFileMappingA, MapViewOfFile, PrefetchVirtualMemory (Windows 8 and later), and VirtualAlloc
+// string.h - for memset
+// dani_profiler.h - for the read and prefetch zones if DANI_FILE_PROFILE is enabled.
+//
+// Notes:
+// This library is *NOT* thread safe. Every thread should read its own files.
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_FILE_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_FILE_STATIC before including this file.
+// A file is read front to back in chunks of chunk_size bytes (0 uses DANI_FILE_DEFAULT_CHUNK_SIZE, default 1MiB). Every chunk stays valid until the next call to dani_NextFileChunk. The strategy decides where the chunks come from:
+// DANI_FILE_STRATEGY_MAP maps the whole file into memory. Chunks point straight into the view and the file is also available as a whole through view and size. The pages are loaded by page faults, so the view is prefetched with PrefetchVirtualMemory in windows of chunk_size bytes that move DANI_FILE_PREFETCH_WINDOWS (default 4) chunks ahead of the consumer. The file is opened with FILE_FLAG_SEQUENTIAL_SCAN, which lets the cache manager read ahead aggressively as well.
+// DANI_FILE_STRATEGY_READ reads the file with overlapped ReadFile calls into two buffers of chunk_size bytes. While the consumer works on one buffer the next chunk is read into the other one, so the disk never waits for the consumer and the consumer only waits if the disk is slower.
+// DANI_FILE_STRATEGY_AUTO maps files of at least DANI_FILE_MAP_MIN_SIZE (default 4MiB) and reads smaller ones, for which setting up a mapping costs more than copying. If the file can't be mapped, for example because the view doesn't fit into the address space, it is read instead. The strategy member holds the strategy that was picked.
+// A mapping never copies the data but pays one page fault per page that isn't prefetched in time, reading copies every byte once but only touches the same two buffers over and over. Which one is faster depends on the machine and on how much work the consumer does per byte, dani_file_benchmark.c compares them.
+// To walk the view of a mapped file directly instead of using chunks call dani_AdvanceFileView with the offset that was reached every now and then, so the prefetch windows keep moving.
+// Pass DANI_FILE_FLAG_NO_PREFETCH to rely on page faults and the read ahead of the cache manager only.
+// To report reads to the profiler set DANI_FILE_PROFILE to 1. Waiting for a read is timed as a "dani_FileRead" bandwidth zone and every PrefetchVirtualMemory call as a "dani_FilePrefetch" bandwidth zone.
+//
+// How to use:
+//
+// dani_file file;
+// if (dani_OpenFile(&file, "input.log", DANI_FILE_STRATEGY_AUTO, 0, 0)) {
+//     dani_file_chunk chunk;
+//     while (dani_NextFileChunk(&file, &chunk)) {
+//         // Process chunk.size bytes at chunk.data, which are at chunk.offset in the file
+//     }
+//
+//     if (file.is_failed) {
+//         // A read failed before the end of the file was reached
+//     }
+//
+//     dani_CloseFile(&file);
+// }
+//
+#ifndef __DANI_LIB_FILE_H
+#define __DANI_LIB_FILE_H
+
+#ifdef DANI_FILE_STATIC
+#define __DANI_FILE_DEC static
+#define __DANI_FILE_DEF static
+#else
+#define __DANI_FILE_DEC extern
+#define __DANI_FILE_DEF
+#endif
+
+#ifndef DANI_FILE_DEFAULT_CHUNK_SIZE
+#define DANI_FILE_DEFAULT_CHUNK_SIZE MiB(1)
+#endif
+
+#ifndef DANI_FILE_PREFETCH_WINDOWS
+#define DANI_FILE_PREFETCH_WINDOWS 4
+#endif
+
+#ifndef DANI_FILE_MAP_MIN_SIZE
+#define DANI_FILE_MAP_MIN_SIZE MiB(4)
+#endif
+
+#ifndef DANI_FILE_PROFILE
+#define DANI_FILE_PROFILE 0
+#endif
+
+#define DANI_FILE_STRATEGY_AUTO 0
+#define DANI_FILE_STRATEGY_MAP 1
+#define DANI_FILE_STRATEGY_READ 2
+
+#define DANI_FILE_FLAG_NO_PREFETCH (1 << 0)
+
+typedef struct __DANI_FILE_CHUNK dani_file_chunk;
+struct __DANI_FILE_CHUNK {
+    u8 *data;
+    u64 size;
+    u64 offset;
+};
+
+typedef struct __DANI_FILE dani_file;
+struct __DANI_FILE {
+    HANDLE handle;
+    u64 size;
+    u64 chunk_size;
+    u64 offset;
+
+    u32 strategy;
+    u32 flags;
+    b32 is_failed;
+
+    // DANI_FILE_STRATEGY_MAP
+    HANDLE mapping;
+    u8 *view;
+    u64 prefetch_offset;
+
+    // DANI_FILE_STRATEGY_READ
+    u8 *buffers[2];
+    OVERLAPPED overlapped[2];
+    b32 is_pending[2];
+    u32 buffer_index;
+    u64 read_offset;
+};
+
+__DANI_FILE_DEC b32 dani_OpenFile(dani_file *file, const s8 *file_name, u32 strategy, u64 chunk_size, u32 flags);
+__DANI_FILE_DEC void dani_CloseFile(dani_file *file);
+
+__DANI_FILE_DEC b32 dani_NextFileChunk(dani_file *file, dani_file_chunk *chunk);
+__DANI_FILE_DEC void dani_AdvanceFileView(dani_file *file, u64 offset);
+
+#endif // __DANI_LIB_FILE_H
+
+#ifdef DANI_LIB_FILE_IMPLEMENTATION
+
+static void PrefetchFileWindows(dani_file *file, u64 consumer_offset) {
+    u64 prefetch_end = Min(consumer_offset + (u64)DANI_FILE_PREFETCH_WINDOWS * file->chunk_size, file->size);
+
+    while (file->prefetch_offset < prefetch_end) {
+        u64 window_size = Min(file->chunk_size, file->size - file->prefetch_offset);
+
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = file->view + file->prefetch_offset;
+        range.NumberOfBytes = (SIZE_T)window_size;
+
+#if DANI_FILE_PROFILE
+        dani_ProfileBandwidth(file_prefetch, "dani_FilePrefetch", window_size);
+#endif // DANI_FILE_PROFILE
+
+        // This only queues the reads, a failure just means the pages are faulted in later
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+
+#if DANI_FILE_PROFILE
+        dani_ProfileEnd(file_prefetch);
+#endif // DANI_FILE_PROFILE
+
+        file->prefetch_offset += window_size;
+    }
+}
+
+static void IssueFileRead(dani_file *file, u32 buffer_index) {
+    u64 read_size = Min(file->chunk_size, file->size - file->read_offset);
+
+    OVERLAPPED *overlapped = &file->overlapped[buffer_index];
+    overlapped->Internal = 0;
+    overlapped->InternalHigh = 0;
+    overlapped->Offset = (DWORD)file->read_offset;
+    overlapped->OffsetHigh = (DWORD)(file->read_offset >> 32);
+    ResetEvent(overlapped->hEvent);
+
+    // Reads that are served from the file cache can complete right away, they are still picked up with GetOverlappedResult
+    if (ReadFile(file->handle, file->buffers[buffer_index], (DWORD)read_size, 0, overlapped) || GetLastError() == ERROR_IO_PENDING) {
+        file->is_pending[buffer_index] = B32_TRUE;
+        file->read_offset += read_size;
+    } else {
+        file->is_failed = B32_TRUE;
+    }
+}
+
+static u64 WaitForFileRead(dani_file *file, u32 buffer_index) {
+    DWORD read_size = 0;
+    if (IsFalse(GetOverlappedResult(file->handle, &file->overlapped[buffer_index], &read_size, TRUE))) {
+        file->is_failed = B32_TRUE;
+        read_size = 0;
+    }
+
+    file->is_pending[buffer_index] = B32_FALSE;
+    return ((u64)read_size);
+}
+
+static void CloseMappedFile(dani_file *file) {
+    if (file->view) {
+        UnmapViewOfFile(file->view);
+        file->view = 0;
+    }
+    if (file->mapping) {
+        CloseHandle(file->mapping);
+        file->mapping = 0;
+    }
+    file->prefetch_offset = 0;
+}
+
+static b32 OpenMappedFile(dani_file *file) {
+    // Windows can't map empty files, they simply have no chunks
+    if (file->size) {
+        file->mapping = CreateFileMappingA(file->handle, 0, PAGE_READONLY, 0, 0, 0);
+        if (file->mapping == 0) {
+            return (B32_FAILURE);
+        }
+
+        file->view = (u8 *)MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0);
+        if (file->view == 0) {
+            return (B32_FAILURE);
+        }
+
+        if ((file->flags & DANI_FILE_FLAG_NO_PREFETCH) == 0) {
+            PrefetchFileWindows(file, 0);
+        }
+    }
+
+    return (B32_SUCCESS);
+}
+
+static b32 OpenReadFile(dani_file *file) {
+    // Both buffers come from one page aligned allocation
+    file->buffers[0] = (u8 *)VirtualAlloc(0, file->chunk_size * 2, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (file->buffers[0] == 0) {
+        return (B32_FAILURE);
+    }
+    file->buffers[1] = file->buffers[0] + file->chunk_size;
+
+    for (u32 buffer_index = 0; buffer_index < ArrayCount(file->overlapped); buffer_index += 1) {
+        file->overlapped[buffer_index].hEvent = CreateEventA(0, TRUE, FALSE, 0);
+        if (file->overlapped[buffer_index].hEvent == 0) {
+            return (B32_FAILURE);
+        }
+    }
+
+    if (file->size) {
+        IssueFileRead(file, 0);
+    }
+
+    b32 result = IsFalse(file->is_failed);
+    return (result);
+}
+
+__DANI_FILE_DEF b32 dani_OpenFile(dani_file *file, const s8 *file_name, u32 strategy, u64 chunk_size, u32 flags) {
+    memset(file, 0, sizeof(*file));
+    file->chunk_size = (chunk_size) ? chunk_size : DANI_FILE_DEFAULT_CHUNK_SIZE;
+    file->flags = flags;
+
+    // A single ReadFile call can't read more than 4GiB
+    file->chunk_size = Min(file->chunk_size, (u64)U32_MAX & ~(u64)(KiB(64) - 1));
+
+    // The strategy of DANI_FILE_STRATEGY_AUTO depends on the size, so the file is always opened for overlapped reads. Mapping doesn't care about that flag.
+    file->handle = CreateFileA((const char *)file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OVERLAPPED, 0);
+    if (file->handle == INVALID_HANDLE_VALUE) {
+        file->handle = 0;
+        return (B32_FAILURE);
+    }
+
+    LARGE_INTEGER size;
+    if (IsFalse(GetFileSizeEx(file->handle, &size))) {
+        dani_CloseFile(file);
+        return (B32_FAILURE);
+    }
+    file->size = (u64)size.QuadPart;
+
+    b32 is_auto = (strategy == DANI_FILE_STRATEGY_AUTO);
+    if (is_auto) {
+        strategy = (file->size >= DANI_FILE_MAP_MIN_SIZE) ? DANI_FILE_STRATEGY_MAP : DANI_FILE_STRATEGY_READ;
+    }
+    file->strategy = strategy;
+
+    b32 result = (strategy == DANI_FILE_STRATEGY_MAP) ? OpenMappedFile(file) : OpenReadFile(file);
+    if (IsFailure(result) && is_auto && strategy == DANI_FILE_STRATEGY_MAP) {
+        // Reading only needs two chunks of memory, so it still works when the view doesn't fit into the address space
+        CloseMappedFile(file);
+        file->strategy = DANI_FILE_STRATEGY_READ;
+        result = OpenReadFile(file);
+    }
+
+    if (IsFailure(result)) {
+        dani_CloseFile(file);
+    }
+
+    return (result);
+}
+
+__DANI_FILE_DEF void dani_CloseFile(dani_file *file) {
+    CloseMappedFile(file);
+
+    for (u32 buffer_index = 0; buffer_index < ArrayCount(file->overlapped); buffer_index += 1) {
+        // The buffers can't be freed while a read is still writing into them
+        if (file->is_pending[buffer_index]) {
+            DWORD read_size;
+            CancelIoEx(file->handle, &file->overlapped[buffer_index]);
+            GetOverlappedResult(file->handle, &file->overlapped[buffer_index], &read_size, TRUE);
+        }
+        if (file->overlapped[buffer_index].hEvent) {
+            CloseHandle(file->overlapped[buffer_index].hEvent);
+        }
+    }
+
+    if (file->buffers[0]) {
+        VirtualFree(file->buffers[0], 0, MEM_RELEASE);
+    }
+    if (file->handle) {
+        CloseHandle(file->handle);
+    }
+
+    memset(file, 0, sizeof(*file));
+}
+
+__DANI_FILE_DEF void dani_AdvanceFileView(dani_file *file, u64 offset) {
+    if (file->view && (file->flags & DANI_FILE_FLAG_NO_PREFETCH) == 0) {
+        PrefetchFileWindows(file, offset);
+    }
+}
+
+__DANI_FILE_DEF b32 dani_NextFileChunk(dani_file *file, dani_file_chunk *chunk) {
+    chunk->data = 0;
+    chunk->size = 0;
+    chunk->offset = file->offset;
+
+    if (file->offset >= file->size || file->is_failed) {
+        return (B32_FALSE);
+    }
+
+    if (file->strategy == DANI_FILE_STRATEGY_MAP) {
+        chunk->data = file->view + file->offset;
+        chunk->size = Min(file->chunk_size, file->size - file->offset);
+
+        // Keep the prefetch windows ahead of the end of this chunk
+        dani_AdvanceFileView(file, file->offset + chunk->size);
+    } else {
+        u32 buffer_index = file->buffer_index;
+        u64 expected_size = Min(file->chunk_size, file->size - file->offset);
+
+#if DANI_FILE_PROFILE
+        dani_ProfileBandwidth(file_read, "dani_FileRead", expected_size);
+#endif // DANI_FILE_PROFILE
+
+        u64 read_size = WaitForFileRead(file, buffer_index);
+
+#if DANI_FILE_PROFILE
+        dani_ProfileEnd(file_read);
+#endif // DANI_FILE_PROFILE
+
+        // Reads of regular files only come up short if the file got shorter while it was read
+        if (read_size != expected_size) {
+            file->is_failed = B32_TRUE;
+            return (B32_FALSE);
+        }
+
+        // The other buffer was handed out by the previous call, which is done with it now
+        if (file->read_offset < file->size) {
+            IssueFileRead(file, buffer_index ^ 1);
+        }
+
+        chunk->data = file->buffers[buffer_index];
+        chunk->size = read_size;
+        file->buffer_index = buffer_index ^ 1;
+    }
+
+    file->offset += chunk->size;
+    return (B32_TRUE);
+}
+
+#endif // DANI_LIB_FILE_IMPLEMENTATION
+
+/*
+Danilib - dani_file.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
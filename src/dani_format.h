@@ -0,0 +1,576 @@
+// Danilib - dani_format.h
+// Types and functions for formatting numbers and text into a caller provided buffer without allocations.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types and CountLeadingZeros64
+// stdarg.h - for va_list in dani_FormatPrint
+// string.h - for memcpy and strlen
+//
+// Notes:
+// This library is *NOT* thread safe. Every thread needs its own buffer.
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_FORMAT_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_FORMAT_STATIC before including this file.
+// A dani_format_buffer appends to memory that is owned by the caller. If the buffer has a flush function it is called whenever the buffer is full and the buffer starts over afterwards, so output of any size can be formatted through a small buffer. Without a flush function everything that doesn't fit is dropped and is_truncated is set.
+// Integers are written two digits at a time from a 200 byte table. The digit count comes from the bit width of the value and a single compare against a power of ten table, so there is no loop or branch per digit.
+// Floats are written as fixed point numbers with up to 9 fraction digits. The integer part and the scaled fraction are rounded into two u64s with the same round-half-to-even rule as printf. Values of 2^64 and above are written with an exponent (1.23e+25).
+// dani_FormatPrint supports the subset of printf that this library needs: the flags - and 0, a width, a precision (also as *), the length modifiers h, l, ll, and z, and the conversions d, i, u, x, X, f, c, s, and %. It uses the same fast integer and float formatting as the other functions.
+// dani_FormatSIUnit and dani_FormatByteCount scale a value to the largest fitting prefix (k, M, G, T or KiB, MiB, GiB, TiB) and print integers without fractions and everything else with two fraction digits.
+//
+// How to use:
+//
+// static void WriteToConsole(dani_format_buffer *buffer) {
+//     fwrite(buffer->data, 1, buffer->length, stdout);
+// }
+//
+// s8 data[4096];
+// dani_format_buffer buffer;
+// dani_InitialiseFormatBuffer(&buffer, data, sizeof(data), WriteToConsole);
+//
+// dani_FormatString(&buffer, "Read ");
+// dani_FormatByteCount(&buffer, (f64)byte_count);
+// dani_FormatPrint(&buffer, " in %0.3fms (%llu files)\n", milliseconds, file_count);
+// dani_FlushFormatBuffer(&buffer); // Writes everything at once
+//
+#ifndef __DANI_LIB_FORMAT_H
+#define __DANI_LIB_FORMAT_H
+
+#ifdef DANI_FORMAT_STATIC
+#define __DANI_FORMAT_DEC static
+#define __DANI_FORMAT_DEF static
+#else
+#define __DANI_FORMAT_DEC extern
+#define __DANI_FORMAT_DEF
+#endif
+
+#define DANI_FORMAT_FRACTION_DIGITS_MAX 9
+
+typedef struct __DANI_FORMAT_BUFFER dani_format_buffer;
+typedef void dani_format_flush(dani_format_buffer *buffer);
+
+struct __DANI_FORMAT_BUFFER {
+    s8 *data;
+    u64 capacity;
+    u64 length;
+    dani_format_flush *flush;
+    b32 is_truncated;
+};
+
+__DANI_FORMAT_DEC void dani_InitialiseFormatBuffer(dani_format_buffer *buffer, s8 *data, u64 capacity, dani_format_flush *flush);
+__DANI_FORMAT_DEC void dani_FlushFormatBuffer(dani_format_buffer *buffer);
+
+__DANI_FORMAT_DEC void dani_FormatBytes(dani_format_buffer *buffer, const void *data, u64 byte_count);
+__DANI_FORMAT_DEC void dani_FormatString(dani_format_buffer *buffer, const s8 *string);
+__DANI_FORMAT_DEC void dani_FormatChar(dani_format_buffer *buffer, s8 character);
+__DANI_FORMAT_DEC void dani_FormatU64(dani_format_buffer *buffer, u64 value);
+__DANI_FORMAT_DEC void dani_FormatS64(dani_format_buffer *buffer, s64 value);
+__DANI_FORMAT_DEC void dani_FormatF64(dani_format_buffer *buffer, f64 value, u32 fraction_digit_count);
+__DANI_FORMAT_DEC void dani_FormatSIUnit(dani_format_buffer *buffer, f64 value, const s8 *base_unit);
+__DANI_FORMAT_DEC void dani_FormatByteCount(dani_format_buffer *buffer, f64 byte_count);
+__DANI_FORMAT_DEC void dani_FormatPrint(dani_format_buffer *buffer, const s8 *format, ...);
+__DANI_FORMAT_DEC void dani_FormatPrintV(dani_format_buffer *buffer, const s8 *format, va_list arguments);
+
+#endif // __DANI_LIB_FORMAT_H
+
+#ifdef DANI_LIB_FORMAT_IMPLEMENTATION
+
+static const s8 g_dani_format_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const u64 g_dani_format_powers_of_ten[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+    10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+    1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+};
+
+static u32 CountFormatDigits(u64 value) {
+    // 1233 / 4096 is just above log10(2), so this is the digit count of the largest value with the same bit width. Values below the matching power of ten have one digit less.
+    value |= 1;
+    u32 bit_count = 64 - CountLeadingZeros64(value);
+    u32 estimate = (bit_count * 1233) >> 12;
+    u32 result = estimate + 1 - (value < g_dani_format_powers_of_ten[estimate]);
+    return (result);
+}
+
+// Writes the digits of value to out and returns the digit count. out needs room for 20 bytes.
+static u32 WriteFormatU64(s8 *out, u64 value) {
+    u32 digit_count = CountFormatDigits(value);
+
+    s8 *at = out + digit_count;
+    while (value >= 100) {
+        u64 pair_index = (value % 100) * 2;
+        value /= 100;
+        at -= 2;
+        at[0] = g_dani_format_digit_pairs[pair_index];
+        at[1] = g_dani_format_digit_pairs[pair_index + 1];
+    }
+
+    if (value >= 10) {
+        at -= 2;
+        at[0] = g_dani_format_digit_pairs[value * 2];
+        at[1] = g_dani_format_digit_pairs[value * 2 + 1];
+    } else {
+        at -= 1;
+        at[0] = (s8)('0' + value);
+    }
+
+    return (digit_count);
+}
+
+// Writes exactly digit_count digits, padded with leading zeros
+static void WriteFormatU64Padded(s8 *out, u64 value, u32 digit_count) {
+    s8 *at = out + digit_count;
+    while (at > out) {
+        at -= 1;
+        *at = (s8)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+static u32 WriteFormatHex64(s8 *out, u64 value, b32 is_upper_case) {
+    const s8 *digits = (is_upper_case) ? "0123456789ABCDEF" : "0123456789abcdef";
+    u32 digit_count = (value) ? (67 - CountLeadingZeros64(value)) / 4 : 1;
+
+    for (u32 digit_index = 0; digit_index < digit_count; digit_index += 1) {
+        out[digit_count - 1 - digit_index] = digits[value & 0xF];
+        value >>= 4;
+    }
+
+    return (digit_count);
+}
+
+// Returns a * b - product exactly (Dekker's algorithm). Both factors are split into 26 bit halves, so every partial product is exact.
+static f64 GetFormatProductError(f64 a, f64 b, f64 product) {
+    f64 split_a = a * 134217729.0;
+    f64 a_high = split_a - (split_a - a);
+    f64 a_low = a - a_high;
+
+    f64 split_b = b * 134217729.0;
+    f64 b_high = split_b - (split_b - b);
+    f64 b_low = b - b_high;
+
+    f64 result = ((a_high * b_high - product) + a_high * b_low + a_low * b_high) + a_low * b_low;
+    return (result);
+}
+
+// Writes value with fraction_digit_count fraction digits and returns the length. out needs room for 48 bytes.
+static u32 WriteFormatF64(s8 *out, f64 value, u32 fraction_digit_count) {
+    fraction_digit_count = Min(fraction_digit_count, DANI_FORMAT_FRACTION_DIGITS_MAX);
+    u32 length = 0;
+
+    if (value != value) {
+        memcpy(out, "nan", 3);
+        return (3);
+    }
+
+    if (value < 0.0) {
+        out[length++] = '-';
+        value = -value;
+    }
+
+    if (value > 1.7976931348623157e308) {
+        memcpy(out + length, "inf", 3);
+        return (length + 3);
+    }
+
+    u64 scale = g_dani_format_powers_of_ten[fraction_digit_count];
+
+    // Values from 2^64 on don't fit into a u64 and are written with an exponent
+    s32 exponent = 0;
+    b32 has_exponent = (value >= 18446744073709551616.0);
+    if (has_exponent) {
+        while (value >= 10.0) {
+            value /= 10.0;
+            exponent += 1;
+        }
+    }
+
+    // Splitting off the integer part is exact, so the fraction keeps all of its bits when it is scaled
+    u64 integer_part = (u64)value;
+    f64 scaled_fraction = (value - (f64)integer_part) * (f64)scale;
+    u64 fraction_part = (u64)scaled_fraction;
+    f64 remainder = scaled_fraction - (f64)fraction_part;
+
+    // A remainder of exactly 0.5 can also be the product rounding onto the halfway point, so the rounding error of the product decides. Real ties round to even like printf does.
+    b32 is_rounding_up = (remainder > 0.5);
+    if (remainder == 0.5) {
+        f64 error = GetFormatProductError(value - (f64)integer_part, (f64)scale, scaled_fraction);
+        u64 last_digits = (fraction_digit_count) ? fraction_part : integer_part;
+        is_rounding_up = (error > 0.0 || (error == 0.0 && (last_digits & 1)));
+    }
+    fraction_part += is_rounding_up;
+    if (fraction_part == scale) {
+        fraction_part = 0;
+        integer_part += 1;
+    }
+
+    if (has_exponent && integer_part >= 10) {
+        integer_part /= 10;
+        exponent += 1;
+    }
+
+    length += WriteFormatU64(out + length, integer_part);
+    if (fraction_digit_count) {
+        out[length++] = '.';
+        WriteFormatU64Padded(out + length, fraction_part, fraction_digit_count);
+        length += fraction_digit_count;
+    }
+
+    if (has_exponent) {
+        out[length++] = 'e';
+        out[length++] = '+';
+        if (exponent < 10) {
+            out[length++] = '0';
+        }
+        length += WriteFormatU64(out + length, (u64)exponent);
+    }
+
+    return (length);
+}
+
+__DANI_FORMAT_DEF void dani_InitialiseFormatBuffer(dani_format_buffer *buffer, s8 *data, u64 capacity, dani_format_flush *flush) {
+    Assert(data && capacity);
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+    buffer->length = 0;
+    buffer->flush = flush;
+    buffer->is_truncated = B32_FALSE;
+}
+
+__DANI_FORMAT_DEF void dani_FlushFormatBuffer(dani_format_buffer *buffer) {
+    if (buffer->flush && buffer->length) {
+        buffer->flush(buffer);
+        buffer->length = 0;
+    }
+}
+
+__DANI_FORMAT_DEF void dani_FormatBytes(dani_format_buffer *buffer, const void *data, u64 byte_count) {
+    const u8 *at = (const u8 *)data;
+
+    while (byte_count) {
+        u64 free_count = buffer->capacity - buffer->length;
+        if (free_count == 0) {
+            if (buffer->flush == 0) {
+                buffer->is_truncated = B32_TRUE;
+                break;
+            }
+
+            dani_FlushFormatBuffer(buffer);
+            free_count = buffer->capacity;
+        }
+
+        u64 copy_count = Min(free_count, byte_count);
+        memcpy(buffer->data + buffer->length, at, copy_count);
+        buffer->length += copy_count;
+        at += copy_count;
+        byte_count -= copy_count;
+    }
+}
+
+__DANI_FORMAT_DEF void dani_FormatString(dani_format_buffer *buffer, const s8 *string) {
+    dani_FormatBytes(buffer, string, strlen((const char *)string));
+}
+
+__DANI_FORMAT_DEF void dani_FormatChar(dani_format_buffer *buffer, s8 character) {
+    if (buffer->length < buffer->capacity) {
+        buffer->data[buffer->length++] = character;
+    } else {
+        dani_FormatBytes(buffer, &character, 1);
+    }
+}
+
+__DANI_FORMAT_DEF void dani_FormatU64(dani_format_buffer *buffer, u64 value) {
+    // Write straight into the buffer if there is room for the longest value
+    if (buffer->capacity - buffer->length >= 20) {
+        buffer->length += WriteFormatU64(buffer->data + buffer->length, value);
+    } else {
+        s8 digits[20];
+        dani_FormatBytes(buffer, digits, WriteFormatU64(digits, value));
+    }
+}
+
+__DANI_FORMAT_DEF void dani_FormatS64(dani_format_buffer *buffer, s64 value) {
+    u64 magnitude = (u64)value;
+    if (value < 0) {
+        dani_FormatChar(buffer, '-');
+        magnitude = 0 - magnitude;
+    }
+
+    dani_FormatU64(buffer, magnitude);
+}
+
+__DANI_FORMAT_DEF void dani_FormatF64(dani_format_buffer *buffer, f64 value, u32 fraction_digit_count) {
+    s8 text[48];
+    dani_FormatBytes(buffer, text, WriteFormatF64(text, value, fraction_digit_count));
+}
+
+__DANI_FORMAT_DEF void dani_FormatSIUnit(dani_format_buffer *buffer, f64 value, const s8 *base_unit) {
+    s8 prefix;
+
+    if (value >= Tera(1)) { prefix = 'T'; value /= Tera(1); }
+    else if (value >= Giga(1)) { prefix = 'G'; value /= Giga(1); }
+    else if (value >= Mega(1)) { prefix = 'M'; value /= Mega(1); }
+    else if (value >= Kilo(1)) { prefix = 'k'; value /= Kilo(1); }
+    else { prefix = '\0'; }
+
+    u64 int_value = (u64)value;
+    if ((f64)int_value == value) {
+        // No fractions
+        dani_FormatU64(buffer, int_value);
+    } else {
+        // Fractions
+        dani_FormatF64(buffer, value, 2);
+    }
+
+    if (prefix) {
+        dani_FormatChar(buffer, prefix);
+    }
+    dani_FormatString(buffer, base_unit);
+}
+
+__DANI_FORMAT_DEF void dani_FormatByteCount(dani_format_buffer *buffer, f64 byte_count) {
+    const s8 *prefix;
+
+    if (byte_count >= TiB(1)) { prefix = "TiB"; byte_count /= TiB(1); }
+    else if (byte_count >= GiB(1)) { prefix = "GiB"; byte_count /= GiB(1); }
+    else if (byte_count >= MiB(1)) { prefix = "MiB"; byte_count /= MiB(1); }
+    else if (byte_count >= KiB(1)) { prefix = "KiB"; byte_count /= KiB(1); }
+    else { prefix = "byte"; }
+
+    u64 int_value = (u64)byte_count;
+    if ((f64)int_value == byte_count) {
+        // No fractions
+        dani_FormatU64(buffer, int_value);
+    } else {
+        // Fractions
+        dani_FormatF64(buffer, byte_count, 2);
+    }
+
+    dani_FormatString(buffer, prefix);
+}
+
+static void FormatPadding(dani_format_buffer *buffer, s8 character, u64 count) {
+    s8 padding[32];
+    memset(padding, character, sizeof(padding));
+
+    while (count) {
+        u64 write_count = Min(count, sizeof(padding));
+        dani_FormatBytes(buffer, padding, write_count);
+        count -= write_count;
+    }
+}
+
+__DANI_FORMAT_DEF void dani_FormatPrintV(dani_format_buffer *buffer, const s8 *format, va_list arguments) {
+    const s8 *at = format;
+
+    while (*at) {
+        // Copy everything up to the next conversion at once
+        const s8 *literal = at;
+        while (*at && *at != '%') {
+            at += 1;
+        }
+        if (at != literal) {
+            dani_FormatBytes(buffer, literal, (u64)(at - literal));
+        }
+        if (*at == '\0') {
+            break;
+        }
+        at += 1;
+
+        b32 is_left_aligned = B32_FALSE;
+        b32 is_zero_padded = B32_FALSE;
+        for (;; at += 1) {
+            if (*at == '-') { is_left_aligned = B32_TRUE; }
+            else if (*at == '0') { is_zero_padded = B32_TRUE; }
+            else { break; }
+        }
+
+        u64 width = 0;
+        if (*at == '*') {
+            s32 argument_width = va_arg(arguments, int);
+            if (argument_width < 0) {
+                is_left_aligned = B32_TRUE;
+                argument_width = -argument_width;
+            }
+            width = (u64)argument_width;
+            at += 1;
+        } else {
+            while (*at >= '0' && *at <= '9') {
+                width = width * 10 + (u64)(*at - '0');
+                at += 1;
+            }
+        }
+
+        s32 precision = -1;
+        if (*at == '.') {
+            at += 1;
+            precision = 0;
+            if (*at == '*') {
+                precision = va_arg(arguments, int);
+                at += 1;
+            } else {
+                while (*at >= '0' && *at <= '9') {
+                    precision = precision * 10 + (*at - '0');
+                    at += 1;
+                }
+            }
+        }
+
+        // 1 = long, 2 = long long, 3 = size_t. h is accepted and ignored, because shorts are promoted to int anyway.
+        u32 length_modifier = 0;
+        for (;; at += 1) {
+            if (*at == 'l') { length_modifier += 1; }
+            else if (*at == 'z') { length_modifier = 3; }
+            else if (*at != 'h') { break; }
+        }
+
+        s8 field[64];
+        const s8 *field_data = field;
+        u64 field_length = 0;
+        b32 is_number = B32_TRUE;
+
+        s8 conversion = *at;
+        if (conversion) {
+            at += 1;
+        }
+
+        switch (conversion) {
+            case 'd':
+            case 'i': {
+                s64 value;
+                if (length_modifier == 0) { value = va_arg(arguments, int); }
+                else if (length_modifier == 1) { value = va_arg(arguments, long); }
+                else if (length_modifier == 2) { value = va_arg(arguments, long long); }
+                else { value = (s64)va_arg(arguments, size_t); }
+
+                u64 magnitude = (u64)value;
+                if (value < 0) {
+                    field[field_length++] = '-';
+                    magnitude = 0 - magnitude;
+                }
+                field_length += WriteFormatU64(field + field_length, magnitude);
+            } break;
+
+            case 'u':
+            case 'x':
+            case 'X': {
+                u64 value;
+                if (length_modifier == 0) { value = va_arg(arguments, unsigned int); }
+                else if (length_modifier == 1) { value = va_arg(arguments, unsigned long); }
+                else if (length_modifier == 2) { value = va_arg(arguments, unsigned long long); }
+                else { value = va_arg(arguments, size_t); }
+
+                if (conversion == 'u') {
+                    field_length = WriteFormatU64(field, value);
+                } else {
+                    field_length = WriteFormatHex64(field, value, conversion == 'X');
+                }
+            } break;
+
+            case 'f': {
+                f64 value = va_arg(arguments, double);
+                field_length = WriteFormatF64(field, value, (precision < 0) ? 6 : (u32)precision);
+            } break;
+
+            case 'c': {
+                field[0] = (s8)va_arg(arguments, int);
+                field_length = 1;
+                is_number = B32_FALSE;
+            } break;
+
+            case 's': {
+                field_data = va_arg(arguments, const s8 *);
+                if (field_data == 0) {
+                    field_data = "(null)";
+                }
+
+                // With a precision the string doesn't have to be zero terminated
+                if (precision >= 0) {
+                    while (field_length < (u64)precision && field_data[field_length]) {
+                        field_length += 1;
+                    }
+                } else {
+                    field_length = strlen((const char *)field_data);
+                }
+                is_number = B32_FALSE;
+            } break;
+
+            default: {
+                // %% and unknown conversions are written as they are
+                field[0] = (conversion) ? conversion : '%';
+                field_length = 1;
+                is_number = B32_FALSE;
+            } break;
+        }
+
+        u64 padding_count = (width > field_length) ? width - field_length : 0;
+        if (padding_count == 0) {
+            dani_FormatBytes(buffer, field_data, field_length);
+        } else if (is_left_aligned) {
+            dani_FormatBytes(buffer, field_data, field_length);
+            FormatPadding(buffer, ' ', padding_count);
+        } else if (is_zero_padded && is_number) {
+            // The zeros go between the sign and the digits
+            if (field_data[0] == '-') {
+                dani_FormatChar(buffer, '-');
+                field_data += 1;
+                field_length -= 1;
+            }
+            FormatPadding(buffer, '0', padding_count);
+            dani_FormatBytes(buffer, field_data, field_length);
+        } else {
+            FormatPadding(buffer, ' ', padding_count);
+            dani_FormatBytes(buffer, field_data, field_length);
+        }
+    }
+}
+
+__DANI_FORMAT_DEF void dani_FormatPrint(dani_format_buffer *buffer, const s8 *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    dani_FormatPrintV(buffer, format, arguments);
+    va_end(arguments);
+}
+
+#endif // DANI_LIB_FORMAT_IMPLEMENTATION
+
+/*
+Danilib - dani_format.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
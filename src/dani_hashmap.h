@@ -0,0 +1,467 @@
+// Danilib - dani_hashmap.h
+// Types and functions for an open addressing hash map from 64 bit keys to 64 bit values.
+//
+// Author: Dani Drywa (dani@drywa.me)
+// The table layout is based on the "Swiss Tables" design of the Abseil flat_hash_map as presented by Matt Kulukundis at CppCon 2017.
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types, ByteSplat64, bit scans, and PrefetchCacheLine
+// dani_arena.h - for dani_PushArenaAlignedNoZero
+// string.h - for memset and memcpy
+// emmintrin.h - for the SSE2 intrinsics unless DANI_HASHMAP_SWAR is specified. On MSVC intrin.h is enough, which is included by dani_base.h.
+//
+// Notes:
+// This library is *NOT* thread safe.
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_HASHMAP_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_HASHMAP_STATIC before including this file.
+// All keys and values live in one flat array of slots. Next to it is an array of one control byte per slot, which is either empty, deleted, or holds 7 bits of the hash of the key in the slot. A lookup compares the control bytes of a whole group of slots against the hash at once and only compares the keys of the slots whose control byte matches, so most lookups touch one group of control bytes and one slot.
+// On x64 a group is 16 control bytes that are compared with SSE2 and movemask. Everywhere else, or if DANI_HASHMAP_SWAR is specified before including this file, a group is 8 control bytes in a u64 that are compared with ByteSplat64 and the "has zero byte" bit trick.
+// The map never holds more than 7/8 of its capacity. Once it is full, a new table of twice the size is pushed onto the arena and all slots are moved over. The old table is left behind in the arena, so a map that grows a lot wastes up to the size of its final table. If at least half of the used slots are tombstones instead, the table is rehashed in place and the arena doesn't grow. Pass the expected count to dani_InitialiseHashMap to avoid growing, or give the map its own arena.
+// Removing a key only leaves a tombstone behind if a lookup could have passed over its slot while the group was full. In most maps the slot simply becomes empty again.
+// dani_FindHashMapBatch looks up many keys at once. It prefetches the control bytes and slots of DANI_HASHMAP_BATCH_SIZE (default 16) keys before it looks at any of them, so their cache misses overlap instead of being paid one after another.
+// Keys are hashed with dani_HashMapKey, which is the final mix of MurmurHash3. To use a different hash specify DANI_HASHMAP_HASH(key) before including this file. All 64 bits of the hash are used, so it should be well mixed.
+// Inserting and removing invalidates all pointers to values and the iteration order.
+//
+// How to use:
+//
+// dani_hashmap map;
+// if (dani_InitialiseHashMap(&map, &arena, 1024)) {
+//     *dani_InsertHashMap(&map, key) = value; // New values start at 0, so counting is just *dani_InsertHashMap(&map, key) += 1
+//
+//     u64 *found_value = dani_FindHashMap(&map, key);
+//     if (found_value) {
+//         // Use *found_value
+//     }
+//
+//     dani_RemoveHashMap(&map, key);
+//
+//     u64 iterator = 0;
+//     dani_hashmap_slot *slot;
+//     while ((slot = dani_NextHashMapSlot(&map, &iterator)) != 0) {
+//         // Use slot->key and slot->value
+//     }
+// }
+//
+#ifndef __DANI_LIB_HASHMAP_H
+#define __DANI_LIB_HASHMAP_H
+
+#ifdef DANI_HASHMAP_STATIC
+#define __DANI_HASHMAP_DEC static
+#define __DANI_HASHMAP_DEF static
+#else
+#define __DANI_HASHMAP_DEC extern
+#define __DANI_HASHMAP_DEF
+#endif
+
+#ifndef DANI_HASHMAP_BATCH_SIZE
+#define DANI_HASHMAP_BATCH_SIZE 16
+#endif
+
+#ifndef DANI_HASHMAP_HASH
+#define DANI_HASHMAP_HASH(key) dani_HashMapKey(key)
+#endif
+
+typedef struct __DANI_HASHMAP_SLOT dani_hashmap_slot;
+struct __DANI_HASHMAP_SLOT {
+    u64 key;
+    u64 value;
+};
+
+typedef struct __DANI_HASHMAP dani_hashmap;
+struct __DANI_HASHMAP {
+    u8 *control;
+    dani_hashmap_slot *slots;
+    u64 capacity;
+    u64 count;
+    u64 growth_left; // Empty slots that can still be used before the map has to grow
+    dani_arena *arena;
+};
+
+static __inline u64 dani_HashMapKey(u64 key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return (key);
+}
+
+__DANI_HASHMAP_DEC b32 dani_InitialiseHashMap(dani_hashmap *map, dani_arena *arena, u64 expected_count);
+__DANI_HASHMAP_DEC void dani_ClearHashMap(dani_hashmap *map);
+
+__DANI_HASHMAP_DEC u64 *dani_FindHashMap(dani_hashmap *map, u64 key);
+__DANI_HASHMAP_DEC u32 dani_FindHashMapBatch(dani_hashmap *map, const u64 *keys, u64 **values, u32 count);
+__DANI_HASHMAP_DEC u64 *dani_InsertHashMap(dani_hashmap *map, u64 key);
+__DANI_HASHMAP_DEC b32 dani_RemoveHashMap(dani_hashmap *map, u64 key);
+
+__DANI_HASHMAP_DEC dani_hashmap_slot *dani_NextHashMapSlot(dani_hashmap *map, u64 *iterator);
+
+#endif // __DANI_LIB_HASHMAP_H
+
+#ifdef DANI_LIB_HASHMAP_IMPLEMENTATION
+
+// Full control bytes hold the lower 7 bits of the hash, so the top bit marks empty and deleted slots
+#define DANI_HASHMAP_CONTROL_EMPTY 0x80
+#define DANI_HASHMAP_CONTROL_DELETED 0xFE
+#define DANI_HASHMAP_CAPACITY_MIN 16
+
+#if !defined(DANI_HASHMAP_SWAR) && (defined(_M_X64) || defined(__SSE2__))
+
+#define DANI_HASHMAP_GROUP_WIDTH 16
+typedef u32 dani_hashmap_mask;
+
+static dani_hashmap_mask MatchHashMapGroup(const u8 *control, u8 hash_bits) {
+    __m128i group = _mm_loadu_si128((const __m128i *)control);
+    dani_hashmap_mask result = (dani_hashmap_mask)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)hash_bits)));
+    return (result);
+}
+
+static dani_hashmap_mask MatchHashMapGroupEmpty(const u8 *control) {
+    __m128i group = _mm_loadu_si128((const __m128i *)control);
+    dani_hashmap_mask result = (dani_hashmap_mask)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)DANI_HASHMAP_CONTROL_EMPTY)));
+    return (result);
+}
+
+static dani_hashmap_mask MatchHashMapGroupEmptyOrDeleted(const u8 *control) {
+    // Empty and deleted are the only control bytes that are negative and less than -1
+    __m128i group = _mm_loadu_si128((const __m128i *)control);
+    dani_hashmap_mask result = (dani_hashmap_mask)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), group));
+    return (result);
+}
+
+#define GetHashMapMaskFirstIndex(mask) CountTrailingZeros32(mask)
+#define GetHashMapMaskLastGap(mask) (CountLeadingZeros32(mask) - 16)
+
+#else
+
+#define DANI_HASHMAP_GROUP_WIDTH 8
+typedef u64 dani_hashmap_mask;
+
+// Every match sets the top bit of its byte in the mask
+static u64 LoadHashMapGroup(const u8 *control) {
+    u64 result;
+    memcpy(&result, control, sizeof(result));
+    return (result);
+}
+
+static dani_hashmap_mask MatchHashMapGroup(const u8 *control, u8 hash_bits) {
+    // Bytes that are equal to the hash bits become zero, which is found with the "has zero byte" trick.
+    // A byte above a match can show up as a false positive because of the borrow, which is fine because the keys are compared anyway.
+    u64 group = LoadHashMapGroup(control) ^ ByteSplat64((u64)hash_bits);
+    dani_hashmap_mask result = (group - ByteSplat64(0x01ull)) & ~group & ByteSplat64(0x80ull);
+    return (result);
+}
+
+static dani_hashmap_mask MatchHashMapGroupEmpty(const u8 *control) {
+    // Empty is the only control byte with the top bit set and bit 1 cleared
+    u64 group = LoadHashMapGroup(control);
+    dani_hashmap_mask result = group & ~(group << 6) & ByteSplat64(0x80ull);
+    return (result);
+}
+
+static dani_hashmap_mask MatchHashMapGroupEmptyOrDeleted(const u8 *control) {
+    // Empty and deleted are the only control bytes with the top bit set and bit 0 cleared
+    u64 group = LoadHashMapGroup(control);
+    dani_hashmap_mask result = group & ~(group << 7) & ByteSplat64(0x80ull);
+    return (result);
+}
+
+#define GetHashMapMaskFirstIndex(mask) (CountTrailingZeros64(mask) >> 3)
+#define GetHashMapMaskLastGap(mask) (CountLeadingZeros64(mask) >> 3)
+
+#endif
+
+static void SetHashMapControl(dani_hashmap *map, u64 index, u8 control) {
+    // The first group of control bytes is mirrored after the last slot, so a group can be loaded at any index without wrapping around
+    map->control[index] = control;
+    map->control[((index - DANI_HASHMAP_GROUP_WIDTH) & (map->capacity - 1)) + DANI_HASHMAP_GROUP_WIDTH] = control;
+}
+
+static b32 AllocateHashMapTable(dani_hashmap *map, u64 capacity) {
+    u64 control_size = AlignPower2(capacity + DANI_HASHMAP_GROUP_WIDTH, 16);
+    u8 *memory = (u8 *)dani_PushArenaAlignedNoZero(map->arena, control_size + capacity * sizeof(dani_hashmap_slot), 16);
+    if (memory == 0) {
+        return (B32_FAILURE);
+    }
+
+    // Slots are only ever read if their control byte is full, so they don't have to be cleared
+    memset(memory, DANI_HASHMAP_CONTROL_EMPTY, capacity + DANI_HASHMAP_GROUP_WIDTH);
+
+    map->control = memory;
+    map->slots = (dani_hashmap_slot *)(memory + control_size);
+    map->capacity = capacity;
+    map->growth_left = capacity - (capacity / 8) - map->count;
+
+    return (B32_SUCCESS);
+}
+
+static u64 FindHashMapInsertIndex(dani_hashmap *map, u64 hash) {
+    u64 capacity_mask = map->capacity - 1;
+    u64 position = (hash >> 7) & capacity_mask;
+    u64 stride = 0;
+
+    // There is always at least one empty slot, so this terminates
+    for (;;) {
+        dani_hashmap_mask mask = MatchHashMapGroupEmptyOrDeleted(map->control + position);
+        if (mask) {
+            u64 result = (position + GetHashMapMaskFirstIndex(mask)) & capacity_mask;
+            return (result);
+        }
+
+        stride += DANI_HASHMAP_GROUP_WIDTH;
+        position = (position + stride) & capacity_mask;
+    }
+}
+
+static dani_hashmap_slot *FindHashMapSlot(dani_hashmap *map, u64 key, u64 hash) {
+    u64 capacity_mask = map->capacity - 1;
+    u64 position = (hash >> 7) & capacity_mask;
+    u64 stride = 0;
+    u8 hash_bits = (u8)(hash & 0x7F);
+
+    // Triangular probing visits every group exactly once, because the capacity is a power of 2
+    for (;;) {
+        const u8 *group = map->control + position;
+
+        dani_hashmap_mask mask = MatchHashMapGroup(group, hash_bits);
+        while (mask) {
+            u64 index = (position + GetHashMapMaskFirstIndex(mask)) & capacity_mask;
+            if (map->slots[index].key == key) {
+                return (&map->slots[index]);
+            }
+
+            mask &= mask - 1;
+        }
+
+        // The key would have been put into the first empty slot of its probe sequence
+        if (MatchHashMapGroupEmpty(group)) {
+            return (0);
+        }
+
+        stride += DANI_HASHMAP_GROUP_WIDTH;
+        position = (position + stride) & capacity_mask;
+    }
+}
+
+static b32 ResizeHashMap(dani_hashmap *map, u64 capacity) {
+    u8 *old_control = map->control;
+    dani_hashmap_slot *old_slots = map->slots;
+    u64 old_capacity = map->capacity;
+
+    if (IsFailure(AllocateHashMapTable(map, capacity))) {
+        return (B32_FAILURE);
+    }
+
+    for (u64 old_index = 0; old_index < old_capacity; old_index += 1) {
+        if ((old_control[old_index] & 0x80) == 0) {
+            dani_hashmap_slot *old_slot = &old_slots[old_index];
+            u64 hash = DANI_HASHMAP_HASH(old_slot->key);
+            u64 index = FindHashMapInsertIndex(map, hash);
+
+            SetHashMapControl(map, index, (u8)(hash & 0x7F));
+            map->slots[index] = *old_slot;
+        }
+    }
+
+    return (B32_SUCCESS);
+}
+
+static void RehashHashMapInPlace(dani_hashmap *map) {
+    // Tombstones become empty and full slots are marked as deleted, which here means the slot isn't placed yet
+    for (u64 index = 0; index < map->capacity; index += 1) {
+        map->control[index] = ((map->control[index] & 0x80) == 0) ? DANI_HASHMAP_CONTROL_DELETED : DANI_HASHMAP_CONTROL_EMPTY;
+    }
+    memcpy(map->control + map->capacity, map->control, DANI_HASHMAP_GROUP_WIDTH);
+
+    u64 capacity_mask = map->capacity - 1;
+    for (u64 index = 0; index < map->capacity; index += 1) {
+        while (map->control[index] == DANI_HASHMAP_CONTROL_DELETED) {
+            dani_hashmap_slot *slot = &map->slots[index];
+            u64 hash = DANI_HASHMAP_HASH(slot->key);
+            u64 new_index = FindHashMapInsertIndex(map, hash);
+            u64 position = (hash >> 7) & capacity_mask;
+
+            // A slot that is already in the group its probe sequence would put it into stays where it is
+            if (((new_index - position) & capacity_mask) / DANI_HASHMAP_GROUP_WIDTH == ((index - position) & capacity_mask) / DANI_HASHMAP_GROUP_WIDTH) {
+                SetHashMapControl(map, index, (u8)(hash & 0x7F));
+                break;
+            }
+
+            if (map->control[new_index] == DANI_HASHMAP_CONTROL_EMPTY) {
+                map->slots[new_index] = *slot;
+                SetHashMapControl(map, new_index, (u8)(hash & 0x7F));
+                SetHashMapControl(map, index, DANI_HASHMAP_CONTROL_EMPTY);
+            } else {
+                // The slot there isn't placed yet, so the two swap and the one that ends up here is placed next
+                dani_hashmap_slot swapped_slot = map->slots[new_index];
+                map->slots[new_index] = *slot;
+                *slot = swapped_slot;
+                SetHashMapControl(map, new_index, (u8)(hash & 0x7F));
+            }
+        }
+    }
+
+    map->growth_left = map->capacity - (map->capacity / 8) - map->count;
+}
+
+__DANI_HASHMAP_DEF b32 dani_InitialiseHashMap(dani_hashmap *map, dani_arena *arena, u64 expected_count) {
+    memset(map, 0, sizeof(*map));
+    map->arena = arena;
+
+    u64 capacity = DANI_HASHMAP_CAPACITY_MIN;
+    while (capacity - (capacity / 8) < expected_count) {
+        capacity *= 2;
+    }
+
+    b32 result = AllocateHashMapTable(map, capacity);
+    return (result);
+}
+
+__DANI_HASHMAP_DEF void dani_ClearHashMap(dani_hashmap *map) {
+    memset(map->control, DANI_HASHMAP_CONTROL_EMPTY, map->capacity + DANI_HASHMAP_GROUP_WIDTH);
+    map->count = 0;
+    map->growth_left = map->capacity - (map->capacity / 8);
+}
+
+__DANI_HASHMAP_DEF u64 *dani_FindHashMap(dani_hashmap *map, u64 key) {
+    dani_hashmap_slot *slot = FindHashMapSlot(map, key, DANI_HASHMAP_HASH(key));
+
+    u64 *result = (slot) ? &slot->value : 0;
+    return (result);
+}
+
+__DANI_HASHMAP_DEF u32 dani_FindHashMapBatch(dani_hashmap *map, const u64 *keys, u64 **values, u32 count) {
+    u64 hashes[DANI_HASHMAP_BATCH_SIZE];
+    u64 capacity_mask = map->capacity - 1;
+    u32 result = 0;
+
+    for (u32 first_index = 0; first_index < count; first_index += DANI_HASHMAP_BATCH_SIZE) {
+        u32 batch_count = Min(count - first_index, DANI_HASHMAP_BATCH_SIZE);
+
+        // Start loading the first group and slot of every key before looking at any of them
+        for (u32 batch_index = 0; batch_index < batch_count; batch_index += 1) {
+            u64 hash = DANI_HASHMAP_HASH(keys[first_index + batch_index]);
+            u64 position = (hash >> 7) & capacity_mask;
+
+            PrefetchCacheLine(map->control + position);
+            PrefetchCacheLine(map->slots + position);
+            hashes[batch_index] = hash;
+        }
+
+        for (u32 batch_index = 0; batch_index < batch_count; batch_index += 1) {
+            dani_hashmap_slot *slot = FindHashMapSlot(map, keys[first_index + batch_index], hashes[batch_index]);
+            if (slot) {
+                values[first_index + batch_index] = &slot->value;
+                result += 1;
+            } else {
+                values[first_index + batch_index] = 0;
+            }
+        }
+    }
+
+    return (result);
+}
+
+__DANI_HASHMAP_DEF u64 *dani_InsertHashMap(dani_hashmap *map, u64 key) {
+    u64 hash = DANI_HASHMAP_HASH(key);
+
+    dani_hashmap_slot *slot = FindHashMapSlot(map, key, hash);
+    if (slot) {
+        return (&slot->value);
+    }
+
+    u64 index = FindHashMapInsertIndex(map, hash);
+    if (map->growth_left == 0 && map->control[index] == DANI_HASHMAP_CONTROL_EMPTY) {
+        // If at least half of the used slots are tombstones, getting rid of them makes enough room without growing
+        u64 count_max = map->capacity - (map->capacity / 8);
+        if (map->count * 2 <= count_max) {
+            RehashHashMapInPlace(map);
+        } else if (IsFailure(ResizeHashMap(map, map->capacity * 2))) {
+            return (0);
+        }
+
+        index = FindHashMapInsertIndex(map, hash);
+    }
+
+    if (map->control[index] == DANI_HASHMAP_CONTROL_EMPTY) {
+        map->growth_left -= 1;
+    }
+    map->count += 1;
+
+    SetHashMapControl(map, index, (u8)(hash & 0x7F));
+    slot = &map->slots[index];
+    slot->key = key;
+    slot->value = 0;
+
+    return (&slot->value);
+}
+
+__DANI_HASHMAP_DEF b32 dani_RemoveHashMap(dani_hashmap *map, u64 key) {
+    dani_hashmap_slot *slot = FindHashMapSlot(map, key, DANI_HASHMAP_HASH(key));
+    if (slot == 0) {
+        return (B32_FALSE);
+    }
+
+    u64 index = (u64)(slot - map->slots);
+    u64 index_before = (index - DANI_HASHMAP_GROUP_WIDTH) & (map->capacity - 1);
+
+    // If the empty slots around this one are less than a group apart, no group that contains this slot was ever full.
+    // No lookup could have probed past it, so it can become empty again instead of a tombstone.
+    dani_hashmap_mask empty_after = MatchHashMapGroupEmpty(map->control + index);
+    dani_hashmap_mask empty_before = MatchHashMapGroupEmpty(map->control + index_before);
+    b32 was_never_full = (empty_before && empty_after && (GetHashMapMaskFirstIndex(empty_after) + GetHashMapMaskLastGap(empty_before)) < DANI_HASHMAP_GROUP_WIDTH);
+
+    if (was_never_full) {
+        SetHashMapControl(map, index, DANI_HASHMAP_CONTROL_EMPTY);
+        map->growth_left += 1;
+    } else {
+        SetHashMapControl(map, index, DANI_HASHMAP_CONTROL_DELETED);
+    }
+    map->count -= 1;
+
+    return (B32_TRUE);
+}
+
+__DANI_HASHMAP_DEF dani_hashmap_slot *dani_NextHashMapSlot(dani_hashmap *map, u64 *iterator) {
+    for (u64 index = *iterator; index < map->capacity; index += 1) {
+        if ((map->control[index] & 0x80) == 0) {
+            *iterator = index + 1;
+            return (&map->slots[index]);
+        }
+    }
+
+    *iterator = map->capacity;
+    return (0);
+}
+
+#endif // DANI_LIB_HASHMAP_IMPLEMENTATION
+
+/*
+Danilib - dani_hashmap.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
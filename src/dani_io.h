@@ -0,0 +1,612 @@
+// Danilib - dani_io.h
+// Types and functions for asynchronous sequential file reads with a fixed depth read ahead pipeline on top of an I/O ring or a thread pool.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types and atomics
+// dani_sync.h - for the semaphores of the thread pool
+// Windows.h - for CreateFileA, ReadFile, GetOverlappedResult, CreateEventA, CreateThread, GetModuleHandleA, GetProcAddress, and VirtualAlloc
+// ioringapi.h - for the I/O ring types. Requires the Windows 11 SDK (10.0.22000) or newer and NTDDI_VERSION of at least NTDDI_WIN10_CO. Not needed if DANI_IO_NO_IORING is specified.
+// string.h - for memset
+// dani_profiler.h - for the wait zone if DANI_IO_PROFILE is enabled.
+//
+// Notes:
+// A reader is *NOT* thread safe. Every thread should use its own reader, the worker threads of the thread pool backend are internal.
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_IO_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_IO_STATIC before including this file.
+// A reader owns depth buffers of block_size bytes each (0 uses DANI_IO_DEFAULT_DEPTH, default 16, and DANI_IO_DEFAULT_BLOCK_SIZE, default 256KiB). The depth can't be larger than DANI_IO_MAX_DEPTH (default 64).
+// Opening a file starts reads for the first depth blocks right away. Every block that is handed out by dani_NextIoBlock stays valid until the next call, which reuses its buffer for the next block that isn't read yet. That keeps depth - 1 reads in flight while the consumer works, so the disk always has a deep queue even though the blocks come out one by one and in file order.
+// New reads are collected and only handed to the backend in batches of DANI_IO_SUBMIT_BATCH (default 4), or as soon as the consumer has to wait for a block. Completions are always collected all at once.
+// DANI_IO_BACKEND_IORING uses the I/O rings of Windows 11, the Windows counterpart of io_uring. The buffers are registered with the ring once when the reader is initialised and every file is registered when it is opened, so the kernel doesn't have to look up the handle or lock down the pages of the buffers for every read.
+// DANI_IO_BACKEND_THREADS hands the reads to DANI_IO_THREAD_COUNT (default 4) worker threads that each run one positioned ReadFile at a time, the Windows counterpart of a pread thread pool. Reads that are served from the file cache are copied by the thread that reads them, so the workers also spread the copies over several cores.
+// DANI_IO_BACKEND_AUTO uses an I/O ring if the system supports it and the thread pool otherwise. The backend member holds the backend that was picked. The I/O ring functions are looked up at runtime, so the same executable still runs on systems without them.
+// Files are opened with FILE_FLAG_OVERLAPPED for both backends. Synchronous handles serialise all reads of a handle, which would leave the worker threads waiting on each other.
+// To report the time the consumer waits for blocks to the profiler set DANI_IO_PROFILE to 1. Every wait is timed as a "dani_IoWait" bandwidth zone with the size of the block, blocks that are already there when the consumer asks for them are not timed.
+//
+// How to use:
+//
+// dani_io_reader reader;
+// if (dani_InitialiseIoReader(&reader, DANI_IO_BACKEND_AUTO, 0, 0)) {
+//     if (dani_OpenIoFile(&reader, "input.log")) {
+//         dani_io_block block;
+//         while (dani_NextIoBlock(&reader, &block)) {
+//             // Process block.size bytes at block.data, which are at block.offset in the file
+//         }
+//
+//         if (reader.is_failed) {
+//             // A read failed before the end of the file was reached
+//         }
+//
+//         dani_CloseIoFile(&reader);
+//     }
+//
+//     dani_ReleaseIoReader(&reader);
+// }
+//
+#ifndef __DANI_LIB_IO_H
+#define __DANI_LIB_IO_H
+
+#ifdef DANI_IO_STATIC
+#define __DANI_IO_DEC static
+#define __DANI_IO_DEF static
+#else
+#define __DANI_IO_DEC extern
+#define __DANI_IO_DEF
+#endif
+
+#ifndef DANI_IO_DEFAULT_DEPTH
+#define DANI_IO_DEFAULT_DEPTH 16
+#endif
+
+#ifndef DANI_IO_MAX_DEPTH
+#define DANI_IO_MAX_DEPTH 64
+#endif
+
+#ifndef DANI_IO_DEFAULT_BLOCK_SIZE
+#define DANI_IO_DEFAULT_BLOCK_SIZE KiB(256)
+#endif
+
+#ifndef DANI_IO_SUBMIT_BATCH
+#define DANI_IO_SUBMIT_BATCH 4
+#endif
+
+#ifndef DANI_IO_THREAD_COUNT
+#define DANI_IO_THREAD_COUNT 4
+#endif
+
+#ifndef DANI_IO_PROFILE
+#define DANI_IO_PROFILE 0
+#endif
+
+#define DANI_IO_BACKEND_AUTO 0
+#define DANI_IO_BACKEND_IORING 1
+#define DANI_IO_BACKEND_THREADS 2
+
+#define DANI_IO_SLOT_FREE 0
+#define DANI_IO_SLOT_PENDING 1
+#define DANI_IO_SLOT_DONE 2
+
+typedef struct __DANI_IO_BLOCK dani_io_block;
+struct __DANI_IO_BLOCK {
+    u8 *data;
+    u64 size;
+    u64 offset;
+};
+
+typedef struct __DANI_IO_SLOT dani_io_slot;
+struct __DANI_IO_SLOT {
+    u64 offset;
+    u32 size;
+    u32 read_size;
+    b32 is_failed;
+    volatile s32 state;
+};
+
+typedef struct __DANI_IO_READER dani_io_reader;
+
+typedef struct __DANI_IO_THREAD dani_io_thread;
+struct __DANI_IO_THREAD {
+    dani_io_reader *reader;
+    HANDLE thread;
+    HANDLE event;
+};
+
+struct __DANI_IO_READER {
+    u32 backend;
+    u32 depth;
+    u64 block_size;
+    u8 *buffers;
+    dani_io_slot slots[DANI_IO_MAX_DEPTH];
+
+    HANDLE file;
+    u64 file_size;
+    u64 issued_count; // Blocks of the file that were issued to the backend
+    u64 consumed_count; // Blocks of the file that were handed out
+    u32 unsubmitted_count;
+    b32 is_holding_block;
+    b32 is_failed;
+
+    // DANI_IO_BACKEND_IORING
+    void *ring;
+
+    // DANI_IO_BACKEND_THREADS
+    dani_io_thread threads[DANI_IO_THREAD_COUNT];
+    volatile s32 is_running;
+    volatile s64 taken_count;
+    dani_sync_semaphore requests;
+    dani_sync_semaphore completions;
+};
+
+__DANI_IO_DEC b32 dani_InitialiseIoReader(dani_io_reader *reader, u32 backend, u32 depth, u64 block_size);
+__DANI_IO_DEC void dani_ReleaseIoReader(dani_io_reader *reader);
+
+__DANI_IO_DEC b32 dani_OpenIoFile(dani_io_reader *reader, const s8 *file_name);
+__DANI_IO_DEC void dani_CloseIoFile(dani_io_reader *reader);
+
+__DANI_IO_DEC b32 dani_NextIoBlock(dani_io_reader *reader, dani_io_block *block);
+
+#endif // __DANI_LIB_IO_H
+
+#ifdef DANI_LIB_IO_IMPLEMENTATION
+
+#ifndef DANI_IO_NO_IORING
+
+// Registrations are the only operations that aren't reads, they always use this as their user data
+#define DANI_IO_REGISTER_USER_DATA ((UINT_PTR)U32_MAX)
+
+typedef HRESULT WINAPI dani_io_create_ring_function(IORING_VERSION version, IORING_CREATE_FLAGS flags, UINT32 submission_queue_size, UINT32 completion_queue_size, HIORING *ring);
+typedef HRESULT WINAPI dani_io_close_ring_function(HIORING ring);
+typedef HRESULT WINAPI dani_io_submit_ring_function(HIORING ring, UINT32 wait_operation_count, UINT32 milliseconds, UINT32 *submitted_count);
+typedef HRESULT WINAPI dani_io_pop_completion_function(HIORING ring, IORING_CQE *completion);
+typedef HRESULT WINAPI dani_io_build_read_function(HIORING ring, IORING_HANDLE_REF file, IORING_BUFFER_REF buffer, UINT32 size, UINT64 offset, UINT_PTR user_data, IORING_SQE_FLAGS flags);
+typedef HRESULT WINAPI dani_io_build_register_buffers_function(HIORING ring, UINT32 count, IORING_BUFFER_INFO const buffers[], UINT_PTR user_data);
+typedef HRESULT WINAPI dani_io_build_register_files_function(HIORING ring, UINT32 count, HANDLE const handles[], UINT_PTR user_data);
+
+static dani_io_create_ring_function *g_dani_io_create_ring = 0;
+static dani_io_close_ring_function *g_dani_io_close_ring = 0;
+static dani_io_submit_ring_function *g_dani_io_submit_ring = 0;
+static dani_io_pop_completion_function *g_dani_io_pop_completion = 0;
+static dani_io_build_read_function *g_dani_io_build_read = 0;
+static dani_io_build_register_buffers_function *g_dani_io_build_register_buffers = 0;
+static dani_io_build_register_files_function *g_dani_io_build_register_files = 0;
+
+static b32 LoadIoRingFunctions(void) {
+    // Linking against them would keep the executable from starting on systems that don't have them
+    HMODULE kernel_base = GetModuleHandleA("KernelBase.dll");
+    if (kernel_base == 0) {
+        return (B32_FAILURE);
+    }
+
+    g_dani_io_create_ring = (dani_io_create_ring_function *)GetProcAddress(kernel_base, "CreateIoRing");
+    g_dani_io_close_ring = (dani_io_close_ring_function *)GetProcAddress(kernel_base, "CloseIoRing");
+    g_dani_io_submit_ring = (dani_io_submit_ring_function *)GetProcAddress(kernel_base, "SubmitIoRing");
+    g_dani_io_pop_completion = (dani_io_pop_completion_function *)GetProcAddress(kernel_base, "PopIoRingCompletion");
+    g_dani_io_build_read = (dani_io_build_read_function *)GetProcAddress(kernel_base, "BuildIoRingReadFile");
+    g_dani_io_build_register_buffers = (dani_io_build_register_buffers_function *)GetProcAddress(kernel_base, "BuildIoRingRegisterBuffers");
+    g_dani_io_build_register_files = (dani_io_build_register_files_function *)GetProcAddress(kernel_base, "BuildIoRingRegisterFileHandles");
+
+    b32 result = (g_dani_io_create_ring && g_dani_io_close_ring && g_dani_io_submit_ring && g_dani_io_pop_completion && g_dani_io_build_read && g_dani_io_build_register_buffers && g_dani_io_build_register_files);
+    return (result);
+}
+
+static void CompleteIoRingReads(dani_io_reader *reader) {
+    IORING_CQE completion;
+    while (g_dani_io_pop_completion((HIORING)reader->ring, &completion) == S_OK) {
+        if (completion.UserData < reader->depth) {
+            dani_io_slot *slot = &reader->slots[completion.UserData];
+            slot->is_failed = FAILED(completion.ResultCode);
+            slot->read_size = (u32)completion.Information;
+            slot->state = DANI_IO_SLOT_DONE;
+        }
+    }
+}
+
+static b32 WaitForIoRingRegistration(dani_io_reader *reader) {
+    // Registrations only happen while no reads are in flight, so the next completion belongs to it
+    IORING_CQE completion;
+    if (FAILED(g_dani_io_submit_ring((HIORING)reader->ring, 1, INFINITE, 0)) || g_dani_io_pop_completion((HIORING)reader->ring, &completion) != S_OK) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = (completion.UserData == DANI_IO_REGISTER_USER_DATA && SUCCEEDED(completion.ResultCode));
+    return (result);
+}
+
+static b32 InitialiseIoRing(dani_io_reader *reader) {
+    if (IsFailure(LoadIoRingFunctions())) {
+        return (B32_FAILURE);
+    }
+
+    // The completion queue has room for a completion of every read and the registration on top
+    IORING_CREATE_FLAGS flags;
+    flags.Required = IORING_CREATE_REQUIRED_FLAGS_NONE;
+    flags.Advisory = IORING_CREATE_ADVISORY_FLAGS_NONE;
+
+    HIORING ring;
+    if (FAILED(g_dani_io_create_ring(IORING_VERSION_1, flags, reader->depth, reader->depth * 2, &ring))) {
+        return (B32_FAILURE);
+    }
+    reader->ring = (void *)ring;
+
+    IORING_BUFFER_INFO buffers[DANI_IO_MAX_DEPTH];
+    for (u32 slot_index = 0; slot_index < reader->depth; slot_index += 1) {
+        buffers[slot_index].Address = reader->buffers + slot_index * reader->block_size;
+        buffers[slot_index].Length = (UINT32)reader->block_size;
+    }
+
+    if (FAILED(g_dani_io_build_register_buffers(ring, reader->depth, buffers, DANI_IO_REGISTER_USER_DATA))) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = WaitForIoRingRegistration(reader);
+    return (result);
+}
+
+#else
+
+static void CompleteIoRingReads(dani_io_reader *reader) { Unused(reader); }
+static b32 InitialiseIoRing(dani_io_reader *reader) { Unused(reader); return (B32_FAILURE); }
+
+#endif // DANI_IO_NO_IORING
+
+static DWORD WINAPI IoReadThread(LPVOID parameter) {
+    dani_io_thread *thread = (dani_io_thread *)parameter;
+    dani_io_reader *reader = thread->reader;
+
+    for (;;) {
+        dani_WaitSyncSemaphore(&reader->requests);
+        if (IsFalse(AtomicLoad32(&reader->is_running, MEMORY_ORDER_ACQUIRE))) {
+            break;
+        }
+
+        // Every request is posted after its slot was filled in, and slots are issued in order of their blocks
+        u64 block_index = (u64)AtomicIncrement64(&reader->taken_count) - 1;
+        u32 slot_index = (u32)(block_index % reader->depth);
+        dani_io_slot *slot = &reader->slots[slot_index];
+
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset = (DWORD)slot->offset;
+        overlapped.OffsetHigh = (DWORD)(slot->offset >> 32);
+        overlapped.hEvent = thread->event;
+
+        DWORD read_size = 0;
+        b32 is_read = (ReadFile(reader->file, reader->buffers + slot_index * reader->block_size, slot->size, 0, &overlapped) || GetLastError() == ERROR_IO_PENDING);
+        if (is_read) {
+            is_read = GetOverlappedResult(reader->file, &overlapped, &read_size, TRUE);
+        }
+
+        slot->read_size = (u32)read_size;
+        slot->is_failed = IsFalse(is_read);
+        AtomicStore32(&slot->state, DANI_IO_SLOT_DONE, MEMORY_ORDER_RELEASE);
+        dani_PostSyncSemaphore(&reader->completions, 1);
+    }
+
+    return (0);
+}
+
+static b32 InitialiseIoThreads(dani_io_reader *reader) {
+    dani_InitialiseSyncSemaphore(&reader->requests, 0, "dani_io Requests");
+    dani_InitialiseSyncSemaphore(&reader->completions, 0, "dani_io Completions");
+    reader->is_running = B32_TRUE;
+
+    for (u32 thread_index = 0; thread_index < ArrayCount(reader->threads); thread_index += 1) {
+        dani_io_thread *thread = &reader->threads[thread_index];
+        thread->reader = reader;
+
+        thread->event = CreateEventA(0, TRUE, FALSE, 0);
+        if (thread->event == 0) {
+            return (B32_FAILURE);
+        }
+
+        thread->thread = CreateThread(0, 0, IoReadThread, thread, 0, 0);
+        if (thread->thread == 0) {
+            return (B32_FAILURE);
+        }
+    }
+
+    return (B32_SUCCESS);
+}
+
+static void IssueIoRead(dani_io_reader *reader) {
+    u64 offset = reader->issued_count * reader->block_size;
+    if (offset >= reader->file_size || reader->is_failed) {
+        return;
+    }
+
+    u32 slot_index = (u32)(reader->issued_count % reader->depth);
+    dani_io_slot *slot = &reader->slots[slot_index];
+    slot->offset = offset;
+    slot->size = (u32)Min(reader->block_size, reader->file_size - offset);
+    slot->read_size = 0;
+    slot->is_failed = B32_FALSE;
+    slot->state = DANI_IO_SLOT_PENDING;
+
+#ifndef DANI_IO_NO_IORING
+    if (reader->backend == DANI_IO_BACKEND_IORING) {
+        IORING_HANDLE_REF file_ref = IoRingHandleRefFromIndex(0);
+        IORING_BUFFER_REF buffer_ref = IoRingBufferRefFromIndexAndOffset(slot_index, 0);
+
+        // The submission queue is as deep as the pipeline, so it only fails for broken rings
+        if (FAILED(g_dani_io_build_read((HIORING)reader->ring, file_ref, buffer_ref, slot->size, slot->offset, (UINT_PTR)slot_index, IOSQE_FLAGS_NONE))) {
+            slot->state = DANI_IO_SLOT_FREE;
+            reader->is_failed = B32_TRUE;
+            return;
+        }
+    }
+#endif // DANI_IO_NO_IORING
+
+    reader->issued_count += 1;
+    reader->unsubmitted_count += 1;
+}
+
+static void SubmitIoReads(dani_io_reader *reader, b32 is_waiting) {
+    if (reader->backend == DANI_IO_BACKEND_IORING) {
+#ifndef DANI_IO_NO_IORING
+        // One call submits the whole batch and waits for the next completion if asked to
+        if (FAILED(g_dani_io_submit_ring((HIORING)reader->ring, (is_waiting) ? 1 : 0, (is_waiting) ? INFINITE : 0, 0))) {
+            // The reads that were built since the last submission never reach the ring, so nothing will ever complete their slots
+            for (u32 index = 0; index < reader->unsubmitted_count; index += 1) {
+                u32 slot_index = (u32)((reader->issued_count - 1 - index) % reader->depth);
+                reader->slots[slot_index].state = DANI_IO_SLOT_FREE;
+            }
+            reader->is_failed = B32_TRUE;
+        }
+#endif // DANI_IO_NO_IORING
+    } else {
+        if (reader->unsubmitted_count) {
+            dani_PostSyncSemaphore(&reader->requests, (s32)reader->unsubmitted_count);
+        }
+
+        // Completions of blocks the consumer never waited for stay counted, so this can return early and only means something completed since the last wait
+        if (is_waiting) {
+            dani_WaitSyncSemaphore(&reader->completions);
+        }
+    }
+
+    reader->unsubmitted_count = 0;
+}
+
+static void WaitForIoSlot(dani_io_reader *reader, dani_io_slot *slot) {
+    for (;;) {
+        if (reader->backend == DANI_IO_BACKEND_IORING) {
+            CompleteIoRingReads(reader);
+        }
+
+        if (AtomicLoad32(&slot->state, MEMORY_ORDER_ACQUIRE) == DANI_IO_SLOT_DONE || reader->is_failed) {
+            break;
+        }
+
+        SubmitIoReads(reader, B32_TRUE);
+    }
+}
+
+__DANI_IO_DEF b32 dani_InitialiseIoReader(dani_io_reader *reader, u32 backend, u32 depth, u64 block_size) {
+    memset(reader, 0, sizeof(*reader));
+    reader->depth = Min((depth) ? depth : DANI_IO_DEFAULT_DEPTH, DANI_IO_MAX_DEPTH);
+    reader->block_size = (block_size) ? block_size : DANI_IO_DEFAULT_BLOCK_SIZE;
+
+    // Reads and registered buffers are limited to 32 bit sizes
+    reader->block_size = Min(reader->block_size, (u64)U32_MAX & ~(u64)(KiB(64) - 1));
+
+    reader->buffers = (u8 *)VirtualAlloc(0, reader->depth * reader->block_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (reader->buffers == 0) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = B32_FAILURE;
+    if (backend == DANI_IO_BACKEND_AUTO || backend == DANI_IO_BACKEND_IORING) {
+        reader->backend = DANI_IO_BACKEND_IORING;
+        result = InitialiseIoRing(reader);
+
+        if (IsFailure(result) && backend == DANI_IO_BACKEND_AUTO) {
+            dani_ReleaseIoReader(reader);
+            result = dani_InitialiseIoReader(reader, DANI_IO_BACKEND_THREADS, depth, block_size);
+        }
+    } else {
+        reader->backend = DANI_IO_BACKEND_THREADS;
+        result = InitialiseIoThreads(reader);
+    }
+
+    if (IsFailure(result)) {
+        dani_ReleaseIoReader(reader);
+    }
+
+    return (result);
+}
+
+__DANI_IO_DEF void dani_ReleaseIoReader(dani_io_reader *reader) {
+    dani_CloseIoFile(reader);
+
+#ifndef DANI_IO_NO_IORING
+    if (reader->ring) {
+        g_dani_io_close_ring((HIORING)reader->ring);
+    }
+#endif // DANI_IO_NO_IORING
+
+    if (reader->is_running) {
+        AtomicStore32(&reader->is_running, B32_FALSE, MEMORY_ORDER_RELEASE);
+        dani_PostSyncSemaphore(&reader->requests, ArrayCount(reader->threads));
+    }
+
+    for (u32 thread_index = 0; thread_index < ArrayCount(reader->threads); thread_index += 1) {
+        dani_io_thread *thread = &reader->threads[thread_index];
+        if (thread->thread) {
+            WaitForSingleObject(thread->thread, INFINITE);
+            CloseHandle(thread->thread);
+        }
+        if (thread->event) {
+            CloseHandle(thread->event);
+        }
+    }
+
+    if (reader->buffers) {
+        VirtualFree(reader->buffers, 0, MEM_RELEASE);
+    }
+
+    memset(reader, 0, sizeof(*reader));
+}
+
+__DANI_IO_DEF b32 dani_OpenIoFile(dani_io_reader *reader, const s8 *file_name) {
+    dani_CloseIoFile(reader);
+
+    reader->file = CreateFileA((const char *)file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OVERLAPPED, 0);
+    if (reader->file == INVALID_HANDLE_VALUE) {
+        reader->file = 0;
+        return (B32_FAILURE);
+    }
+
+    LARGE_INTEGER size;
+    if (IsFalse(GetFileSizeEx(reader->file, &size))) {
+        dani_CloseIoFile(reader);
+        return (B32_FAILURE);
+    }
+    reader->file_size = (u64)size.QuadPart;
+
+#ifndef DANI_IO_NO_IORING
+    if (reader->backend == DANI_IO_BACKEND_IORING) {
+        // This replaces the file of the previous open, reads refer to it by index 0
+        if (FAILED(g_dani_io_build_register_files((HIORING)reader->ring, 1, &reader->file, DANI_IO_REGISTER_USER_DATA)) || IsFailure(WaitForIoRingRegistration(reader))) {
+            dani_CloseIoFile(reader);
+            return (B32_FAILURE);
+        }
+    }
+#endif // DANI_IO_NO_IORING
+
+    // Fill the whole pipeline with one submission
+    for (u32 slot_index = 0; slot_index < reader->depth; slot_index += 1) {
+        IssueIoRead(reader);
+    }
+    SubmitIoReads(reader, B32_FALSE);
+
+    b32 result = IsFalse(reader->is_failed);
+    if (IsFailure(result)) {
+        dani_CloseIoFile(reader);
+    }
+
+    return (result);
+}
+
+__DANI_IO_DEF void dani_CloseIoFile(dani_io_reader *reader) {
+    if (reader->file == 0) {
+        return;
+    }
+
+    // The buffers and the handle can't be reused while a read is still in flight
+    SubmitIoReads(reader, B32_FALSE);
+    for (u32 slot_index = 0; slot_index < reader->depth; slot_index += 1) {
+        dani_io_slot *slot = &reader->slots[slot_index];
+        while (AtomicLoad32(&slot->state, MEMORY_ORDER_ACQUIRE) == DANI_IO_SLOT_PENDING) {
+            if (reader->backend == DANI_IO_BACKEND_IORING) {
+                CompleteIoRingReads(reader);
+#ifndef DANI_IO_NO_IORING
+                // A ring that can't be waited on anymore won't complete the read either, so the slot is given up
+                if (slot->state == DANI_IO_SLOT_PENDING && FAILED(g_dani_io_submit_ring((HIORING)reader->ring, 1, INFINITE, 0))) {
+                    break;
+                }
+#endif // DANI_IO_NO_IORING
+            } else {
+                dani_WaitSyncSemaphore(&reader->completions);
+            }
+        }
+
+        slot->state = DANI_IO_SLOT_FREE;
+    }
+
+    // Every request was taken by a worker, so the counters can start over for the next file. Completions that nobody waited for are dropped, they would only wake up the next wait for nothing.
+    reader->taken_count = 0;
+    while (dani_TryWaitSyncSemaphore(&reader->completions)) {
+        continue;
+    }
+
+    CloseHandle(reader->file);
+    reader->file = 0;
+    reader->file_size = 0;
+    reader->issued_count = 0;
+    reader->consumed_count = 0;
+    reader->unsubmitted_count = 0;
+    reader->is_holding_block = B32_FALSE;
+    reader->is_failed = B32_FALSE;
+}
+
+__DANI_IO_DEF b32 dani_NextIoBlock(dani_io_reader *reader, dani_io_block *block) {
+    block->data = 0;
+    block->size = 0;
+    block->offset = reader->consumed_count * reader->block_size;
+
+    // The buffer of the previous block is free again and goes to the next block that isn't read yet
+    if (reader->is_holding_block) {
+        reader->is_holding_block = B32_FALSE;
+        reader->consumed_count += 1;
+        block->offset += reader->block_size;
+
+        IssueIoRead(reader);
+        if (reader->unsubmitted_count >= DANI_IO_SUBMIT_BATCH) {
+            SubmitIoReads(reader, B32_FALSE);
+        }
+    }
+
+    if (block->offset >= reader->file_size || reader->is_failed) {
+        return (B32_FALSE);
+    }
+
+    u32 slot_index = (u32)(reader->consumed_count % reader->depth);
+    dani_io_slot *slot = &reader->slots[slot_index];
+
+    if (AtomicLoad32(&slot->state, MEMORY_ORDER_ACQUIRE) != DANI_IO_SLOT_DONE) {
+#if DANI_IO_PROFILE
+        dani_ProfileBandwidth(io_wait, "dani_IoWait", slot->size);
+#endif // DANI_IO_PROFILE
+
+        WaitForIoSlot(reader, slot);
+
+#if DANI_IO_PROFILE
+        dani_ProfileEnd(io_wait);
+#endif // DANI_IO_PROFILE
+    }
+
+    // Reads of regular files only come up short if the file got shorter while it was read
+    if (reader->is_failed || slot->is_failed || slot->read_size != slot->size) {
+        reader->is_failed = B32_TRUE;
+        return (B32_FALSE);
+    }
+
+    slot->state = DANI_IO_SLOT_FREE;
+    block->data = reader->buffers + slot_index * reader->block_size;
+    block->size = slot->size;
+    reader->is_holding_block = B32_TRUE;
+
+    return (B32_TRUE);
+}
+
+#endif // DANI_LIB_IO_IMPLEMENTATION
+
+/*
+Danilib - dani_io.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
@@ -0,0 +1,442 @@
+// Danilib - dani_jobs.h
+// Types and functions for a work stealing job system.
+//
+// Author: Dani Drywa (dani@drywa.me)
+// The job deques are based on the paper "Dynamic Circular Work-Stealing Deque" by David Chase and Yossi Lev.
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types and atomics
+// Windows.h - for CreateThread, WaitForSingleObject, CloseHandle, WaitOnAddress, WakeByAddressSingle, WakeByAddressAll, VirtualAlloc, VirtualFree, and GetSystemInfo. Link with Synchronization.lib.
+// string.h - for memset
+//
+// Notes:
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_JOBS_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_JOBS_STATIC before including this file.
+// The job system runs a fixed number of workers. The thread that initialises the job system is worker 0, all other workers get their own thread. Only one job system can exist at a time.
+// Every worker has its own deque of jobs. A worker pushes and pops jobs at the bottom of its own deque, while other workers steal from the top of it. A worker that runs out of jobs steals from randomly picked workers.
+// Jobs can only be started from worker 0 and from within other jobs. Every job decrements its counter once it is done, so a counter can be used to wait for any number of jobs. Waiting for a counter runs other jobs until the counter reaches zero, so worker 0 and jobs that wait for other jobs never sit idle.
+// Idle workers spin for DANI_JOBS_SPIN_COUNT (default 4096) attempts to find a job before they go to sleep with WaitOnAddress, which is the Windows version of a futex. Starting a job only wakes a sleeping worker if there is one.
+// Workers are cache line aligned and the top and bottom of every deque, as well as the fields that a worker writes while it steals, are DANI_JOBS_FALSE_SHARING_SIZE (default FALSE_SHARING_SIZE) bytes apart from everything other workers write. The distance can be changed by specifying DANI_JOBS_FALSE_SHARING_SIZE before including this file.
+// The deque of every worker can hold up to DANI_JOBS_PER_WORKER (default 4096, must be a power of 2) jobs that have been started but not taken by any worker yet. If the deque of a worker is full, a new job runs right away instead.
+// dani_ParallelFor splits a range into halves until they are no larger than the grain size. The worker keeps one half and pushes the other one, so stealing workers always take the largest remaining parts of the range.
+//
+// How to use:
+//
+// static void SquareRange(void *data, u64 first, u64 last) {
+//     f32 *values = (f32 *)data;
+//     for (u64 index = first; index < last; index += 1) {
+//         values[index] *= values[index];
+//     }
+// }
+//
+// dani_job_system job_system;
+// if (dani_InitialiseJobSystem(&job_system, 0)) { // 0 uses one worker per logical processor
+//     dani_ParallelFor(&job_system, value_count, 1024, SquareRange, values);
+//
+//     volatile s32 counter = 0;
+//     dani_RunJob(&job_system, MyJob, my_data, &counter);
+//     dani_RunJob(&job_system, MyOtherJob, my_other_data, &counter);
+//     dani_WaitForJobCounter(&job_system, &counter);
+//
+//     dani_ReleaseJobSystem(&job_system);
+// }
+//
+#ifndef __DANI_LIB_JOBS_H
+#define __DANI_LIB_JOBS_H
+
+#ifdef DANI_JOBS_STATIC
+#define __DANI_JOBS_DEC static
+#define __DANI_JOBS_DEF static
+#else
+#define __DANI_JOBS_DEC extern
+#define __DANI_JOBS_DEF
+#endif
+
+#ifndef DANI_JOBS_PER_WORKER
+#define DANI_JOBS_PER_WORKER 4096
+#endif
+
+#if !IsPower2(DANI_JOBS_PER_WORKER)
+#error "DANI_JOBS_PER_WORKER must be a power of 2"
+#endif
+
+#ifndef DANI_JOBS_SPIN_COUNT
+#define DANI_JOBS_SPIN_COUNT 4096
+#endif
+
+#ifndef DANI_JOBS_FALSE_SHARING_SIZE
+#define DANI_JOBS_FALSE_SHARING_SIZE FALSE_SHARING_SIZE
+#endif
+
+typedef void dani_job_function(void *data);
+typedef void dani_job_range_function(void *data, u64 first, u64 last);
+
+typedef struct __DANI_JOB dani_job;
+struct __DANI_JOB {
+    dani_job_function *function;
+    dani_job_range_function *range_function;
+    void *data;
+    volatile s32 *counter;
+
+    // Only used by range jobs
+    u64 first;
+    u64 last;
+    u64 grain;
+};
+
+typedef struct __DANI_JOB_DEQUE dani_job_deque;
+struct __DANI_JOB_DEQUE {
+    // Stolen from the top
+    volatile s64 top;
+    u8 padding0[DANI_JOBS_FALSE_SHARING_SIZE - sizeof(s64)];
+
+    // Pushed to and popped from the bottom
+    volatile s64 bottom;
+    u8 padding1[DANI_JOBS_FALSE_SHARING_SIZE - sizeof(s64)];
+
+    // Jobs are stored by value, a thief copies a job before it tries to take it
+    dani_job jobs[DANI_JOBS_PER_WORKER];
+};
+
+typedef struct __DANI_JOB_SYSTEM dani_job_system;
+
+typedef struct __DANI_JOB_WORKER dani_job_worker;
+struct CacheAligned __DANI_JOB_WORKER {
+    // First, so the top and bottom of the deque start on their own cache lines
+    dani_job_deque deque;
+
+    dani_job_system *system;
+    HANDLE thread;
+    u32 index;
+    u32 random_state;
+    u8 padding[DANI_JOBS_FALSE_SHARING_SIZE - sizeof(dani_job_system *) - sizeof(HANDLE) - sizeof(u32) * 2];
+};
+
+struct __DANI_JOB_SYSTEM {
+    dani_job_worker *workers;
+    u32 worker_count;
+
+    volatile s32 is_running;
+    volatile s32 sleeping_count;
+
+    // Changes whenever a job is started while workers sleep, sleeping workers wait for it to change
+    volatile s32 work_epoch;
+};
+
+__DANI_JOBS_DEC b32 dani_InitialiseJobSystem(dani_job_system *system, u32 worker_count);
+__DANI_JOBS_DEC void dani_ReleaseJobSystem(dani_job_system *system);
+
+__DANI_JOBS_DEC void dani_RunJob(dani_job_system *system, dani_job_function *function, void *data, volatile s32 *counter);
+__DANI_JOBS_DEC void dani_WaitForJobCounter(dani_job_system *system, volatile s32 *counter);
+__DANI_JOBS_DEC void dani_ParallelFor(dani_job_system *system, u64 count, u64 grain, dani_job_range_function *function, void *data);
+
+#endif // __DANI_LIB_JOBS_H
+
+#ifdef DANI_LIB_JOBS_IMPLEMENTATION
+
+static ThreadLocal dani_job_worker *g_dani_jobs_current_worker = 0;
+
+static b32 PushJobDeque(dani_job_deque *deque, const dani_job *job) {
+    s64 bottom = AtomicLoad64(&deque->bottom, MEMORY_ORDER_RELAXED);
+    s64 top = AtomicLoad64(&deque->top, MEMORY_ORDER_ACQUIRE);
+    if (bottom - top >= DANI_JOBS_PER_WORKER) {
+        return (B32_FALSE);
+    }
+
+    deque->jobs[bottom & (DANI_JOBS_PER_WORKER - 1)] = *job;
+
+    // The job has to be visible before the new bottom
+    AtomicStore64(&deque->bottom, bottom + 1, MEMORY_ORDER_RELEASE);
+
+    return (B32_TRUE);
+}
+
+static b32 PopJobDeque(dani_job_deque *deque, dani_job *job) {
+    s64 bottom = AtomicLoad64(&deque->bottom, MEMORY_ORDER_RELAXED) - 1;
+
+    // The new bottom has to be visible to thieves before reading the top
+    AtomicStore64(&deque->bottom, bottom, MEMORY_ORDER_SEQ_CST);
+
+    s64 top = AtomicLoad64(&deque->top, MEMORY_ORDER_SEQ_CST);
+    if (top > bottom) {
+        // Empty
+        AtomicStore64(&deque->bottom, bottom + 1, MEMORY_ORDER_RELAXED);
+        return (B32_FALSE);
+    }
+
+    b32 result = B32_TRUE;
+    *job = deque->jobs[bottom & (DANI_JOBS_PER_WORKER - 1)];
+    if (top == bottom) {
+        // Last job, race against thieves for it
+        if (AtomicCompareExchange64(&deque->top, top, top + 1, MEMORY_ORDER_SEQ_CST) != top) {
+            result = B32_FALSE;
+        }
+        AtomicStore64(&deque->bottom, bottom + 1, MEMORY_ORDER_RELAXED);
+    }
+
+    return (result);
+}
+
+static b32 StealJobDeque(dani_job_deque *deque, dani_job *job) {
+    s64 top = AtomicLoad64(&deque->top, MEMORY_ORDER_ACQUIRE);
+    MemoryFence();
+    s64 bottom = AtomicLoad64(&deque->bottom, MEMORY_ORDER_ACQUIRE);
+
+    if (top >= bottom) {
+        return (B32_FALSE);
+    }
+
+    // The copy can be torn if the owner reuses the slot in the meantime, but then the top has moved and the exchange fails
+    *job = deque->jobs[top & (DANI_JOBS_PER_WORKER - 1)];
+    if (AtomicCompareExchange64(&deque->top, top, top + 1, MEMORY_ORDER_SEQ_CST) != top) {
+        // Another thief or the owner took it
+        return (B32_FALSE);
+    }
+
+    return (B32_TRUE);
+}
+
+static u32 GetJobRandomNumber(dani_job_worker *worker) {
+    // xorshift32
+    u32 x = worker->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker->random_state = x;
+    return (x);
+}
+
+static b32 FindJob(dani_job_system *system, dani_job_worker *worker, dani_job *job) {
+    b32 result = PopJobDeque(&worker->deque, job);
+
+    if (IsFalse(result) && system->worker_count > 1) {
+        u32 victim_index = GetJobRandomNumber(worker) % system->worker_count;
+        for (u32 attempt = 0; attempt < system->worker_count && IsFalse(result); attempt += 1) {
+            if (victim_index != worker->index) {
+                result = StealJobDeque(&system->workers[victim_index].deque, job);
+            }
+
+            victim_index = (victim_index + 1 < system->worker_count) ? victim_index + 1 : 0;
+        }
+    }
+
+    return (result);
+}
+
+static void PushJob(dani_job_system *system, dani_job_worker *worker, const dani_job *job);
+
+static void RunJobRange(dani_job_system *system, dani_job_worker *worker, dani_job_range_function *function, void *data, u64 first, u64 last, u64 grain, volatile s32 *counter) {
+    // Keep the lower half and hand out the upper half until the range is small enough
+    while (last - first > grain) {
+        u64 middle = first + (last - first) / 2;
+
+        dani_job job = {0};
+        job.range_function = function;
+        job.data = data;
+        job.counter = counter;
+        job.first = middle;
+        job.last = last;
+        job.grain = grain;
+
+        AtomicIncrement32(counter);
+        PushJob(system, worker, &job);
+
+        last = middle;
+    }
+
+    function(data, first, last);
+}
+
+static void ExecuteJob(dani_job_system *system, dani_job_worker *worker, const dani_job *job) {
+    if (job->range_function) {
+        RunJobRange(system, worker, job->range_function, job->data, job->first, job->last, job->grain, job->counter);
+    } else {
+        job->function(job->data);
+    }
+
+    AtomicDecrement32(job->counter);
+}
+
+static void PushJob(dani_job_system *system, dani_job_worker *worker, const dani_job *job) {
+    if (IsFalse(PushJobDeque(&worker->deque, job))) {
+        ExecuteJob(system, worker, job);
+        return;
+    }
+
+    // Either a worker that is about to sleep sees the new bottom or we see it sleeping
+    MemoryFence();
+    if (AtomicLoad32(&system->sleeping_count, MEMORY_ORDER_RELAXED) > 0) {
+        AtomicIncrement32(&system->work_epoch);
+        WakeByAddressSingle((PVOID)&system->work_epoch);
+    }
+}
+
+static DWORD WINAPI JobWorkerThread(LPVOID parameter) {
+    dani_job_worker *worker = (dani_job_worker *)parameter;
+    dani_job_system *system = worker->system;
+    g_dani_jobs_current_worker = worker;
+
+    dani_job job;
+    u32 spin_count = 0;
+    while (AtomicLoad32(&system->is_running, MEMORY_ORDER_RELAXED)) {
+        if (FindJob(system, worker, &job)) {
+            ExecuteJob(system, worker, &job);
+            spin_count = 0;
+            continue;
+        }
+
+        if (spin_count < DANI_JOBS_SPIN_COUNT) {
+            spin_count += 1;
+            CpuPause();
+            continue;
+        }
+
+        // Read the epoch before looking for work one last time, so a job started in between sees this worker sleeping and changes the epoch, which makes WaitOnAddress return right away
+        AtomicIncrement32(&system->sleeping_count);
+        s32 work_epoch = AtomicLoad32(&system->work_epoch, MEMORY_ORDER_ACQUIRE);
+
+        if (FindJob(system, worker, &job)) {
+            AtomicDecrement32(&system->sleeping_count);
+            ExecuteJob(system, worker, &job);
+        } else {
+            if (AtomicLoad32(&system->is_running, MEMORY_ORDER_RELAXED)) {
+                WaitOnAddress((volatile VOID *)&system->work_epoch, &work_epoch, sizeof(work_epoch), INFINITE);
+            }
+            AtomicDecrement32(&system->sleeping_count);
+        }
+
+        spin_count = 0;
+    }
+
+    return (0);
+}
+
+__DANI_JOBS_DEF b32 dani_InitialiseJobSystem(dani_job_system *system, u32 worker_count) {
+    memset(system, 0, sizeof(*system));
+    Assert(g_dani_jobs_current_worker == 0);
+
+    if (worker_count == 0) {
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        worker_count = Max(system_info.dwNumberOfProcessors, 1);
+    }
+
+    system->workers = (dani_job_worker *)VirtualAlloc(0, worker_count * sizeof(dani_job_worker), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (system->workers == 0) {
+        return (B32_FAILURE);
+    }
+
+    system->worker_count = worker_count;
+    system->is_running = B32_TRUE;
+
+    for (u32 worker_index = 0; worker_index < worker_count; worker_index += 1) {
+        dani_job_worker *worker = &system->workers[worker_index];
+        worker->system = system;
+        worker->index = worker_index;
+        worker->random_state = 0x9E3779B9u * (worker_index + 1);
+    }
+
+    g_dani_jobs_current_worker = &system->workers[0];
+
+    for (u32 worker_index = 1; worker_index < worker_count; worker_index += 1) {
+        dani_job_worker *worker = &system->workers[worker_index];
+        worker->thread = CreateThread(0, 0, JobWorkerThread, worker, 0, 0);
+        if (worker->thread == 0) {
+            dani_ReleaseJobSystem(system);
+            return (B32_FAILURE);
+        }
+    }
+
+    return (B32_SUCCESS);
+}
+
+__DANI_JOBS_DEF void dani_ReleaseJobSystem(dani_job_system *system) {
+    if (system->workers == 0) {
+        return;
+    }
+
+    AtomicStore32(&system->is_running, B32_FALSE, MEMORY_ORDER_RELEASE);
+    AtomicIncrement32(&system->work_epoch);
+    WakeByAddressAll((PVOID)&system->work_epoch);
+
+    for (u32 worker_index = 1; worker_index < system->worker_count; worker_index += 1) {
+        dani_job_worker *worker = &system->workers[worker_index];
+        if (worker->thread) {
+            WaitForSingleObject(worker->thread, INFINITE);
+            CloseHandle(worker->thread);
+        }
+    }
+
+    VirtualFree(system->workers, 0, MEM_RELEASE);
+    system->workers = 0;
+    g_dani_jobs_current_worker = 0;
+}
+
+__DANI_JOBS_DEF void dani_RunJob(dani_job_system *system, dani_job_function *function, void *data, volatile s32 *counter) {
+    dani_job_worker *worker = g_dani_jobs_current_worker;
+    Assert(worker && worker->system == system);
+
+    dani_job job = {0};
+    job.function = function;
+    job.data = data;
+    job.counter = counter;
+
+    AtomicIncrement32(counter);
+    PushJob(system, worker, &job);
+}
+
+__DANI_JOBS_DEF void dani_WaitForJobCounter(dani_job_system *system, volatile s32 *counter) {
+    dani_job_worker *worker = g_dani_jobs_current_worker;
+    Assert(worker && worker->system == system);
+
+    // Help with other jobs instead of waiting idle
+    dani_job job;
+    while (AtomicLoad32(counter, MEMORY_ORDER_ACQUIRE) > 0) {
+        if (FindJob(system, worker, &job)) {
+            ExecuteJob(system, worker, &job);
+        } else {
+            CpuPause();
+        }
+    }
+}
+
+__DANI_JOBS_DEF void dani_ParallelFor(dani_job_system *system, u64 count, u64 grain, dani_job_range_function *function, void *data) {
+    dani_job_worker *worker = g_dani_jobs_current_worker;
+    Assert(worker && worker->system == system);
+
+    volatile s32 counter = 0;
+    RunJobRange(system, worker, function, data, 0, count, Max(grain, 1), &counter);
+    dani_WaitForJobCounter(system, &counter);
+}
+
+#endif // DANI_LIB_JOBS_IMPLEMENTATION
+
+/*
+Danilib - dani_jobs.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
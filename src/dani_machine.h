@@ -0,0 +1,505 @@
+// Danilib - dani_machine.h
+// Types and functions for measuring what the caches, memory, and TLB of a machine are capable of.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types
+// dani_format.h - for formatting the results. The format implementation has to be included in the same translation unit as the machine implementation.
+// dani_profiler.h - for the CPU timer. The profiler implementation has to be included in the same translation unit before the machine implementation, DANI_PROFILER_ENABLED is not required.
+// dani_arena.h - for dani_EnableLargePages. The arena implementation has to be part of the program.
+// Windows.h - for GetLogicalProcessorInformation, GetSystemInfo, GetLargePageMinimum, VirtualAlloc, VirtualFree, CreateFileA, ReadFile, and WriteFile
+// Intrin.h - for the SSE2 load and store intrinsics
+// stdio.h - for printf. (can be removed by specifying DANI_MACHINE_PRINTF)
+// string.h - for memset and memcmp
+//
+// Notes:
+// This library is *NOT* thread safe. Run the probe on an otherwise idle machine, every other process competes for the same caches and memory bandwidth.
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_MACHINE_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_MACHINE_STATIC before including this file.
+// To print the results this library is using printf by default. However, you can change the print function by specifying DANI_MACHINE_PRINTF(...) before including this file.
+// Every measurement is repeated DANI_MACHINE_REPETITIONS (default 10) times and the best result is kept. This filters out interrupts and other noise.
+// Bandwidth is measured with SSE2 loads and stores of 64 bytes per loop iteration. Each level is tested with a working set of half its cache size, main memory with DANI_MACHINE_MEMORY_TEST_SIZE (default 256MiB) or four times the largest cache, whichever is larger. Every bandwidth run processes at least DANI_MACHINE_BANDWIDTH_BYTES (default 256MiB) by looping over the working set.
+// Latency is measured by chasing pointers in a random cycle through the working set. Every run takes DANI_MACHINE_LATENCY_STEPS (default 1 million) dependent loads.
+// The TLB miss cost is the difference between chasing one pointer per page through DANI_MACHINE_TLB_TEST_SIZE (default 64MiB) of 4KiB pages and the same pattern in large pages. Large pages require the "Lock pages in memory" user right. If it is missing the large page latency and TLB miss cost are reported as 0.
+// The page fault cost is measured by touching every page of a fresh DANI_MACHINE_PAGE_FAULT_TEST_SIZE (default 64MiB) allocation.
+// A full probe takes a few seconds. Store the results with dani_WriteMachineFile and load them with dani_ReadMachineFile to not repeat the probe in every run.
+//
+// How to use:
+// Probe the machine once, for example with the dani_machine_probe program in the benchmarks directory, and hand the peak bandwidth to the profiler so every bandwidth zone also reports the percentage of the peak:
+//
+// dani_machine machine;
+// if (dani_ReadMachineFile(&machine, "machine.dprobe") || dani_ProbeMachine(&machine)) {
+//     dani_machine_level *memory = &machine.levels[machine.level_count - 1];
+//     dani_SetProfilingPeakBandwidth(memory->read_bandwidth, memory->write_bandwidth);
+// }
+//
+// Main memory is always the last level. For zones that work on data that fits into a cache use the bandwidth of that cache level instead.
+//
+#ifndef __DANI_LIB_MACHINE_H
+#define __DANI_LIB_MACHINE_H
+
+#ifdef DANI_MACHINE_STATIC
+#define __DANI_MACHINE_DEC static
+#define __DANI_MACHINE_DEF static
+#else
+#define __DANI_MACHINE_DEC extern
+#define __DANI_MACHINE_DEF
+#endif
+
+#ifndef DANI_MACHINE_PRINTF
+#define DANI_MACHINE_PRINTF(...) printf(__VA_ARGS__)
+#endif
+
+#ifndef DANI_MACHINE_REPETITIONS
+#define DANI_MACHINE_REPETITIONS 10
+#endif
+
+#ifndef DANI_MACHINE_MEMORY_TEST_SIZE
+#define DANI_MACHINE_MEMORY_TEST_SIZE MiB(256)
+#endif
+
+#ifndef DANI_MACHINE_BANDWIDTH_BYTES
+#define DANI_MACHINE_BANDWIDTH_BYTES MiB(256)
+#endif
+
+#ifndef DANI_MACHINE_LATENCY_STEPS
+#define DANI_MACHINE_LATENCY_STEPS Million(1)
+#endif
+
+#ifndef DANI_MACHINE_TLB_TEST_SIZE
+#define DANI_MACHINE_TLB_TEST_SIZE MiB(64)
+#endif
+
+#ifndef DANI_MACHINE_PAGE_FAULT_TEST_SIZE
+#define DANI_MACHINE_PAGE_FAULT_TEST_SIZE MiB(64)
+#endif
+
+// L1, L2, L3, and main memory
+#define DANI_MACHINE_LEVELS_MAX 4
+
+typedef struct __DANI_MACHINE_LEVEL dani_machine_level;
+struct __DANI_MACHINE_LEVEL {
+    u64 size; // Cache size in bytes, 0 for main memory
+    u64 test_size; // Working set of the measurements
+
+    f64 read_bandwidth; // Bytes per second
+    f64 write_bandwidth; // Bytes per second
+    f64 latency_ticks; // Ticks per dependent load
+};
+
+typedef struct __DANI_MACHINE dani_machine;
+struct __DANI_MACHINE {
+    u64 cpu_frequency;
+    u32 cache_line_size;
+    u32 page_size;
+    u64 large_page_size; // 0 if large pages are not available
+
+    // Caches from the fastest to the slowest, main memory is always the last level
+    dani_machine_level levels[DANI_MACHINE_LEVELS_MAX];
+    u32 level_count;
+
+    f64 small_page_latency_ticks;
+    f64 large_page_latency_ticks;
+    f64 tlb_miss_ticks;
+    f64 page_fault_ticks;
+};
+
+__DANI_MACHINE_DEC b32 dani_ProbeMachine(dani_machine *machine);
+__DANI_MACHINE_DEC void dani_PrintMachine(dani_machine *machine);
+
+__DANI_MACHINE_DEC b32 dani_WriteMachineFile(dani_machine *machine, const s8 *file_name);
+__DANI_MACHINE_DEC b32 dani_ReadMachineFile(dani_machine *machine, const s8 *file_name);
+
+#endif // __DANI_LIB_MACHINE_H
+
+#ifdef DANI_LIB_MACHINE_IMPLEMENTATION
+
+#define DANI_MACHINE_FILE_MAGIC "DANIMACH"
+#define DANI_MACHINE_FILE_VERSION 1
+
+// Keeps the results of the measurement loops alive
+static volatile u64 g_dani_machine_sink = 0;
+
+static u64 GetNextMachineRandom(u64 *state) {
+    // xorshift64
+    u64 x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return (x);
+}
+
+static void ReadMachineCaches(dani_machine *machine) {
+    DWORD buffer_size = 0;
+    GetLogicalProcessorInformation(0, &buffer_size);
+
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION *infos = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION *)VirtualAlloc(0, buffer_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (infos == 0) {
+        return;
+    }
+
+    u64 cache_sizes[3] = {0};
+    if (GetLogicalProcessorInformation(infos, &buffer_size)) {
+        u32 info_count = buffer_size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+        for (u32 info_index = 0; info_index < info_count; info_index += 1) {
+            SYSTEM_LOGICAL_PROCESSOR_INFORMATION *info = &infos[info_index];
+            if (info->Relationship != RelationCache) {
+                continue;
+            }
+
+            CACHE_DESCRIPTOR *cache = &info->Cache;
+            if ((cache->Type == CacheData || cache->Type == CacheUnified) && cache->Level >= 1 && cache->Level <= 3) {
+                cache_sizes[cache->Level - 1] = Max(cache_sizes[cache->Level - 1], (u64)cache->Size);
+                machine->cache_line_size = Max(machine->cache_line_size, (u32)cache->LineSize);
+            }
+        }
+    }
+
+    VirtualFree(infos, 0, MEM_RELEASE);
+
+    for (u32 cache_index = 0; cache_index < ArrayCount(cache_sizes); cache_index += 1) {
+        if (cache_sizes[cache_index]) {
+            dani_machine_level *level = &machine->levels[machine->level_count++];
+            level->size = cache_sizes[cache_index];
+            level->test_size = Max((level->size / 2) & ~(u64)63, KiB(4));
+        }
+    }
+}
+
+static u64 ReadMachineMemory(u8 *buffer, u64 buffer_size, u64 iteration_count) {
+    __m128i sum0 = _mm_setzero_si128();
+    __m128i sum1 = _mm_setzero_si128();
+    __m128i sum2 = _mm_setzero_si128();
+    __m128i sum3 = _mm_setzero_si128();
+
+    u64 start_ticks = ReadStartCPUTimer();
+    for (u64 iteration = 0; iteration < iteration_count; iteration += 1) {
+        for (u8 *at = buffer, *end = buffer + buffer_size; at < end; at += 64) {
+            sum0 = _mm_xor_si128(sum0, _mm_load_si128((__m128i *)(at + 0)));
+            sum1 = _mm_xor_si128(sum1, _mm_load_si128((__m128i *)(at + 16)));
+            sum2 = _mm_xor_si128(sum2, _mm_load_si128((__m128i *)(at + 32)));
+            sum3 = _mm_xor_si128(sum3, _mm_load_si128((__m128i *)(at + 48)));
+        }
+    }
+    u64 end_ticks = ReadEndCPUTimer();
+
+    __m128i sum = _mm_or_si128(_mm_or_si128(sum0, sum1), _mm_or_si128(sum2, sum3));
+    g_dani_machine_sink += (u64)_mm_cvtsi128_si32(sum);
+
+    u64 result = end_ticks - start_ticks;
+    return (result);
+}
+
+static u64 WriteMachineMemory(u8 *buffer, u64 buffer_size, u64 iteration_count) {
+    __m128i value = _mm_set1_epi8((char)iteration_count);
+
+    u64 start_ticks = ReadStartCPUTimer();
+    for (u64 iteration = 0; iteration < iteration_count; iteration += 1) {
+        for (u8 *at = buffer, *end = buffer + buffer_size; at < end; at += 64) {
+            _mm_store_si128((__m128i *)(at + 0), value);
+            _mm_store_si128((__m128i *)(at + 16), value);
+            _mm_store_si128((__m128i *)(at + 32), value);
+            _mm_store_si128((__m128i *)(at + 48), value);
+        }
+    }
+    u64 end_ticks = ReadEndCPUTimer();
+
+    u64 result = end_ticks - start_ticks;
+    return (result);
+}
+
+// Links node_count nodes of node_stride bytes into a single random cycle (Sattolo's algorithm). The node offset is rotated through the cache lines of a stride to not only hit the same cache sets.
+static void BuildMachinePointerChase(u8 *buffer, u64 node_count, u64 node_stride, u64 *random_state) {
+    u64 line_count = node_stride / 64;
+
+    for (u64 node_index = 0; node_index < node_count; node_index += 1) {
+        *(u64 *)(buffer + node_index * node_stride) = node_index;
+    }
+
+    for (u64 node_index = node_count - 1; node_index > 0; node_index -= 1) {
+        u64 swap_index = GetNextMachineRandom(random_state) % node_index;
+        u64 *a = (u64 *)(buffer + node_index * node_stride);
+        u64 *b = (u64 *)(buffer + swap_index * node_stride);
+        u64 temp = *a;
+        *a = *b;
+        *b = temp;
+    }
+
+    // Turn the permutation into pointers. The rotated offset of a node always stays within its own stride, so it can't overwrite the index of another node.
+    for (u64 node_index = 0; node_index < node_count; node_index += 1) {
+        u64 next_index = *(u64 *)(buffer + node_index * node_stride);
+        u64 next_offset = next_index * node_stride + (next_index % line_count) * 64;
+        u64 offset = node_index * node_stride + (node_index % line_count) * 64;
+        *(u64 *)(buffer + offset) = (u64)(buffer + next_offset);
+    }
+}
+
+static f64 MeasureMachineLatency(u8 *buffer, u64 buffer_size, u64 node_stride, u64 *random_state) {
+    u64 node_count = buffer_size / node_stride;
+    BuildMachinePointerChase(buffer, node_count, node_stride, random_state);
+
+    u64 best_ticks = U64_MAX;
+    for (u32 repetition = 0; repetition < DANI_MACHINE_REPETITIONS; repetition += 1) {
+        void **at = (void **)buffer;
+
+        u64 start_ticks = ReadStartCPUTimer();
+        for (u32 step = 0; step < DANI_MACHINE_LATENCY_STEPS; step += 1) {
+            at = (void **)*at;
+        }
+        u64 end_ticks = ReadEndCPUTimer();
+
+        g_dani_machine_sink += (u64)at;
+        best_ticks = Min(best_ticks, end_ticks - start_ticks);
+    }
+
+    f64 result = (f64)best_ticks / (f64)DANI_MACHINE_LATENCY_STEPS;
+    return (result);
+}
+
+static void MeasureMachineLevel(dani_machine *machine, dani_machine_level *level, u8 *buffer, u64 *random_state) {
+    u64 iteration_count = Max(DANI_MACHINE_BANDWIDTH_BYTES / level->test_size, 1);
+    f64 byte_count = (f64)(iteration_count * level->test_size);
+
+    u64 best_read_ticks = U64_MAX;
+    u64 best_write_ticks = U64_MAX;
+    for (u32 repetition = 0; repetition < DANI_MACHINE_REPETITIONS; repetition += 1) {
+        best_read_ticks = Min(best_read_ticks, ReadMachineMemory(buffer, level->test_size, iteration_count));
+        best_write_ticks = Min(best_write_ticks, WriteMachineMemory(buffer, level->test_size, iteration_count));
+    }
+
+    level->read_bandwidth = byte_count / ((f64)best_read_ticks / (f64)machine->cpu_frequency);
+    level->write_bandwidth = byte_count / ((f64)best_write_ticks / (f64)machine->cpu_frequency);
+    level->latency_ticks = MeasureMachineLatency(buffer, level->test_size, machine->cache_line_size, random_state);
+}
+
+static void MeasureMachinePages(dani_machine *machine, u64 *random_state) {
+    u64 tlb_test_size = AlignPower2(DANI_MACHINE_TLB_TEST_SIZE, MiB(2));
+    u64 node_count = tlb_test_size / machine->page_size;
+
+    u8 *small_pages = (u8 *)VirtualAlloc(0, tlb_test_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (small_pages) {
+        machine->small_page_latency_ticks = MeasureMachineLatency(small_pages, node_count * machine->page_size, machine->page_size, random_state);
+        VirtualFree(small_pages, 0, MEM_RELEASE);
+    }
+
+    u64 large_page_size = GetLargePageMinimum();
+    if (large_page_size && dani_EnableLargePages()) {
+        u64 large_test_size = AlignPower2(tlb_test_size, large_page_size);
+        u8 *large_pages = (u8 *)VirtualAlloc(0, large_test_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (large_pages) {
+            machine->large_page_size = large_page_size;
+            machine->large_page_latency_ticks = MeasureMachineLatency(large_pages, node_count * machine->page_size, machine->page_size, random_state);
+            VirtualFree(large_pages, 0, MEM_RELEASE);
+        }
+    }
+
+    if (machine->large_page_latency_ticks > 0.0) {
+        machine->tlb_miss_ticks = Max(machine->small_page_latency_ticks - machine->large_page_latency_ticks, 0.0);
+    }
+
+    // Every repetition needs fresh pages, otherwise there is nothing to fault in
+    u64 page_count = DANI_MACHINE_PAGE_FAULT_TEST_SIZE / machine->page_size;
+    u64 best_ticks = U64_MAX;
+    for (u32 repetition = 0; repetition < DANI_MACHINE_REPETITIONS; repetition += 1) {
+        volatile u8 *pages = (volatile u8 *)VirtualAlloc(0, page_count * machine->page_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (pages == 0) {
+            break;
+        }
+
+        u64 start_ticks = ReadStartCPUTimer();
+        for (u64 page_index = 0; page_index < page_count; page_index += 1) {
+            pages[page_index * machine->page_size] = (u8)page_index;
+        }
+        u64 end_ticks = ReadEndCPUTimer();
+
+        best_ticks = Min(best_ticks, end_ticks - start_ticks);
+        VirtualFree((void *)pages, 0, MEM_RELEASE);
+    }
+
+    if (best_ticks != U64_MAX) {
+        machine->page_fault_ticks = (f64)best_ticks / (f64)page_count;
+    }
+}
+
+__DANI_MACHINE_DEF b32 dani_ProbeMachine(dani_machine *machine) {
+    memset(machine, 0, sizeof(*machine));
+
+    machine->cpu_frequency = ReadCPUTimerFrequency(100);
+    if (machine->cpu_frequency == 0) {
+        return (B32_FAILURE);
+    }
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    machine->page_size = system_info.dwPageSize;
+
+    ReadMachineCaches(machine);
+    if (machine->cache_line_size < 64) {
+        machine->cache_line_size = 64;
+    }
+
+    // Main memory has to be well out of reach of the largest cache
+    u64 largest_cache_size = (machine->level_count) ? machine->levels[machine->level_count - 1].size : 0;
+    dani_machine_level *memory = &machine->levels[machine->level_count++];
+    memory->test_size = AlignPower2(Max(DANI_MACHINE_MEMORY_TEST_SIZE, largest_cache_size * 4), MiB(2));
+
+    u8 *buffer = (u8 *)VirtualAlloc(0, memory->test_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (buffer == 0) {
+        return (B32_FAILURE);
+    }
+
+    // Fault in all pages before measuring
+    memset(buffer, 1, memory->test_size);
+
+    u64 random_state = 0x9E3779B97F4A7C15ull ^ ReadStartCPUTimer();
+    for (u32 level_index = 0; level_index < machine->level_count; level_index += 1) {
+        MeasureMachineLevel(machine, &machine->levels[level_index], buffer, &random_state);
+    }
+
+    VirtualFree(buffer, 0, MEM_RELEASE);
+
+    MeasureMachinePages(machine, &random_state);
+
+    return (B32_SUCCESS);
+}
+
+static void FlushMachineReport(dani_format_buffer *report) {
+    DANI_MACHINE_PRINTF("%.*s", (int)report->length, (const char *)report->data);
+}
+
+static void FormatMachineBandwidth(dani_format_buffer *report, const s8 *label, f64 bytes_per_second, u64 cpu_frequency) {
+    dani_FormatPrint(report, "%s: ", label);
+    dani_FormatByteCount(report, bytes_per_second);
+    dani_FormatPrint(report, "/s (%0.2fbyte/cycle)", bytes_per_second / (f64)cpu_frequency);
+}
+
+static void FormatMachineTicks(dani_format_buffer *report, const s8 *label, f64 ticks, u64 cpu_frequency) {
+    f64 nanoseconds = (ticks / (f64)cpu_frequency) * 1000000000.0;
+    dani_FormatPrint(report, "%s: %0.2fcycles (%0.2fns)", label, ticks, nanoseconds);
+}
+
+__DANI_MACHINE_DEF void dani_PrintMachine(dani_machine *machine) {
+    s8 text[2048];
+    dani_format_buffer report_buffer;
+    dani_format_buffer *report = &report_buffer;
+    dani_InitialiseFormatBuffer(report, text, sizeof(text), FlushMachineReport);
+
+    dani_FormatPrint(report, "CPU timer frequency: %0.2fGHz, Cache line: %ubyte, Page: ", (f64)machine->cpu_frequency / 1000000000.0, machine->cache_line_size);
+    dani_FormatByteCount(report, (f64)machine->page_size);
+    if (machine->large_page_size) {
+        dani_FormatString(report, ", Large page: ");
+        dani_FormatByteCount(report, (f64)machine->large_page_size);
+    }
+    dani_FormatString(report, "\n");
+
+    for (u32 level_index = 0; level_index < machine->level_count; level_index += 1) {
+        dani_machine_level *level = &machine->levels[level_index];
+
+        if (level->size) {
+            dani_FormatPrint(report, "  L%u[", level_index + 1);
+            dani_FormatByteCount(report, (f64)level->size);
+        } else {
+            dani_FormatString(report, "  Memory[");
+            dani_FormatByteCount(report, (f64)level->test_size);
+        }
+        dani_FormatString(report, "] - ");
+
+        FormatMachineBandwidth(report, "Read", level->read_bandwidth, machine->cpu_frequency);
+        FormatMachineBandwidth(report, ", Write", level->write_bandwidth, machine->cpu_frequency);
+        FormatMachineTicks(report, ", Latency", level->latency_ticks, machine->cpu_frequency);
+        dani_FormatString(report, "\n");
+    }
+
+    dani_FormatString(report, "  TLB - ");
+    FormatMachineTicks(report, "Small pages", machine->small_page_latency_ticks, machine->cpu_frequency);
+    if (machine->large_page_size) {
+        FormatMachineTicks(report, ", Large pages", machine->large_page_latency_ticks, machine->cpu_frequency);
+        FormatMachineTicks(report, ", Miss", machine->tlb_miss_ticks, machine->cpu_frequency);
+    } else {
+        dani_FormatString(report, ", Large pages: not available");
+    }
+    dani_FormatString(report, "\n");
+
+    dani_FormatString(report, "  ");
+    FormatMachineTicks(report, "Page fault", machine->page_fault_ticks, machine->cpu_frequency);
+    dani_FormatString(report, " per touched page\n");
+
+    dani_FlushFormatBuffer(report);
+}
+
+__DANI_MACHINE_DEF b32 dani_WriteMachineFile(dani_machine *machine, const s8 *file_name) {
+    HANDLE file = CreateFileA(file_name, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    u32 version = DANI_MACHINE_FILE_VERSION;
+    DWORD written_magic = 0;
+    DWORD written_version = 0;
+    DWORD written_machine = 0;
+    WriteFile(file, DANI_MACHINE_FILE_MAGIC, 8, &written_magic, 0);
+    WriteFile(file, &version, sizeof(version), &written_version, 0);
+    WriteFile(file, machine, sizeof(*machine), &written_machine, 0);
+    CloseHandle(file);
+
+    b32 result = (written_magic == 8 && written_version == sizeof(version) && written_machine == sizeof(*machine));
+    return (result);
+}
+
+__DANI_MACHINE_DEF b32 dani_ReadMachineFile(dani_machine *machine, const s8 *file_name) {
+    HANDLE file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    s8 magic[8];
+    u32 version = 0;
+    DWORD read_magic = 0;
+    DWORD read_version = 0;
+    DWORD read_machine = 0;
+    ReadFile(file, magic, sizeof(magic), &read_magic, 0);
+    ReadFile(file, &version, sizeof(version), &read_version, 0);
+
+    b32 result = B32_FAILURE;
+    if (read_magic == sizeof(magic) && memcmp(magic, DANI_MACHINE_FILE_MAGIC, sizeof(magic)) == 0 && version == DANI_MACHINE_FILE_VERSION) {
+        ReadFile(file, machine, sizeof(*machine), &read_machine, 0);
+        result = (read_machine == sizeof(*machine));
+    }
+
+    CloseHandle(file);
+    return (result);
+}
+
+#endif // DANI_LIB_MACHINE_IMPLEMENTATION
+
+/*
+Danilib - dani_machine.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
@@ -0,0 +1,500 @@
+// Danilib - dani_pool.h
+// Types and functions for fixed size block pool allocators.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types
+// dani_format.h - for formatting the statistics. The format implementation has to be included in the same translation unit as the pool implementation.
+// Windows.h - for VirtualAlloc, VirtualFree, and GetSystemInfo
+// stdio.h - for printf. (can be removed by specifying DANI_POOL_PRINTF)
+// string.h - for memset
+//
+// Notes:
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_POOL_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_POOL_STATIC before including this file.
+// To print the statistics this library is using printf by default. However, you can change the print function by specifying DANI_POOL_PRINTF(...) before including this file.
+// A pool hands out blocks of a single size. It reserves a range of virtual memory for up to reserve_size bytes of blocks and commits it page by page while new blocks are carved out of it. Blocks are never given back to the OS until the pool is released.
+// Allocating and freeing is thread safe. Every thread has its own cache for every pool that holds up to two batches of DANI_POOL_BATCH_SIZE (default 64) free blocks. Allocating and freeing only touches the cache of the calling thread. Once the cache is empty a whole batch is taken from the shared free list of the pool (or carved from unused memory) and once it is full a whole batch is given back. The shared free list is a lock free stack of batches. Its head stores a 32 bit block index together with a 32 bit tag that changes with every update, which protects it against the ABA problem.
+// Blocks can be freed by any thread, they end up in the cache of the thread that freed them.
+// A thread should call dani_FlushPoolCaches before it exits, otherwise the blocks in its caches are lost until the pool is released. The statistics only include the allocations and frees of a cache after its next refill or flush.
+// Up to DANI_POOLS_MAX (default 32) pools can exist at the same time. The id of a released pool is handed to the next pool. Every pool gets a new generation, so the caches that other threads still hold for a released pool are dropped the next time they are used or flushed. Every pool can hold up to 4 billion blocks. Block sizes are rounded up to a multiple of 16 bytes, which is also the alignment of every block.
+// A pool set combines multiple pools of different size classes. Allocations are served by the smallest class that fits and frees are routed back to the class by address. Up to DANI_POOL_SET_CLASSES_MAX (default 16) classes are supported.
+// Releasing a pool while other threads still use it is undefined behaviour.
+//
+// How to use:
+//
+// dani_pool pool;
+// if (dani_InitialisePool(&pool, sizeof(my_message), GiB(1))) {
+//     my_message *message = (my_message *)dani_AllocatePoolBlock(&pool);
+//     dani_FreePoolBlock(&pool, message);
+//
+//     dani_FlushPoolCaches();
+//     dani_PrintPoolStatistics(&pool);
+//     dani_ReleasePool(&pool);
+// }
+//
+// u64 block_sizes[] = { 32, 64, 256, 1024 };
+// dani_pool_set pool_set;
+// if (dani_InitialisePoolSet(&pool_set, block_sizes, ArrayCount(block_sizes), GiB(1))) {
+//     void *block = dani_AllocatePoolSetBlock(&pool_set, 100); // Served by the 256 byte class
+//     dani_FreePoolSetBlock(&pool_set, block);
+//     dani_ReleasePoolSet(&pool_set);
+// }
+//
+#ifndef __DANI_LIB_POOL_H
+#define __DANI_LIB_POOL_H
+
+#ifdef DANI_POOL_STATIC
+#define __DANI_POOL_DEC static
+#define __DANI_POOL_DEF static
+#else
+#define __DANI_POOL_DEC extern
+#define __DANI_POOL_DEF
+#endif
+
+#ifndef DANI_POOL_PRINTF
+#define DANI_POOL_PRINTF(...) printf(__VA_ARGS__)
+#endif
+
+#ifndef DANI_POOL_BATCH_SIZE
+#define DANI_POOL_BATCH_SIZE 64
+#endif
+
+#ifndef DANI_POOLS_MAX
+#define DANI_POOLS_MAX 32
+#endif
+
+#ifndef DANI_POOL_SET_CLASSES_MAX
+#define DANI_POOL_SET_CLASSES_MAX 16
+#endif
+
+typedef struct __DANI_POOL dani_pool;
+struct __DANI_POOL {
+    u8 *base;
+    u64 block_size;
+    u64 reserve_size;
+    u32 block_count_max;
+    u32 page_size;
+    u32 id;
+    u32 generation;
+
+    // Shared free list of batches: (tag << 32) | (block index + 1), 0 if empty
+    volatile s64 free_batches;
+    volatile s64 carved_block_count;
+
+    // Statistics
+    volatile s64 allocation_count;
+    volatile s64 free_count;
+    volatile s64 refill_count;
+    volatile s64 flush_count;
+};
+
+typedef struct __DANI_POOL_SET dani_pool_set;
+struct __DANI_POOL_SET {
+    dani_pool pools[DANI_POOL_SET_CLASSES_MAX];
+    u32 pool_count;
+};
+
+__DANI_POOL_DEC b32 dani_InitialisePool(dani_pool *pool, u64 block_size, u64 reserve_size);
+__DANI_POOL_DEC void dani_ReleasePool(dani_pool *pool);
+
+__DANI_POOL_DEC void *dani_AllocatePoolBlock(dani_pool *pool);
+__DANI_POOL_DEC void dani_FreePoolBlock(dani_pool *pool, void *block);
+__DANI_POOL_DEC void dani_FlushPoolCaches(void);
+
+__DANI_POOL_DEC void dani_PrintPoolStatistics(dani_pool *pool);
+
+__DANI_POOL_DEC b32 dani_InitialisePoolSet(dani_pool_set *pool_set, const u64 *block_sizes, u32 block_size_count, u64 reserve_size_per_class);
+__DANI_POOL_DEC void dani_ReleasePoolSet(dani_pool_set *pool_set);
+__DANI_POOL_DEC void *dani_AllocatePoolSetBlock(dani_pool_set *pool_set, u64 size);
+__DANI_POOL_DEC void dani_FreePoolSetBlock(dani_pool_set *pool_set, void *block);
+__DANI_POOL_DEC void dani_PrintPoolSetStatistics(dani_pool_set *pool_set);
+
+#endif // __DANI_LIB_POOL_H
+
+#ifdef DANI_LIB_POOL_IMPLEMENTATION
+
+// Layout of a block while it is free
+typedef struct __DANI_POOL_FREE_BLOCK dani_pool_free_block;
+struct __DANI_POOL_FREE_BLOCK {
+    u32 next_index; // Next block of the same batch (block index + 1)
+    u32 next_batch_index; // Next batch in the shared free list (block index + 1), only valid for the first block of a batch
+    u32 batch_count; // Only valid for the first block of a batch
+};
+
+typedef struct __DANI_POOL_CACHE dani_pool_cache;
+struct __DANI_POOL_CACHE {
+    dani_pool *pool;
+    u32 generation; // Generation of the pool the cache belongs to, 0 if unused
+
+    u32 current_index;
+    u32 current_count;
+    u32 spare_index;
+    u32 spare_count;
+
+    // Not yet published to the pool statistics
+    s64 allocation_count;
+    s64 free_count;
+};
+
+// Generation of the pool that uses an id, 0 if the id is free
+static volatile s32 g_dani_pool_id_generations[DANI_POOLS_MAX];
+static volatile s32 g_dani_pool_generation_counter = 0;
+static ThreadLocal dani_pool_cache g_dani_pool_caches[DANI_POOLS_MAX];
+
+static dani_pool_free_block *GetPoolFreeBlock(dani_pool *pool, u32 index) {
+    dani_pool_free_block *result = (dani_pool_free_block *)(pool->base + (u64)(index - 1) * pool->block_size);
+    return (result);
+}
+
+static void PublishPoolCacheStatistics(dani_pool *pool, dani_pool_cache *cache) {
+    AtomicAdd64(&pool->allocation_count, cache->allocation_count, MEMORY_ORDER_RELAXED);
+    AtomicAdd64(&pool->free_count, cache->free_count, MEMORY_ORDER_RELAXED);
+    cache->allocation_count = 0;
+    cache->free_count = 0;
+}
+
+static void PushPoolBatch(dani_pool *pool, u32 first_index, u32 count) {
+    dani_pool_free_block *first = GetPoolFreeBlock(pool, first_index);
+    first->batch_count = count;
+
+    for (;;) {
+        s64 head = AtomicLoad64(&pool->free_batches, MEMORY_ORDER_ACQUIRE);
+        first->next_batch_index = (u32)head;
+
+        s64 new_head = (s64)((((u64)head >> 32) + 1) << 32 | first_index);
+        if (AtomicCompareExchange64(&pool->free_batches, head, new_head, MEMORY_ORDER_ACQ_REL) == head) {
+            break;
+        }
+    }
+}
+
+static b32 PopPoolBatch(dani_pool *pool, u32 *first_index, u32 *count) {
+    for (;;) {
+        s64 head = AtomicLoad64(&pool->free_batches, MEMORY_ORDER_ACQUIRE);
+        u32 head_index = (u32)head;
+        if (head_index == 0) {
+            return (B32_FALSE);
+        }
+
+        // The block might already be taken by another thread, but its memory stays valid and the tag makes the exchange fail in that case
+        u32 next_index = GetPoolFreeBlock(pool, head_index)->next_batch_index;
+
+        s64 new_head = (s64)((((u64)head >> 32) + 1) << 32 | next_index);
+        if (AtomicCompareExchange64(&pool->free_batches, head, new_head, MEMORY_ORDER_ACQ_REL) == head) {
+            *first_index = head_index;
+            *count = GetPoolFreeBlock(pool, head_index)->batch_count;
+            return (B32_TRUE);
+        }
+    }
+}
+
+static b32 CarvePoolBatch(dani_pool *pool, u32 *first_index, u32 *count) {
+    u64 first = (u64)AtomicAdd64(&pool->carved_block_count, DANI_POOL_BATCH_SIZE, MEMORY_ORDER_RELAXED);
+    if (first >= pool->block_count_max) {
+        return (B32_FALSE);
+    }
+
+    u64 carved_count = Min(DANI_POOL_BATCH_SIZE, pool->block_count_max - first);
+
+    // Committing already committed pages is fine, so neighbouring batches don't need to coordinate
+    u64 start = first * pool->block_size;
+    u64 end = (first + carved_count) * pool->block_size;
+    u64 commit_start = start & ~((u64)pool->page_size - 1);
+    u64 commit_end = AlignPower2(end, (u64)pool->page_size);
+    if (VirtualAlloc(pool->base + commit_start, commit_end - commit_start, MEM_COMMIT, PAGE_READWRITE) == 0) {
+        return (B32_FALSE);
+    }
+
+    for (u64 block_offset = 0; block_offset < carved_count; block_offset += 1) {
+        u32 index = (u32)(first + block_offset + 1);
+        GetPoolFreeBlock(pool, index)->next_index = (block_offset + 1 < carved_count) ? index + 1 : 0;
+    }
+
+    *first_index = (u32)(first + 1);
+    *count = (u32)carved_count;
+    return (B32_TRUE);
+}
+
+static b32 RefillPoolCache(dani_pool *pool, dani_pool_cache *cache) {
+    AtomicIncrement64(&pool->refill_count);
+    PublishPoolCacheStatistics(pool, cache);
+
+    b32 result = PopPoolBatch(pool, &cache->current_index, &cache->current_count);
+    if (IsFalse(result)) {
+        result = CarvePoolBatch(pool, &cache->current_index, &cache->current_count);
+    }
+
+    return (result);
+}
+
+static void FlushPoolCache(dani_pool *pool, dani_pool_cache *cache) {
+    if (cache->current_count) {
+        PushPoolBatch(pool, cache->current_index, cache->current_count);
+    }
+    if (cache->spare_count) {
+        PushPoolBatch(pool, cache->spare_index, cache->spare_count);
+    }
+
+    AtomicIncrement64(&pool->flush_count);
+    PublishPoolCacheStatistics(pool, cache);
+
+    memset(cache, 0, sizeof(*cache));
+}
+
+static dani_pool_cache *GetPoolCache(dani_pool *pool) {
+    dani_pool_cache *result = &g_dani_pool_caches[pool->id];
+    if (result->generation != pool->generation) {
+        // The cache is unused or still belongs to a released pool with the same id, whose blocks are gone
+        memset(result, 0, sizeof(*result));
+        result->pool = pool;
+        result->generation = pool->generation;
+    }
+
+    return (result);
+}
+
+__DANI_POOL_DEF b32 dani_InitialisePool(dani_pool *pool, u64 block_size, u64 reserve_size) {
+    memset(pool, 0, sizeof(*pool));
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    pool->page_size = system_info.dwPageSize;
+    pool->block_size = AlignPower2(Max(block_size, sizeof(dani_pool_free_block)), 16);
+    pool->reserve_size = AlignPower2(reserve_size, (u64)system_info.dwAllocationGranularity);
+    pool->block_count_max = (u32)Min(pool->reserve_size / pool->block_size, (u64)U32_MAX - 1);
+
+    // A pool without an id is safe to release
+    pool->id = DANI_POOLS_MAX;
+    if (pool->block_count_max == 0) {
+        return (B32_FAILURE);
+    }
+
+    // The generation is never 0, so it can't match an unused cache (it only wraps after 4 billion pools)
+    s32 generation = AtomicIncrement32(&g_dani_pool_generation_counter);
+    if (generation == 0) {
+        generation = AtomicIncrement32(&g_dani_pool_generation_counter);
+    }
+
+    for (u32 id = 0; id < DANI_POOLS_MAX; id += 1) {
+        if (AtomicCompareExchange32(&g_dani_pool_id_generations[id], 0, generation, MEMORY_ORDER_ACQ_REL) == 0) {
+            pool->id = id;
+            pool->generation = (u32)generation;
+            break;
+        }
+    }
+
+    Assert(pool->id < DANI_POOLS_MAX);
+    if (pool->id >= DANI_POOLS_MAX) {
+        return (B32_FAILURE);
+    }
+
+    pool->base = (u8 *)VirtualAlloc(0, pool->reserve_size, MEM_RESERVE, PAGE_NOACCESS);
+    if (pool->base == 0) {
+        dani_ReleasePool(pool);
+        return (B32_FAILURE);
+    }
+
+    return (B32_SUCCESS);
+}
+
+__DANI_POOL_DEF void dani_ReleasePool(dani_pool *pool) {
+    if (pool->base) {
+        VirtualFree(pool->base, 0, MEM_RELEASE);
+    }
+
+    pool->base = 0;
+
+    // Hand the id to the next pool. The caches of all threads are dropped the next time they are used, because the generation doesn't match anymore.
+    if (pool->id < DANI_POOLS_MAX) {
+        AtomicCompareExchange32(&g_dani_pool_id_generations[pool->id], (s32)pool->generation, 0, MEMORY_ORDER_ACQ_REL);
+        pool->id = DANI_POOLS_MAX;
+    }
+}
+
+__DANI_POOL_DEF void *dani_AllocatePoolBlock(dani_pool *pool) {
+    dani_pool_cache *cache = GetPoolCache(pool);
+
+    if (cache->current_count == 0) {
+        if (cache->spare_count) {
+            cache->current_index = cache->spare_index;
+            cache->current_count = cache->spare_count;
+            cache->spare_index = 0;
+            cache->spare_count = 0;
+        } else if (IsFalse(RefillPoolCache(pool, cache))) {
+            return (0);
+        }
+    }
+
+    dani_pool_free_block *block = GetPoolFreeBlock(pool, cache->current_index);
+    cache->current_index = block->next_index;
+    cache->current_count -= 1;
+    cache->allocation_count += 1;
+
+    return (block);
+}
+
+__DANI_POOL_DEF void dani_FreePoolBlock(dani_pool *pool, void *block) {
+    if (block == 0) {
+        return;
+    }
+
+    Assert((u8 *)block >= pool->base && (u8 *)block < pool->base + pool->reserve_size);
+
+    dani_pool_cache *cache = GetPoolCache(pool);
+
+    if (cache->current_count == DANI_POOL_BATCH_SIZE) {
+        // Keep one full batch as spare and hand the older one back to the pool
+        if (cache->spare_count) {
+            AtomicIncrement64(&pool->flush_count);
+            PushPoolBatch(pool, cache->spare_index, cache->spare_count);
+            PublishPoolCacheStatistics(pool, cache);
+        }
+
+        cache->spare_index = cache->current_index;
+        cache->spare_count = cache->current_count;
+        cache->current_index = 0;
+        cache->current_count = 0;
+    }
+
+    u32 index = (u32)(((u8 *)block - pool->base) / pool->block_size) + 1;
+    ((dani_pool_free_block *)block)->next_index = cache->current_index;
+    cache->current_index = index;
+    cache->current_count += 1;
+    cache->free_count += 1;
+}
+
+__DANI_POOL_DEF void dani_FlushPoolCaches(void) {
+    for (u32 cache_index = 0; cache_index < DANI_POOLS_MAX; cache_index += 1) {
+        dani_pool_cache *cache = &g_dani_pool_caches[cache_index];
+        if (cache->generation == 0) {
+            continue;
+        }
+
+        // The pool of a stale cache has been released, only its memory has to be reset
+        if ((s32)cache->generation == AtomicLoad32(&g_dani_pool_id_generations[cache_index], MEMORY_ORDER_ACQUIRE)) {
+            FlushPoolCache(cache->pool, cache);
+        } else {
+            memset(cache, 0, sizeof(*cache));
+        }
+    }
+}
+
+static void FlushPoolStatistics(dani_format_buffer *buffer) {
+    DANI_POOL_PRINTF("%.*s", (int)buffer->length, (const char *)buffer->data);
+}
+
+__DANI_POOL_DEF void dani_PrintPoolStatistics(dani_pool *pool) {
+    u64 carved_count = Min((u64)pool->carved_block_count, (u64)pool->block_count_max);
+    u64 committed_size = AlignPower2(carved_count * pool->block_size, (u64)pool->page_size);
+    s64 live_count = pool->allocation_count - pool->free_count;
+
+    s8 text[512];
+    dani_format_buffer buffer;
+    dani_InitialiseFormatBuffer(&buffer, text, sizeof(text), FlushPoolStatistics);
+
+    dani_FormatString(&buffer, "  ");
+    dani_FormatByteCount(&buffer, (f64)pool->block_size);
+    dani_FormatPrint(&buffer, " blocks - Live: %lld (", live_count);
+    dani_FormatByteCount(&buffer, (f64)(Max(live_count, 0) * pool->block_size));
+    dani_FormatPrint(&buffer, "), Carved: %llu (", carved_count);
+    dani_FormatByteCount(&buffer, (f64)(carved_count * pool->block_size));
+    dani_FormatString(&buffer, "), Committed: ");
+    dani_FormatByteCount(&buffer, (f64)committed_size);
+    dani_FormatString(&buffer, " of ");
+    dani_FormatByteCount(&buffer, (f64)pool->reserve_size);
+    dani_FormatPrint(&buffer, ", Allocations: %lld, Frees: %lld, Refills: %lld, Flushes: %lld\n", pool->allocation_count, pool->free_count, pool->refill_count, pool->flush_count);
+
+    dani_FlushFormatBuffer(&buffer);
+}
+
+__DANI_POOL_DEF b32 dani_InitialisePoolSet(dani_pool_set *pool_set, const u64 *block_sizes, u32 block_size_count, u64 reserve_size_per_class) {
+    memset(pool_set, 0, sizeof(*pool_set));
+    Assert(block_size_count <= DANI_POOL_SET_CLASSES_MAX);
+
+    for (u32 size_index = 0; size_index < block_size_count && size_index < DANI_POOL_SET_CLASSES_MAX; size_index += 1) {
+        // Classes have to be sorted to find the smallest one that fits
+        Assert(size_index == 0 || block_sizes[size_index - 1] < block_sizes[size_index]);
+
+        if (IsFailure(dani_InitialisePool(&pool_set->pools[size_index], block_sizes[size_index], reserve_size_per_class))) {
+            dani_ReleasePoolSet(pool_set);
+            return (B32_FAILURE);
+        }
+
+        pool_set->pool_count += 1;
+    }
+
+    return (B32_SUCCESS);
+}
+
+__DANI_POOL_DEF void dani_ReleasePoolSet(dani_pool_set *pool_set) {
+    for (u32 pool_index = 0; pool_index < pool_set->pool_count; pool_index += 1) {
+        dani_ReleasePool(&pool_set->pools[pool_index]);
+    }
+
+    pool_set->pool_count = 0;
+}
+
+__DANI_POOL_DEF void *dani_AllocatePoolSetBlock(dani_pool_set *pool_set, u64 size) {
+    for (u32 pool_index = 0; pool_index < pool_set->pool_count; pool_index += 1) {
+        dani_pool *pool = &pool_set->pools[pool_index];
+        if (size <= pool->block_size) {
+            void *result = dani_AllocatePoolBlock(pool);
+            return (result);
+        }
+    }
+
+    return (0);
+}
+
+__DANI_POOL_DEF void dani_FreePoolSetBlock(dani_pool_set *pool_set, void *block) {
+    for (u32 pool_index = 0; pool_index < pool_set->pool_count; pool_index += 1) {
+        dani_pool *pool = &pool_set->pools[pool_index];
+        if ((u8 *)block >= pool->base && (u8 *)block < pool->base + pool->reserve_size) {
+            dani_FreePoolBlock(pool, block);
+            return;
+        }
+    }
+
+    Assert(block == 0);
+}
+
+__DANI_POOL_DEF void dani_PrintPoolSetStatistics(dani_pool_set *pool_set) {
+    for (u32 pool_index = 0; pool_index < pool_set->pool_count; pool_index += 1) {
+        dani_PrintPoolStatistics(&pool_set->pools[pool_index]);
+    }
+}
+
+#endif // DANI_LIB_POOL_IMPLEMENTATION
+
+/*
+Danilib - dani_pool.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
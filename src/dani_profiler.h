@@ -4,27 +4,44 @@
 // Author: Dani Drywa (dani@drywa.me)
 // This library is based on what I learned from Casey Muratori's excellent performance aware programming course at https://www.computerenhance.com/ and some other resources about benchmarking.
 //
-// Last change: 2024/10/05 (yyyy/mm/dd)
+// Last change: 2026/10/16 (yyyy/mm/dd)
 //
 // License: See end of file
 //
 // Dependencies:
 // dani_base.h - for the basic types
-// Windows.h - for QueryPerformanceCounter and QueryPerformanceFrequency
-// Intrin.h - for __rdtsc, __rdtscp, __faststorefence, and _InterlockedIncrement
-// stdio.h - for printf. (can be removed by specifying DANI_PROFILER_PRINTF)
+// dani_format.h - for formatting the results. The format implementation has to be included in the same translation unit as the profiler implementation.
+// Windows.h - for QueryPerformanceCounter, QueryPerformanceFrequency, and GetCurrentThreadId
+// Intrin.h - for __rdtsc, __rdtscp, and __faststorefence
+// stdio.h - for printf. (can be removed by specifying DANI_PROFILER_PRINTF) and fprintf if DANI_PROFILER_STACKS is enabled.
 // psapi.h - for GetProcessMemoryInfo if DANI_PROFILER_PAGE_FAULTS is enabled.
+// math.h - for sqrt if DANI_PROFILER_VARIANCE is enabled.
+// Windows.h - for the SRWLOCK functions used by dani_mutex and dani_rwlock.
+// Windows.h - for SetConsoleCtrlHandler if DANI_PROFILER_TOGGLE_ON_CTRL_BREAK is enabled.
+// Windows.h - for VirtualAlloc, CreateThread, CreateFileA, WriteFile, and the interlocked SList functions if DANI_PROFILER_TRACE is enabled.
+// DbgHelp.h - for SymInitialize and SymFromAddr if DANI_PROFILER_INSTRUMENT_FUNCTIONS is enabled. Link with Dbghelp.lib.
 //
 // Notes:
-// This library is *NOT* thread safe. If you are in need of profiling across multiple threads you have to make this code thread safe or you might want to consider using a different library better suited for your needs.
+// This library is *NOT* thread safe. Zones, counters, and the results are updated without any synchronisation, so every zone and counter should only be used by one thread at a time and everything else should only be called from the thread that calls dani_BeginProfiling. If you are in need of profiling across multiple threads you have to make this code thread safe or you might want to consider using a different library better suited for your needs.
+// The following parts can be used from any thread: dani_GetNextProfilerZoneIndex, the lock statistics of dani_mutex and dani_rwlock, the innermost zone of every thread that nested zones and blocked time belong to, the trace buffers (per thread), and the function registration of the -finstrument-functions hooks. The hooks record their zones with the regular zone functions though, so the same function running on several threads at once can lose hits and ticks.
 // All dependencies must be included before including this file.
 // To include the implementation specify DANI_LIB_PROFILER_IMPLEMENTATION before including this file.
 // To use static versions of the functions specify DANI_PROFILER_STATIC before including this file.
 // By default the profiles is able to record up to 1024 entries. If you want to tweak this value specify DANI_PROFILER_ENTRIES_MAX before including this file.
+// By default the profiler is able to track up to 256 counters. If you want to tweak this value specify DANI_PROFILER_COUNTERS_MAX before including this file.
+// By default the profiler is able to track up to 64 locks. If you want to tweak this value specify DANI_PROFILER_LOCKS_MAX before including this file.
 // To print the profiling results this library is using printf by default. However, you can change the print function by specifying DANI_PROFILER_PRINTF(...) before including this file.
+// dani_PrintProfilingResults formats the whole report into a buffer of DANI_PROFILER_REPORT_SIZE (default 512KiB, enough for about 1000 zones) bytes with dani_format.h and writes it with a single DANI_PROFILER_WRITE(data, length) call. Only a report that doesn't fit is written in multiple parts. By default DANI_PROFILER_WRITE goes through DANI_PROFILER_PRINTF, specify it before including this file to write the report somewhere else (for example with WriteFile).
 // To enable or disable the profiler define DANI_PROFILER_ENABLED with 1 or 0 respectively. By default the profiler is disabled. All profiling functions and macros will be stubbed out, with the exception of dani_BeginProfiling, dani_EndProfiling, and dani_PrintProfilingResults. These will still work and simply collect the overall elapsed time of the program without any sub-blocks.
 // To collect memory page fault metrics set DANI_PROFILER_PAGE_FAULTS to 1. This even takes effect if DANI_PROFILER_ENABLED is set to 0, it will just collect page faults for the overall runtime. Memory page faults are always an inclusive count, which means they include all page faults of sub-zones as well.
 // To enable collecting of min and max values set DANI_PROFILER_MIN_MAX to 1.
+// To track the spread of zone timings set DANI_PROFILER_VARIANCE to 1. Every zone keeps a running mean and variance (Welford's online algorithm) of its inclusive time and bandwidth per invocation. The results print the standard deviation and the coefficient of variation (stddev / mean) so jittery zones stand out. For sampled zones only the timed invocations are part of the statistics.
+// To keep the context of the slowest invocations of every zone set DANI_PROFILER_OUTLIERS to 1. Each zone keeps the DANI_PROFILER_OUTLIERS_MAX (default 4) slowest invocations with their timestamp, thread id, byte count, page faults, and an optional user tag (see dani_BeginProfilingZoneTagged).
+// To record the zone hierarchy set DANI_PROFILER_STACKS to 1. Every unique path of nested zones gets its own node with exclusive ticks, which can be written in the folded stack format used by flame graph tools (see How to use). By default up to 4096 unique paths are recorded, this can be changed by specifying DANI_PROFILER_STACK_NODES_MAX. Once all nodes are in use new paths are attributed to their parent path.
+// To be able to switch the profiler on and off while the program is running set DANI_PROFILER_RUNTIME_TOGGLE to 1. All zone and counter macros will then check a single global flag before doing anything else, even before they look up their zone index. An inactive zone costs a load and a well predicted branch when it starts and a branch on its local zone variable when it ends. Use dani_SetProfilingActive to flip the flag. By default the profiler starts active, set DANI_PROFILER_INITIALLY_ACTIVE to 0 to ship an instrumented build that is switched off until it is needed. Set DANI_PROFILER_TOGGLE_ON_CTRL_BREAK to 1 to toggle the profiler whenever the console receives Ctrl+Break (this installs a console control handler in dani_BeginProfiling). Keep in mind that dani_PrintProfilingResults still reports the total time of the whole run, even if the profiler was inactive for some of it.
+// To stream every zone begin/end and counter change into a binary trace file set DANI_PROFILER_TRACE to 1. The file name can be changed by specifying DANI_PROFILER_TRACE_FILE (default "profile.dtrace"). Events are collected in per-thread buffers of DANI_PROFILER_TRACE_BUFFER_EVENTS events and a background thread writes full buffers to disk. At most DANI_PROFILER_TRACE_BUFFERS_MAX buffers are allocated, if the writer can't keep up new events will be dropped and counted. When the begin of a zone is dropped its end is dropped as well. dani_EndProfiling also writes the partially filled buffers of all threads, so other threads should be done recording events before it is called, events recorded by them while the trace stops may be lost. The trace file can be decoded with dani_trace.h. This option is not part of DANI_PROFILER_ENABLE_ALL.
+// To profile every function without adding dani_ProfileFunction by hand set DANI_PROFILER_INSTRUMENT_FUNCTIONS to 1 and compile your code with clang or gcc and -finstrument-functions (MSVC has no equivalent that works on x64). The profiler then implements the __cyg_profile_func_enter and __cyg_profile_func_exit hooks and maps every function address to its own zone. Up to DANI_PROFILER_FUNCTIONS_MAX (default 4096, must be a power of 2) function addresses are tracked, but every included function also uses one of the DANI_PROFILER_ENTRIES_MAX entries. Functions are only recorded between dani_BeginProfiling and dani_EndProfiling and up to a call depth of DANI_PROFILER_FUNCTION_STACK_DEPTH_MAX (default 128) per thread. Function names are resolved with DbgHelp, so the program needs its debug information (.pdb) to print readable names. Use dani_IncludeProfilingFunctions and dani_ExcludeProfilingFunctions before dani_BeginProfiling to filter functions by name prefix and keep the overhead bounded (see How to use). This option is not part of DANI_PROFILER_ENABLE_ALL.
+// To see how close a zone gets to what the machine can do, pass the peak read and write bandwidth in bytes per second to dani_SetProfilingPeakBandwidth. Every bandwidth is then also printed as a percentage of the peak. Plain byte counts are compared against the read peak. The peak values can be measured with dani_machine.h.
 // To enable everything the profiler has to offer you can define DANI_PROFILER_ENABLE_ALL before including this library. This will overwrite any previous settings and enable everything.
 //
 // How to use:
@@ -65,8 +82,64 @@
 //
 // dani_ProfileFunctionEnd should always be called before any return statements.
 //
+// To only instrument the functions of your own code when compiling with -finstrument-functions and DANI_PROFILER_INSTRUMENT_FUNCTIONS use filters before starting the profiler. If there is at least one include filter a function has to match one of them. Exclude filters always win. Up to DANI_PROFILER_FUNCTION_FILTERS_MAX (default 16) filters can be added:
+//
+// dani_IncludeProfilingFunctions("game_");
+// dani_ExcludeProfilingFunctions("game_Math");
+// dani_BeginProfiling();
+//
+// The translation unit that includes the implementation should be compiled without -finstrument-functions. The profiler functions are skipped if it is not, but every call into the profiler will still pay for the hooks.
+//
 // The last argument of dani_BeginProfilingZone is the number of bytes that are about to be processed by the profiling zone. This can remain 0 if you don't want to track the bandwidth. To profile with the bandwidth included you have to provide the byte count. You can use the dani_ProfileBandwidth and dani_ProfileFunctionBandwidth macros in the same way you would use the dani_Profile and dani_ProfileFunction macros. The only difference is that it takes in a byte count argument as well.
 //
+// If a zone reads and writes very different amounts of memory, or its work is better measured in items (rows, packets, pixels) than in bytes, use dani_BeginProfilingZoneEx to provide the read byte count, write byte count, and item count separately.
+// The dani_ProfileBandwidthRW, dani_ProfileItems, dani_ProfileFunctionBandwidthRW, and dani_ProfileFunctionItems macros work the same way as dani_ProfileBandwidth. Read and write bytes are also added to the total bandwidth of the zone.
+// The results will show the read and write bandwidth and the item throughput per second as well as per CPU cycle.
+//
+// Besides timed zones the profiler can also track values over time, like a queue depth or a batch size. Use dani_ProfileCounter to set a counter to a value and dani_ProfileCounterAdd to add a (possibly negative) delta to it:
+//
+// dani_ProfileCounter("Batch Size", batch_count);
+// dani_ProfileCounterAdd("Queue Depth", 1);
+//
+// Counters are identified by their name, which means that multiple call sites using the same name will update the same counter. Each counter keeps track of the last, min, max, and average value and they are printed after the zones by dani_PrintProfilingResults.
+//
+// Zones that are hit extremely often can be sampled to reduce the profiling overhead. dani_ProfileSampled only reads the timer on every Nth invocation (N has to be at least 1), while still counting every hit. dani_ProfileSampledRandom does the same with a random interval that is N on average, which avoids aliasing with periodic patterns in your code:
+//
+// dani_ProfileSampled(var_name, "Hot Zone", 64);
+// // Add your code you want to profile here
+// dani_ProfileSampledEnd(var_name);
+//
+// Skipped invocations only increment a counter at the call site, which is added to the zone on its next sample and when dani_EndProfiling is called. The results of sampled zones are scaled up to an estimate for all hits and marked as sampled. Keep in mind that the exclusive time of a parent zone still contains the time of the skipped invocations.
+//
+// To correlate the slowest invocations of a zone with your logs you can attach a tag, like a request id, to the zone. The tag is reported together with the outliers if DANI_PROFILER_OUTLIERS is enabled:
+//
+// dani_ProfileTagged(var_name, "Handle Request", request_id);
+// // Add your code you want to profile here
+// dani_ProfileEnd(var_name);
+//
+// To find out how much time is spent waiting on locks use the dani_mutex and dani_rwlock wrappers around SRWLOCK instead of using SRWLOCK directly:
+//
+// dani_mutex mutex;
+// dani_InitialiseMutex(&mutex, "Queue Lock");
+// dani_LockMutex(&mutex);
+// // Critical section
+// dani_UnlockMutex(&mutex);
+//
+// u64 acquire_ticks = dani_LockRWLockShared(&rwlock); // Shared locks return their acquire time which has to be passed back on unlock
+// dani_UnlockRWLockShared(&rwlock, acquire_ticks);
+//
+// Every lock is tracked by name and records how often it was acquired, how often it was contended, and the ticks spent waiting for and holding it. The wait time is also charged to the innermost zone of the waiting thread and is shown as a separate Blocked column. Waits outside of any zone only show up for the lock.
+// Lock statistics are updated with interlocked operations, but keep in mind that the zones themselves are still not thread safe. If the profiler is disabled the wrappers compile down to plain SRWLOCK calls.
+// Other lock implementations (see dani_sync.h) can report into the same statistics. Get an index for the lock name with dani_GetProfilerLockIndex, then call dani_RecordProfilingLockAcquire after every acquire (with a wait start of 0 if the lock was free) and dani_RecordProfilingLockHold after every release.
+//
+// If DANI_PROFILER_STACKS is enabled the recorded zone hierarchy can be written in Brendan Gregg's folded stack format ("outer;middle;inner ticks") to render flame graphs with flamegraph.pl or similar tools.
+// The stacks have to be captured into a dani_profiler_stacks snapshot first. Two snapshots, for example of two different runs or of two phases of the program, can also be written as differential folded stacks ("outer;middle;inner ticks_a ticks_b") for difffolded.pl style diff flame graphs:
+//
+// static dani_profiler_stacks stacks; // The snapshot is quite big, so better not put it on the stack
+// dani_CaptureProfilingStacks(&stacks);
+// dani_WriteProfilingFoldedStacks(file, &stacks);
+// dani_WriteProfilingDiffFoldedStacks(file, &previous_stacks, &stacks);
+//
 #ifndef __DANI_LIB_PROFILER_H
 #define __DANI_LIB_PROFILER_H
 
@@ -82,14 +155,33 @@
 #define DANI_PROFILER_ENTRIES_MAX 1024
 #endif
 
+#ifndef DANI_PROFILER_COUNTERS_MAX
+#define DANI_PROFILER_COUNTERS_MAX 256
+#endif
+
+#ifndef DANI_PROFILER_LOCKS_MAX
+#define DANI_PROFILER_LOCKS_MAX 64
+#endif
+
 #ifndef DANI_PROFILER_PRINTF
 #define DANI_PROFILER_PRINTF(...) printf(__VA_ARGS__)
 #endif
 
+#ifndef DANI_PROFILER_WRITE
+#define DANI_PROFILER_WRITE(data, length) DANI_PROFILER_PRINTF("%.*s", (int)(length), (const char *)(data))
+#endif
+
+#ifndef DANI_PROFILER_REPORT_SIZE
+#define DANI_PROFILER_REPORT_SIZE KiB(512)
+#endif
+
 #ifdef DANI_PROFILER_ENABLE_ALL
 #define DANI_PROFILER_ENABLED 1
 #define DANI_PROFILER_PAGE_FAULTS 1
 #define DANI_PROFILER_MIN_MAX 1
+#define DANI_PROFILER_VARIANCE 1
+#define DANI_PROFILER_OUTLIERS 1
+#define DANI_PROFILER_STACKS 1
 #endif // DANI_PROFILER_ENABLE_ALL
 
 #ifndef DANI_PROFILER_ENABLED
@@ -104,15 +196,104 @@
 #define DANI_PROFILER_MIN_MAX 0
 #endif
 
+#ifndef DANI_PROFILER_VARIANCE
+#define DANI_PROFILER_VARIANCE 0
+#endif
+
+#ifndef DANI_PROFILER_OUTLIERS
+#define DANI_PROFILER_OUTLIERS 0
+#endif
+
+#ifndef DANI_PROFILER_OUTLIERS_MAX
+#define DANI_PROFILER_OUTLIERS_MAX 4
+#endif
+
+#ifndef DANI_PROFILER_STACKS
+#define DANI_PROFILER_STACKS 0
+#endif
+
+#ifndef DANI_PROFILER_STACK_NODES_MAX
+#define DANI_PROFILER_STACK_NODES_MAX 4096
+#endif
+
+#ifndef DANI_PROFILER_TRACE
+#define DANI_PROFILER_TRACE 0
+#endif
+
+#ifndef DANI_PROFILER_RUNTIME_TOGGLE
+#define DANI_PROFILER_RUNTIME_TOGGLE 0
+#endif
+
+#ifndef DANI_PROFILER_INITIALLY_ACTIVE
+#define DANI_PROFILER_INITIALLY_ACTIVE 1
+#endif
+
+#ifndef DANI_PROFILER_TOGGLE_ON_CTRL_BREAK
+#define DANI_PROFILER_TOGGLE_ON_CTRL_BREAK 0
+#endif
+
+#ifndef DANI_PROFILER_INSTRUMENT_FUNCTIONS
+#define DANI_PROFILER_INSTRUMENT_FUNCTIONS 0
+#endif
+
+#ifndef DANI_PROFILER_FUNCTIONS_MAX
+#define DANI_PROFILER_FUNCTIONS_MAX 4096
+#endif
+
+#if (DANI_PROFILER_FUNCTIONS_MAX & (DANI_PROFILER_FUNCTIONS_MAX - 1)) != 0
+#error "DANI_PROFILER_FUNCTIONS_MAX must be a power of 2"
+#endif
+
+#ifndef DANI_PROFILER_FUNCTION_STACK_DEPTH_MAX
+#define DANI_PROFILER_FUNCTION_STACK_DEPTH_MAX 128
+#endif
+
+#ifndef DANI_PROFILER_FUNCTION_FILTERS_MAX
+#define DANI_PROFILER_FUNCTION_FILTERS_MAX 16
+#endif
+
+#ifndef DANI_PROFILER_FUNCTION_NAME_LENGTH
+#define DANI_PROFILER_FUNCTION_NAME_LENGTH 128
+#endif
+
+#ifndef DANI_PROFILER_TRACE_FILE
+#define DANI_PROFILER_TRACE_FILE "profile.dtrace"
+#endif
+
+#ifndef DANI_PROFILER_TRACE_BUFFER_EVENTS
+#define DANI_PROFILER_TRACE_BUFFER_EVENTS (64 * 1024)
+#endif
+
+#ifndef DANI_PROFILER_TRACE_BUFFERS_MAX
+#define DANI_PROFILER_TRACE_BUFFERS_MAX 64
+#endif
+
 #if DANI_PROFILER_ENABLED
 
+#if DANI_PROFILER_OUTLIERS
+typedef struct __DANI_PROFILER_OUTLIER dani_profiler_outlier;
+struct __DANI_PROFILER_OUTLIER {
+    u64 inclusive_ticks;
+    u64 start_ticks;
+    u64 byte_count;
+    u64 page_fault_count;
+    u64 tag;
+    u32 thread_id;
+};
+#endif // DANI_PROFILER_OUTLIERS
+
 typedef struct __DANI_PROFILER_ENTRY dani_profiler_entry;
 struct __DANI_PROFILER_ENTRY {
     u64 inclusive_ticks;
     u64 exclusive_ticks;
 
     u64 hit_counter;
+    u64 skipped_hit_counter;
     u64 processed_bytes_counter;
+    u64 read_bytes_counter;
+    u64 write_bytes_counter;
+    u64 processed_items_counter;
+    volatile s64 blocked_ticks; // Added by the lock wrappers of any thread
 
 #if DANI_PROFILER_PAGE_FAULTS
     u64 page_fault_counter;
@@ -123,6 +304,62 @@ struct __DANI_PROFILER_ENTRY {
     u64 inclusive_ticks_max;
 #endif // DANI_PROFILER_MIN_MAX
 
+#if DANI_PROFILER_VARIANCE
+    // Running mean and sum of squared differences from the mean (M2) of every timed invocation
+    u64 variance_sample_counter;
+    f64 inclusive_ticks_mean;
+    f64 inclusive_ticks_m2;
+
+    // Bytes per tick, only invocations with a byte count are part of these
+    u64 bandwidth_sample_counter;
+    f64 bandwidth_mean;
+    f64 bandwidth_m2;
+#endif // DANI_PROFILER_VARIANCE
+
+#if DANI_PROFILER_OUTLIERS
+    // Min heap of the slowest invocations, the fastest of them is at index 0
+    dani_profiler_outlier outliers[DANI_PROFILER_OUTLIERS_MAX];
+    u32 outlier_count;
+#endif // DANI_PROFILER_OUTLIERS
+
+    const s8 *name;
+};
+
+typedef struct __DANI_PROFILER_COUNTER dani_profiler_counter;
+struct __DANI_PROFILER_COUNTER {
+    f64 last_value;
+    f64 min_value;
+    f64 max_value;
+    f64 sum_value;
+
+    u64 sample_counter;
+
+    const s8 *name;
+};
+
+typedef struct __DANI_PROFILER_LOCK dani_profiler_lock;
+struct __DANI_PROFILER_LOCK {
+    volatile s64 acquire_counter;
+    volatile s64 contended_counter;
+    volatile s64 wait_ticks;
+    volatile s64 hold_ticks;
+
+    const s8 *name;
+};
+
+typedef struct __DANI_MUTEX dani_mutex;
+struct __DANI_MUTEX {
+    SRWLOCK lock;
+    u32 lock_index;
+    u64 acquire_ticks;
+    const s8 *name;
+};
+
+typedef struct __DANI_RWLOCK dani_rwlock;
+struct __DANI_RWLOCK {
+    SRWLOCK lock;
+    u32 lock_index;
+    u64 acquire_ticks; // Only used for exclusive locks
     const s8 *name;
 };
 
@@ -139,11 +376,88 @@ struct __DANI_PROFILER_ZONE {
 
     u32 entry_index;
     u32 parent_index;
+
+#if DANI_PROFILER_OUTLIERS || DANI_PROFILER_VARIANCE
+    u64 byte_count;
+#endif // DANI_PROFILER_OUTLIERS || DANI_PROFILER_VARIANCE
+
+#if DANI_PROFILER_OUTLIERS
+    u64 tag;
+#endif // DANI_PROFILER_OUTLIERS
+
+#if DANI_PROFILER_STACKS
+    u32 node_index;
+    u32 parent_node_index;
+#endif // DANI_PROFILER_STACKS
+};
+
+#if DANI_PROFILER_STACKS
+typedef struct __DANI_PROFILER_STACK_NODE dani_profiler_stack_node;
+struct __DANI_PROFILER_STACK_NODE {
+    u64 exclusive_ticks;
+
+    u32 entry_index;
+    u32 parent_node_index;
+    u32 first_child_node_index;
+    u32 next_sibling_node_index;
+};
+
+typedef struct __DANI_PROFILER_STACKS dani_profiler_stacks;
+struct __DANI_PROFILER_STACKS {
+    dani_profiler_stack_node nodes[DANI_PROFILER_STACK_NODES_MAX];
+    const s8 *names[DANI_PROFILER_ENTRIES_MAX];
+    u32 node_count;
+};
+#endif // DANI_PROFILER_STACKS
+
+#if DANI_PROFILER_TRACE
+// Event types of the trace stream. See dani_trace.h for a description of the file format.
+#define DANI_PROFILER_TRACE_EVENT_BEGIN 0
+#define DANI_PROFILER_TRACE_EVENT_END 1
+#define DANI_PROFILER_TRACE_EVENT_COUNTER 2
+
+typedef struct __DANI_PROFILER_TRACE_EVENT dani_profiler_trace_event;
+struct __DANI_PROFILER_TRACE_EVENT {
+    u64 ticks;
+    f64 value;
+    u32 index;
+    u32 type;
+};
+
+typedef struct __DANI_PROFILER_TRACE_BUFFER dani_profiler_trace_buffer;
+struct __DANI_PROFILER_TRACE_BUFFER {
+    SLIST_ENTRY list_entry; // Must be the first member
+    u32 thread_id;
+    u32 event_count;
+    dani_profiler_trace_event events[DANI_PROFILER_TRACE_BUFFER_EVENTS];
+};
+
+typedef struct __DANI_PROFILER_TRACE dani_profiler_trace;
+struct __DANI_PROFILER_TRACE {
+    SLIST_HEADER free_buffers;
+    SLIST_HEADER full_buffers;
+
+    void *file_handle;
+    void *thread_handle;
+    void *wake_event;
+
+    u8 *encode_buffer;
+
+    // Every allocated buffer, so the partially filled buffers of all threads can be written when the trace stops
+    dani_profiler_trace_buffer *buffers[DANI_PROFILER_TRACE_BUFFERS_MAX];
+    volatile s32 buffer_count;
+    volatile s32 dropped_event_count;
+    volatile s32 is_stopping;
+    u32 generation; // Incremented by every start, buffers taken by threads during an earlier trace are not used anymore
+    u64 written_byte_count;
 };
+#endif // DANI_PROFILER_TRACE
 
 typedef struct __DANI_PROFILER dani_profiler;
 struct __DANI_PROFILER {
     dani_profiler_entry entries[DANI_PROFILER_ENTRIES_MAX];
+    dani_profiler_counter counters[DANI_PROFILER_COUNTERS_MAX];
+    dani_profiler_lock locks[DANI_PROFILER_LOCKS_MAX];
 
     u64 start_ticks;
     u64 end_ticks;
@@ -153,31 +467,176 @@ struct __DANI_PROFILER {
     u64 end_page_faults;
 #endif // DANI_PROFILER_PAGE_FAULTS
 
-    u32 current_index;
+#if DANI_PROFILER_STACKS
+    dani_profiler_stack_node stack_nodes[DANI_PROFILER_STACK_NODES_MAX];
+    u32 stack_node_count;
+#endif // DANI_PROFILER_STACKS
 };
 
 __DANI_PROFILER_DEC void dani_BeginProfiling(void);
 __DANI_PROFILER_DEC void dani_EndProfiling(void);
 __DANI_PROFILER_DEC void dani_PrintProfilingResults(void);
 
+#if DANI_PROFILER_RUNTIME_TOGGLE
+__DANI_PROFILER_DEC volatile b32 g_dani_profiler_is_active;
+
+__DANI_PROFILER_DEC void dani_SetProfilingActive(b32 is_active);
+#define dani_IsProfilingActive() (g_dani_profiler_is_active)
+#else
+#define dani_SetProfilingActive(...)
+#define dani_IsProfilingActive() (B32_TRUE)
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+__DANI_PROFILER_DEC void dani_SetProfilingPeakBandwidth(f64 read_bytes_per_second, f64 write_bytes_per_second);
+
 __DANI_PROFILER_DEC u32 dani_GetNextProfilerZoneIndex(void);
 __DANI_PROFILER_DEC dani_profiler_zone dani_BeginProfilingZone(const s8 *name, u32 index, u64 byte_count);
+__DANI_PROFILER_DEC dani_profiler_zone dani_BeginProfilingZoneSampled(const s8 *name, u32 index, u32 skipped_hit_count);
+__DANI_PROFILER_DEC u32 dani_GetNextProfilerSampledZoneIndex(u32 *skipped_hit_count);
+__DANI_PROFILER_DEC u32 dani_GetNextProfilerSampleInterval(u32 sample_rate);
+__DANI_PROFILER_DEC dani_profiler_zone dani_BeginProfilingZoneTagged(const s8 *name, u32 index, u64 byte_count, u64 tag);
+__DANI_PROFILER_DEC dani_profiler_zone dani_BeginProfilingZoneEx(const s8 *name, u32 index, u64 read_byte_count, u64 write_byte_count, u64 item_count);
 __DANI_PROFILER_DEC void dani_EndProfilingZone(dani_profiler_zone zone);
 
-#define dani_ProfileBandwidth(var_name, zone_name, byte_count) \
-    static u32 __dani_profile_##var_name##_index = 0;\
+__DANI_PROFILER_DEC u32 dani_GetProfilerCounterIndex(const s8 *name);
+__DANI_PROFILER_DEC void dani_SetProfilingCounter(u32 index, f64 value);
+__DANI_PROFILER_DEC void dani_AddProfilingCounter(u32 index, f64 delta);
+
+__DANI_PROFILER_DEC void dani_InitialiseMutex(dani_mutex *mutex, const s8 *name);
+__DANI_PROFILER_DEC void dani_LockMutex(dani_mutex *mutex);
+__DANI_PROFILER_DEC void dani_UnlockMutex(dani_mutex *mutex);
+
+__DANI_PROFILER_DEC void dani_InitialiseRWLock(dani_rwlock *rwlock, const s8 *name);
+__DANI_PROFILER_DEC void dani_LockRWLockExclusive(dani_rwlock *rwlock);
+__DANI_PROFILER_DEC void dani_UnlockRWLockExclusive(dani_rwlock *rwlock);
+__DANI_PROFILER_DEC u64 dani_LockRWLockShared(dani_rwlock *rwlock);
+__DANI_PROFILER_DEC void dani_UnlockRWLockShared(dani_rwlock *rwlock, u64 acquire_ticks);
+
+__DANI_PROFILER_DEC u32 dani_GetProfilerLockIndex(const s8 *name);
+__DANI_PROFILER_DEC void dani_RecordProfilingLockAcquire(u32 lock_index, const s8 *name, u64 wait_start_ticks, u64 acquire_ticks);
+__DANI_PROFILER_DEC void dani_RecordProfilingLockHold(u32 lock_index, u64 hold_ticks);
+
+#if DANI_PROFILER_STACKS
+__DANI_PROFILER_DEC void dani_CaptureProfilingStacks(dani_profiler_stacks *stacks);
+__DANI_PROFILER_DEC void dani_WriteProfilingFoldedStacks(FILE *file, dani_profiler_stacks *stacks);
+__DANI_PROFILER_DEC void dani_WriteProfilingDiffFoldedStacks(FILE *file, dani_profiler_stacks *stacks_a, dani_profiler_stacks *stacks_b);
+#else
+typedef u64 dani_profiler_stacks;
+#define dani_CaptureProfilingStacks(...)
+#define dani_WriteProfilingFoldedStacks(...)
+#define dani_WriteProfilingDiffFoldedStacks(...)
+#endif // DANI_PROFILER_STACKS
+
+#if DANI_PROFILER_TRACE
+__DANI_PROFILER_DEC void dani_FlushProfilingTrace(void);
+#else
+#define dani_FlushProfilingTrace()
+#endif // DANI_PROFILER_TRACE
+
+#if DANI_PROFILER_INSTRUMENT_FUNCTIONS
+__DANI_PROFILER_DEC void dani_IncludeProfilingFunctions(const s8 *name_prefix);
+__DANI_PROFILER_DEC void dani_ExcludeProfilingFunctions(const s8 *name_prefix);
+#else
+#define dani_IncludeProfilingFunctions(...)
+#define dani_ExcludeProfilingFunctions(...)
+#endif // DANI_PROFILER_INSTRUMENT_FUNCTIONS
+
+#define __dani_ProfileIndex(var_name) \
     if (__dani_profile_##var_name##_index == 0) {\
         __dani_profile_##var_name##_index = dani_GetNextProfilerZoneIndex();\
+    }
+
+#if DANI_PROFILER_RUNTIME_TOGGLE
+#define __DANI_PROFILER_IS_ACTIVE (g_dani_profiler_is_active)
+
+#define __dani_ProfileZone(var_name, begin_call) \
+    static u32 __dani_profile_##var_name##_index = 0;\
+    dani_profiler_zone __dani_profile_##var_name##_zone;\
+    __dani_profile_##var_name##_zone.start_ticks = 0;\
+    if (__DANI_PROFILER_IS_ACTIVE) {\
+        __dani_ProfileIndex(var_name)\
+        __dani_profile_##var_name##_zone = begin_call;\
+    }
+
+#define dani_ProfileEnd(var_name) Statement(\
+    if (__dani_profile_##var_name##_zone.start_ticks) {\
+        dani_EndProfilingZone(__dani_profile_##var_name##_zone);\
     }\
-    dani_profiler_zone __dani_profile_##var_name##_zone = dani_BeginProfilingZone((zone_name), __dani_profile_##var_name##_index, (byte_count))
+)
+#else
+#define __DANI_PROFILER_IS_ACTIVE (1)
 
-#define dani_Profile(var_name, zone_name) dani_ProfileBandwidth(var_name, zone_name, 0)
+#define __dani_ProfileZone(var_name, begin_call) \
+    static u32 __dani_profile_##var_name##_index = 0;\
+    __dani_ProfileIndex(var_name)\
+    dani_profiler_zone __dani_profile_##var_name##_zone = begin_call
 #define dani_ProfileEnd(var_name) dani_EndProfilingZone(__dani_profile_##var_name##_zone)
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+#define dani_ProfileBandwidth(var_name, zone_name, byte_count) \
+    __dani_ProfileZone(var_name, dani_BeginProfilingZone((zone_name), __dani_profile_##var_name##_index, (byte_count)))
+
+#define __dani_ProfileEx(var_name, zone_name, read_byte_count, write_byte_count, item_count) \
+    __dani_ProfileZone(var_name, dani_BeginProfilingZoneEx((zone_name), __dani_profile_##var_name##_index, (read_byte_count), (write_byte_count), (item_count)))
+
+#define dani_ProfileBandwidthRW(var_name, zone_name, read_byte_count, write_byte_count) __dani_ProfileEx(var_name, zone_name, read_byte_count, write_byte_count, 0)
+#define dani_ProfileItems(var_name, zone_name, item_count) __dani_ProfileEx(var_name, zone_name, 0, 0, item_count)
+
+#define dani_ProfileTagged(var_name, zone_name, tag) \
+    __dani_ProfileZone(var_name, dani_BeginProfilingZoneTagged((zone_name), __dani_profile_##var_name##_index, 0, (tag)))
+
+#define __dani_ProfileSampled(var_name, zone_name, next_interval) \
+    static u32 __dani_profile_##var_name##_countdown = 0;\
+    static u32 __dani_profile_##var_name##_skipped = 0;\
+    static u32 __dani_profile_##var_name##_index = 0;\
+    dani_profiler_zone __dani_profile_##var_name##_zone;\
+    __dani_profile_##var_name##_zone.start_ticks = 0;\
+    if (__DANI_PROFILER_IS_ACTIVE) {\
+        if (__dani_profile_##var_name##_index == 0) {\
+            __dani_profile_##var_name##_index = dani_GetNextProfilerSampledZoneIndex(&__dani_profile_##var_name##_skipped);\
+        }\
+        if (__dani_profile_##var_name##_countdown == 0) {\
+            __dani_profile_##var_name##_countdown = (next_interval);\
+            __dani_profile_##var_name##_zone = dani_BeginProfilingZoneSampled((zone_name), __dani_profile_##var_name##_index, __dani_profile_##var_name##_skipped);\
+            __dani_profile_##var_name##_skipped = 0;\
+        } else {\
+            __dani_profile_##var_name##_countdown -= 1;\
+            __dani_profile_##var_name##_skipped += 1;\
+        }\
+    }
+
+#define dani_ProfileSampled(var_name, zone_name, sample_rate) \
+    Assert((sample_rate) >= 1);\
+    __dani_ProfileSampled(var_name, zone_name, (sample_rate) - 1)
+#define dani_ProfileSampledRandom(var_name, zone_name, sample_rate) __dani_ProfileSampled(var_name, zone_name, dani_GetNextProfilerSampleInterval((sample_rate)))
+#define dani_ProfileSampledEnd(var_name) Statement(\
+    if (__dani_profile_##var_name##_zone.start_ticks) {\
+        dani_EndProfilingZone(__dani_profile_##var_name##_zone);\
+    }\
+)
+
+#define dani_Profile(var_name, zone_name) dani_ProfileBandwidth(var_name, zone_name, 0)
 
 #define dani_ProfileFunction() dani_Profile(function, __func__)
 #define dani_ProfileFunctionBandwidth(byte_count) dani_ProfileBandwidth(function, __func__, byte_count)
+#define dani_ProfileFunctionBandwidthRW(read_byte_count, write_byte_count) dani_ProfileBandwidthRW(function, __func__, read_byte_count, write_byte_count)
+#define dani_ProfileFunctionItems(item_count) dani_ProfileItems(function, __func__, item_count)
+#define dani_ProfileFunctionTagged(tag) dani_ProfileTagged(function, __func__, tag)
 #define dani_ProfileFunctionEnd() dani_ProfileEnd(function)
 
+#define __dani_ProfileCounterUpdate(counter_name, value, update_function) Statement(\
+    static u32 __dani_profile_counter_index = 0;\
+    if (__DANI_PROFILER_IS_ACTIVE) {\
+        if (__dani_profile_counter_index == 0) {\
+            __dani_profile_counter_index = dani_GetProfilerCounterIndex((counter_name));\
+        }\
+        update_function(__dani_profile_counter_index, (f64)(value));\
+    }\
+)
+
+#define dani_ProfileCounter(counter_name, value) __dani_ProfileCounterUpdate(counter_name, value, dani_SetProfilingCounter)
+#define dani_ProfileCounterAdd(counter_name, delta) __dani_ProfileCounterUpdate(counter_name, delta, dani_AddProfilingCounter)
+
 #else // NOT DANI_PROFILER_ENABLED
 
 typedef u64 dani_profiler_zone; 
@@ -196,18 +655,78 @@ __DANI_PROFILER_DEC void dani_BeginProfiling(void);
 __DANI_PROFILER_DEC void dani_EndProfiling(void);
 __DANI_PROFILER_DEC void dani_PrintProfilingResults(void);
 
+#define dani_SetProfilingActive(...)
+#define dani_IsProfilingActive() (B32_FALSE)
+
+#define dani_SetProfilingPeakBandwidth(...)
+
 #define dani_GetNextProfilerZoneIndex() 0
 #define dani_BeginProfilingZone(...) 0
+#define dani_BeginProfilingZoneSampled(...) 0
+#define dani_GetNextProfilerSampledZoneIndex(...) 0
+#define dani_GetNextProfilerSampleInterval(...) 0
+#define dani_BeginProfilingZoneTagged(...) 0
+#define dani_BeginProfilingZoneEx(...) 0
 #define dani_EndProfilingZone(...)
 
 #define dani_ProfileBandwidth(...)
+#define dani_ProfileBandwidthRW(...)
+#define dani_ProfileItems(...)
+#define dani_ProfileTagged(...)
+#define dani_ProfileSampled(...)
+#define dani_ProfileSampledRandom(...)
+#define dani_ProfileSampledEnd(...)
 #define dani_Profile(...)
 #define dani_ProfileEnd(...)
 
 #define dani_ProfileFunction()
 #define dani_ProfileFunctionBandwidth(...)
+#define dani_ProfileFunctionBandwidthRW(...)
+#define dani_ProfileFunctionItems(...)
+#define dani_ProfileFunctionTagged(...)
 #define dani_ProfileFunctionEnd()
 
+#define dani_GetProfilerCounterIndex(...) 0
+#define dani_SetProfilingCounter(...)
+#define dani_AddProfilingCounter(...)
+
+#define dani_ProfileCounter(...)
+#define dani_ProfileCounterAdd(...)
+
+typedef struct __DANI_MUTEX dani_mutex;
+struct __DANI_MUTEX {
+    SRWLOCK lock;
+};
+
+typedef struct __DANI_RWLOCK dani_rwlock;
+struct __DANI_RWLOCK {
+    SRWLOCK lock;
+};
+
+#define dani_InitialiseMutex(mutex, name) InitializeSRWLock(&(mutex)->lock)
+#define dani_LockMutex(mutex) AcquireSRWLockExclusive(&(mutex)->lock)
+#define dani_UnlockMutex(mutex) ReleaseSRWLockExclusive(&(mutex)->lock)
+
+#define dani_InitialiseRWLock(rwlock, name) InitializeSRWLock(&(rwlock)->lock)
+#define dani_LockRWLockExclusive(rwlock) AcquireSRWLockExclusive(&(rwlock)->lock)
+#define dani_UnlockRWLockExclusive(rwlock) ReleaseSRWLockExclusive(&(rwlock)->lock)
+#define dani_LockRWLockShared(rwlock) (AcquireSRWLockShared(&(rwlock)->lock), 0)
+#define dani_UnlockRWLockShared(rwlock, acquire_ticks) (Unused(acquire_ticks), ReleaseSRWLockShared(&(rwlock)->lock))
+
+#define dani_GetProfilerLockIndex(...) 0
+#define dani_RecordProfilingLockAcquire(...)
+#define dani_RecordProfilingLockHold(...)
+
+typedef u64 dani_profiler_stacks;
+#define dani_CaptureProfilingStacks(...)
+#define dani_WriteProfilingFoldedStacks(...)
+#define dani_WriteProfilingDiffFoldedStacks(...)
+
+#define dani_FlushProfilingTrace()
+
+#define dani_IncludeProfilingFunctions(...)
+#define dani_ExcludeProfilingFunctions(...)
+
 #endif // DANI_PROFILER_ENABLED
 #endif // __DANI_LIB_PROFILER_H
 
@@ -294,178 +813,823 @@ static void InitialiseOSProfilingMetrics(void) {
 
 static dani_profiler g_dani_profiler = {0};
 
-__DANI_PROFILER_DEF void dani_BeginProfiling(void) {
-    // Initialise profiling metrics if enabled
-#if DANI_PROFILER_PAGE_FAULTS
-    InitialiseOSProfilingMetrics();
-#endif // DANI_PROFILER_PAGE_FAULTS
+// Every thread has its own innermost zone, so a lock wait is charged to the zone of the thread that waited
+static ThreadLocal u32 g_dani_profiler_current_index = 0;
 
-    // Reset global profiler in case it has been used before
-    memset(&g_dani_profiler, 0, sizeof(g_dani_profiler));
+#if DANI_PROFILER_STACKS
+// The innermost node of the call stack tree is per thread as well, so the zones of one thread never become children of another thread's zones
+static ThreadLocal u32 g_dani_profiler_current_node_index = 0;
+#endif // DANI_PROFILER_STACKS
 
-    // Warmup profiler
-    ReadStartCPUTimer();
-    ReadStartCPUTimer();
-    ReadStartCPUTimer();
-    ReadEndCPUTimer();
+#if DANI_PROFILER_ENABLED
+// Skipped hit counters of the sampled zone call sites by zone index, they are only added to the zone on the next sample and have to be flushed at the end
+static u32 *g_dani_profiler_sampled_skipped_hits[DANI_PROFILER_ENTRIES_MAX];
+
+static void FlushProfilerSkippedHits(b32 is_counted) {
+    for (u32 index = 0; index < ArrayCount(g_dani_profiler_sampled_skipped_hits); index += 1) {
+        u32 *skipped_hit_count = g_dani_profiler_sampled_skipped_hits[index];
+        if (skipped_hit_count && *skipped_hit_count) {
+            if (is_counted) {
+                dani_profiler_entry *entry = &g_dani_profiler.entries[index];
+                entry->hit_counter += *skipped_hit_count;
+                entry->skipped_hit_counter += *skipped_hit_count;
+            }
+            *skipped_hit_count = 0;
+        }
+    }
+}
+#endif // DANI_PROFILER_ENABLED
 
-    // Start profiler
-#if DANI_PROFILER_PAGE_FAULTS
-    g_dani_profiler.start_page_faults = ReadOSPageFaultCount();
-#endif // DANI_PROFILER_PAGE_FAULTS
+#if DANI_PROFILER_ENABLED && DANI_PROFILER_TRACE
+// Worst case size of a chunk header: 1 byte chunk type + 10 bytes varint payload size
+#define DANI_PROFILER_TRACE_CHUNK_HEADER_MAX 11
+// Worst case size of an encoded event: 10 bytes varint index/type + 10 bytes varint delta ticks + 8 bytes counter value
+#define DANI_PROFILER_TRACE_ENCODED_EVENT_MAX 28
+#define DANI_PROFILER_TRACE_ENCODE_BUFFER_SIZE (DANI_PROFILER_TRACE_CHUNK_HEADER_MAX + 32 + (DANI_PROFILER_TRACE_BUFFER_EVENTS * DANI_PROFILER_TRACE_ENCODED_EVENT_MAX))
+
+#define DANI_PROFILER_TRACE_CHUNK_EVENTS 1
+#define DANI_PROFILER_TRACE_CHUNK_NAMES 2
+#define DANI_PROFILER_TRACE_CHUNK_INFO 3
+
+static dani_profiler_trace g_dani_profiler_trace = {0};
+static ThreadLocal dani_profiler_trace_buffer *g_dani_profiler_trace_buffer = 0;
+static ThreadLocal u32 g_dani_profiler_trace_generation = 0;
+static ThreadLocal u32 g_dani_profiler_trace_dropped_depth = 0; // Zones on this thread whose begin was dropped and that haven't ended yet
+static volatile s32 g_dani_profiler_trace_is_running = 0;
+
+static u8 *EncodeProfilerTraceVarint(u8 *at, u64 value) {
+    while (value >= 0x80) {
+        *at++ = (u8)(value | 0x80);
+        value >>= 7;
+    }
+    *at++ = (u8)value;
+    return (at);
+}
 
-    g_dani_profiler.start_ticks = ReadStartCPUTimer();
+static void WriteProfilerTraceBytes(const void *data, u64 size) {
+    DWORD written = 0;
+    WriteFile(g_dani_profiler_trace.file_handle, data, (DWORD)size, &written, 0);
+    g_dani_profiler_trace.written_byte_count += written;
 }
 
-__DANI_PROFILER_DEF void dani_EndProfiling(void) {
-    g_dani_profiler.end_ticks = ReadEndCPUTimer();
+// The payload must be located at encode_buffer + DANI_PROFILER_TRACE_CHUNK_HEADER_MAX so the chunk header can be placed right in front of it.
+static void WriteProfilerTraceChunk(u8 chunk_type, u8 *payload_end) {
+    u8 *payload = g_dani_profiler_trace.encode_buffer + DANI_PROFILER_TRACE_CHUNK_HEADER_MAX;
+    u64 payload_size = (u64)(payload_end - payload);
 
-#if DANI_PROFILER_PAGE_FAULTS
-    g_dani_profiler.end_page_faults = ReadOSPageFaultCount();
-#endif // DANI_PROFILER_PAGE_FAULTS
-}
+    u8 header[DANI_PROFILER_TRACE_CHUNK_HEADER_MAX];
+    header[0] = chunk_type;
+    u64 header_size = (u64)(EncodeProfilerTraceVarint(header + 1, payload_size) - header);
 
-static void PrintProfilingTimes(u64 elapsed_ticks, u64 cpu_frequency) {
-    f64 seconds = ((f64)elapsed_ticks / (f64)cpu_frequency);
-    if (seconds < 1.0) {
-        f64 milliseconds = seconds * 1000.0;
-        if (milliseconds < 1.0) {
-            f64 microseconds = milliseconds * 1000.0;
-            if (microseconds < 1.0) {
-                f64 nanoseconds = microseconds * 1000.0;
-                DANI_PROFILER_PRINTF("%0.4fs (%0.4fms, %0.4fus, %0.4fns)", seconds, milliseconds, microseconds, nanoseconds);
-            } else {
-                DANI_PROFILER_PRINTF("%0.4fs (%0.4fms, %0.4fus)", seconds, milliseconds, microseconds);
-            }
-        } else {
-            DANI_PROFILER_PRINTF("%0.4fs (%0.4fms)", seconds, milliseconds);
-        }
-    } else if (seconds >= 60.0) {
-        f64 minutes = (seconds / 60.0);
-        if (minutes >= 60.0) {
-            f64 hours = (minutes / 60.0);
-            DANI_PROFILER_PRINTF("%0.4fh", hours);
-        } else {
-            DANI_PROFILER_PRINTF("%0.4fmin", minutes);
-        }
-    } else {
-        DANI_PROFILER_PRINTF("%0.4fs", seconds);
-    }
+    u8 *chunk = payload - header_size;
+    memcpy(chunk, header, header_size);
+
+    WriteProfilerTraceBytes(chunk, header_size + payload_size);
 }
 
-static void PrintProfilingValueAsSIUnit(f64 value, const s8 *base_unit) {
-    s8 prefix;
+static void WriteProfilerTraceBuffer(dani_profiler_trace_buffer *buffer) {
+    if (buffer->event_count == 0) {
+        return;
+    }
 
-    if (value >= Tera(1)) { prefix = 'T'; value /= Tera(1); }
-    else if (value >= Giga(1)) { prefix = 'G'; value /= Giga(1); }
-    else if (value >= Mega(1)) { prefix = 'M'; value /= Mega(1); }
-    else if (value >= Kilo(1)) { prefix = 'k'; value /= Kilo(1); }
-    else { prefix = '\0'; }
+    u8 *at = g_dani_profiler_trace.encode_buffer + DANI_PROFILER_TRACE_CHUNK_HEADER_MAX;
+    at = EncodeProfilerTraceVarint(at, buffer->thread_id);
+    at = EncodeProfilerTraceVarint(at, buffer->event_count);
 
-    u64 int_value = (u64)value;
-    if ((f64)int_value == value) {
-        // No fractions
-        DANI_PROFILER_PRINTF("%llu%c%s", int_value, prefix, base_unit);
-    } else {
-        // Fractions
-        DANI_PROFILER_PRINTF("%0.2f%c%s", value, prefix, base_unit);
-    }
-}
+    u64 previous_ticks = buffer->events[0].ticks;
+    at = EncodeProfilerTraceVarint(at, previous_ticks);
 
-static void PrintProfilingByteCount(f64 byte_count) {
-    s8 *prefix;
+    for (u32 event_index = 0; event_index < buffer->event_count; event_index += 1) {
+        dani_profiler_trace_event *event = &buffer->events[event_index];
 
-    if (byte_count >= TiB(1)) { prefix = "TiB"; byte_count /= TiB(1); }
-    else if (byte_count >= GiB(1)) { prefix = "GiB"; byte_count /= GiB(1); }
-    else if (byte_count >= MiB(1)) { prefix = "MiB"; byte_count /= MiB(1); }
-    else if (byte_count >= KiB(1)) { prefix = "KiB"; byte_count /= KiB(1); }
-    else { prefix = "byte"; }
+        // Deltas are encoded as unsigned values. A tick count going backwards (e.g. a thread migrating to a core with a different TSC) simply wraps around and will be decoded correctly.
+        at = EncodeProfilerTraceVarint(at, ((u64)event->index << 2) | event->type);
+        at = EncodeProfilerTraceVarint(at, event->ticks - previous_ticks);
+        previous_ticks = event->ticks;
 
-    u64 int_value = (u64)byte_count;
-    if ((f64)int_value == byte_count) {
-        // No fractions
-        DANI_PROFILER_PRINTF("%llu%s", int_value, prefix);
-    } else {
-        // Fractions
-        DANI_PROFILER_PRINTF("%0.2f%s", byte_count, prefix);
+        if (event->type == DANI_PROFILER_TRACE_EVENT_COUNTER) {
+            memcpy(at, &event->value, sizeof(event->value));
+            at += sizeof(event->value);
+        }
     }
+
+    WriteProfilerTraceChunk(DANI_PROFILER_TRACE_CHUNK_EVENTS, at);
 }
 
-#if DANI_PROFILER_ENABLED
+static void DrainProfilerTraceBuffers(void) {
+    // The full list is a stack, reverse it so buffers of the same thread are written in the order they were filled
+    SLIST_ENTRY *list = InterlockedFlushSList(&g_dani_profiler_trace.full_buffers);
+    SLIST_ENTRY *ordered = 0;
+    while (list) {
+        SLIST_ENTRY *next = list->Next;
+        list->Next = ordered;
+        ordered = list;
+        list = next;
+    }
 
-static void PrintInclusiveAndExclusiveProfilingTimes(u64 elapsed_inclusive, u64 elapsed_exclusive, u64 elapsed_total, u64 cpu_frequency) {
-    f64 inclusive_percentage = ((f64)elapsed_inclusive / (f64)elapsed_total) * 100.0;
+    while (ordered) {
+        SLIST_ENTRY *next = ordered->Next;
 
-    if (elapsed_inclusive == elapsed_exclusive) {
-        DANI_PROFILER_PRINTF("Incl/Excl[%0.2f%%]: ", inclusive_percentage);
-        PrintProfilingTimes(elapsed_inclusive, cpu_frequency);
-    } else {
-        DANI_PROFILER_PRINTF("Incl[%0.2f%%]: ", inclusive_percentage);
-        PrintProfilingTimes(elapsed_inclusive, cpu_frequency);
+        dani_profiler_trace_buffer *buffer = (dani_profiler_trace_buffer *)ordered;
+        WriteProfilerTraceBuffer(buffer);
 
-        f64 exclusive_percentage = ((f64)elapsed_exclusive / (f64)elapsed_total) * 100.0;
+        buffer->event_count = 0;
+        InterlockedPushEntrySList(&g_dani_profiler_trace.free_buffers, &buffer->list_entry);
 
-        DANI_PROFILER_PRINTF(", Excl[%0.2f%%]: ", exclusive_percentage);
-        PrintProfilingTimes(elapsed_exclusive, cpu_frequency);
+        ordered = next;
     }
 }
 
-static void PrintProfilingBandwidth(f64 processed_bytes_count, u64 elapsed_inclusive, u64 cpu_frequency) {
-    f64 ticks_per_second = ((f64)elapsed_inclusive / (f64)cpu_frequency);
-    f64 bytes_per_second = (processed_bytes_count / ticks_per_second);
-
-    DANI_PROFILER_PRINTF(", Bandwidth[");
-    PrintProfilingByteCount(processed_bytes_count);
-    DANI_PROFILER_PRINTF("]: ");
-    PrintProfilingByteCount(bytes_per_second);
-    DANI_PROFILER_PRINTF("/s");
-}
+static DWORD WINAPI ProfilerTraceWriterThread(void *parameter) {
+    Unused(parameter);
 
-static void PrintInclusiveMinAndMaxProfilingTimes(u64 elapsed_min, u64 elapsed_max, u64 elapsed_total, u64 cpu_frequency) {
-    f64 percentage_min = ((f64)elapsed_min / (f64)elapsed_total) * 100.0;
+    for (;;) {
+        WaitForSingleObject(g_dani_profiler_trace.wake_event, 100);
 
-    DANI_PROFILER_PRINTF("Min[%0.2f%%]: ", percentage_min);
-    PrintProfilingTimes(elapsed_min, cpu_frequency);
+        // Read the stop flag before draining so buffers pushed before the stop request are never missed
+        b32 is_stopping = (b32)AtomicLoad32(&g_dani_profiler_trace.is_stopping, MEMORY_ORDER_ACQUIRE);
+        DrainProfilerTraceBuffers();
 
-    f64 percentage_max = ((f64)elapsed_max / (f64)elapsed_total) * 100.0;
+        if (is_stopping) {
+            break;
+        }
+    }
 
-    DANI_PROFILER_PRINTF(", Max[%0.2f%%]: ", percentage_max);
-    PrintProfilingTimes(elapsed_max, cpu_frequency);
+    return (0);
 }
 
-static volatile s32 g_dani_profiler_entry_index_conter = 0;
-
-__DANI_PROFILER_DEF u32 dani_GetNextProfilerZoneIndex(void) {
-    u32 result = (u32)_InterlockedIncrement((volatile long *)&g_dani_profiler_entry_index_conter);
-    Assert(result != 0 && result < DANI_PROFILER_ENTRIES_MAX);
-    return (result);
+static void PushFullProfilerTraceBuffer(dani_profiler_trace_buffer *buffer) {
+    InterlockedPushEntrySList(&g_dani_profiler_trace.full_buffers, &buffer->list_entry);
+    SetEvent(g_dani_profiler_trace.wake_event);
 }
 
-__DANI_PROFILER_DEF dani_profiler_zone dani_BeginProfilingZone(const s8 *name, u32 index, u64 byte_count) {
-    dani_profiler_zone result = {0};
+static dani_profiler_trace_buffer *SwapProfilerTraceBuffer(dani_profiler_trace_buffer *full_buffer) {
+    if (g_dani_profiler_trace_is_running == 0) {
+        return (0);
+    }
 
-    result.name = name;
+    dani_profiler_trace_buffer *result = (dani_profiler_trace_buffer *)InterlockedPopEntrySList(&g_dani_profiler_trace.free_buffers);
+    if (result == 0 && g_dani_profiler_trace.buffer_count < DANI_PROFILER_TRACE_BUFFERS_MAX) {
+        s32 buffer_count = AtomicIncrement32(&g_dani_profiler_trace.buffer_count);
+        if (buffer_count <= DANI_PROFILER_TRACE_BUFFERS_MAX) {
+            result = (dani_profiler_trace_buffer *)VirtualAlloc(0, sizeof(dani_profiler_trace_buffer), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            g_dani_profiler_trace.buffers[buffer_count - 1] = result;
+        }
+    }
 
-    dani_profiler_entry *entry = &g_dani_profiler.entries[index];
-    entry->processed_bytes_counter += byte_count;
-    result.inclusive_ticks = entry->inclusive_ticks;
+    // If no buffer is available the thread keeps its full buffer and tries again on the next event
+    if (result) {
+        g_dani_profiler_trace_generation = g_dani_profiler_trace.generation;
+        result->thread_id = GetCurrentThreadId();
+        result->event_count = 0;
 
-    result.entry_index = index;
-    result.parent_index = g_dani_profiler.current_index;
+        if (full_buffer) {
+            PushFullProfilerTraceBuffer(full_buffer);
+        }
 
-    g_dani_profiler.current_index = index;
-    
-#if DANI_PROFILER_PAGE_FAULTS
-    result.start_page_faults = ReadOSPageFaultCount();
-#endif // DANI_PROFILER_PAGE_FAULTS
+        g_dani_profiler_trace_buffer = result;
+    }
 
-    result.start_ticks = ReadStartCPUTimer();
     return (result);
 }
 
-__DANI_PROFILER_DEF void dani_EndProfilingZone(dani_profiler_zone zone) {
-    u64 end_ticks = ReadEndCPUTimer();
-    u64 elapsed_ticks = end_ticks - zone.start_ticks;
+static dani_profiler_trace_event *PushProfilerTraceEvent(u32 type, u32 index) {
+    // The buffer of an earlier trace went back to the free list when the current trace started
+    if (g_dani_profiler_trace_generation != g_dani_profiler_trace.generation) {
+        g_dani_profiler_trace_buffer = 0;
+        g_dani_profiler_trace_generation = g_dani_profiler_trace.generation;
+        g_dani_profiler_trace_dropped_depth = 0;
+    }
+
+    // Once a begin is dropped every zone event up to its end is dropped as well, so every end in the trace has its begin
+    if (g_dani_profiler_trace_dropped_depth && type != DANI_PROFILER_TRACE_EVENT_COUNTER) {
+        if (type == DANI_PROFILER_TRACE_EVENT_BEGIN) {
+            g_dani_profiler_trace_dropped_depth += 1;
+        } else {
+            g_dani_profiler_trace_dropped_depth -= 1;
+        }
+        AtomicIncrement32(&g_dani_profiler_trace.dropped_event_count);
+        return (0);
+    }
+
+    dani_profiler_trace_buffer *buffer = g_dani_profiler_trace_buffer;
+    if (buffer == 0 || buffer->event_count == DANI_PROFILER_TRACE_BUFFER_EVENTS) {
+        buffer = SwapProfilerTraceBuffer(buffer);
+        if (buffer == 0) {
+            if (type == DANI_PROFILER_TRACE_EVENT_BEGIN) {
+                g_dani_profiler_trace_dropped_depth = 1;
+            }
+            AtomicIncrement32(&g_dani_profiler_trace.dropped_event_count);
+            return (0);
+        }
+    }
+
+    dani_profiler_trace_event *result = &buffer->events[buffer->event_count];
+    buffer->event_count += 1;
+
+    result->type = type;
+    result->index = index;
+    return (result);
+}
+
+__DANI_PROFILER_DEF void dani_FlushProfilingTrace(void) {
+    dani_profiler_trace_buffer *buffer = g_dani_profiler_trace_buffer;
+    if (buffer && buffer->event_count && g_dani_profiler_trace_is_running && g_dani_profiler_trace_generation == g_dani_profiler_trace.generation) {
+        g_dani_profiler_trace_buffer = 0;
+        PushFullProfilerTraceBuffer(buffer);
+    }
+}
+
+static u8 *EncodeProfilerTraceName(u8 *at, u32 kind, u32 index, const s8 *name) {
+    if (name == 0) {
+        return (at);
+    }
+
+    u64 name_length = 0;
+    while (name[name_length]) {
+        name_length += 1;
+    }
+
+    // Names are written in multiple chunks if they don't fit into the encode buffer
+    u8 *payload = g_dani_profiler_trace.encode_buffer + DANI_PROFILER_TRACE_CHUNK_HEADER_MAX;
+    u8 *encode_buffer_end = g_dani_profiler_trace.encode_buffer + DANI_PROFILER_TRACE_ENCODE_BUFFER_SIZE;
+    if ((u64)(encode_buffer_end - at) < name_length + 32) {
+        WriteProfilerTraceChunk(DANI_PROFILER_TRACE_CHUNK_NAMES, at);
+        at = payload;
+    }
+
+    at = EncodeProfilerTraceVarint(at, kind);
+    at = EncodeProfilerTraceVarint(at, index);
+    at = EncodeProfilerTraceVarint(at, name_length);
+    memcpy(at, name, name_length);
+    at += name_length;
+
+    return (at);
+}
+
+static void StartProfilerTrace(void) {
+    InitializeSListHead(&g_dani_profiler_trace.free_buffers);
+    InitializeSListHead(&g_dani_profiler_trace.full_buffers);
+
+    // Buffers of an earlier trace are empty after it stopped and are reused. Threads drop the one they still hold when they see the new generation.
+    g_dani_profiler_trace.generation += 1;
+    s32 buffer_count = Min(g_dani_profiler_trace.buffer_count, DANI_PROFILER_TRACE_BUFFERS_MAX);
+    for (s32 buffer_index = 0; buffer_index < buffer_count; buffer_index += 1) {
+        dani_profiler_trace_buffer *buffer = g_dani_profiler_trace.buffers[buffer_index];
+        if (buffer) {
+            buffer->event_count = 0;
+            InterlockedPushEntrySList(&g_dani_profiler_trace.free_buffers, &buffer->list_entry);
+        }
+    }
+
+    void *file_handle = CreateFileA(DANI_PROFILER_TRACE_FILE, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    g_dani_profiler_trace.file_handle = file_handle;
+    g_dani_profiler_trace.written_byte_count = 0;
+    g_dani_profiler_trace.dropped_event_count = 0;
+    g_dani_profiler_trace.is_stopping = 0;
+
+    if (g_dani_profiler_trace.encode_buffer == 0) {
+        g_dani_profiler_trace.encode_buffer = (u8 *)VirtualAlloc(0, DANI_PROFILER_TRACE_ENCODE_BUFFER_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+
+    // File header: 8 byte magic followed by a 4 byte little endian version
+    u8 file_header[12] = { 'D', 'A', 'N', 'I', 'T', 'R', 'C', 'E', 1, 0, 0, 0 };
+    WriteProfilerTraceBytes(file_header, sizeof(file_header));
+
+    g_dani_profiler_trace.wake_event = CreateEventA(0, FALSE, FALSE, 0);
+    g_dani_profiler_trace.thread_handle = CreateThread(0, 0, ProfilerTraceWriterThread, 0, 0, 0);
+
+    g_dani_profiler_trace_is_running = 1;
+}
+
+static void StopProfilerTrace(u64 cpu_frequency) {
+    if (g_dani_profiler_trace_is_running == 0) {
+        return;
+    }
+
+    g_dani_profiler_trace_is_running = 0;
+
+    AtomicExchange32(&g_dani_profiler_trace.is_stopping, 1, MEMORY_ORDER_SEQ_CST);
+    SetEvent(g_dani_profiler_trace.wake_event);
+    WaitForSingleObject(g_dani_profiler_trace.thread_handle, INFINITE);
+
+    CloseHandle(g_dani_profiler_trace.thread_handle);
+    CloseHandle(g_dani_profiler_trace.wake_event);
+
+    // The writer thread is gone and has written all full buffers. Every thread still holds its partially filled buffer, write those as well.
+    // Free buffers are always empty, so they are skipped.
+    s32 buffer_count = Min(g_dani_profiler_trace.buffer_count, DANI_PROFILER_TRACE_BUFFERS_MAX);
+    for (s32 buffer_index = 0; buffer_index < buffer_count; buffer_index += 1) {
+        dani_profiler_trace_buffer *buffer = g_dani_profiler_trace.buffers[buffer_index];
+        if (buffer) {
+            WriteProfilerTraceBuffer(buffer);
+            buffer->event_count = 0;
+        }
+    }
+
+    // The encode buffer can now be used to write the names and info chunks
+    u8 *at = g_dani_profiler_trace.encode_buffer + DANI_PROFILER_TRACE_CHUNK_HEADER_MAX;
+    for (u32 entry_index = 0; entry_index < ArrayCount(g_dani_profiler.entries); entry_index += 1) {
+        at = EncodeProfilerTraceName(at, 0, entry_index, g_dani_profiler.entries[entry_index].name);
+    }
+    for (u32 counter_index = 0; counter_index < ArrayCount(g_dani_profiler.counters); counter_index += 1) {
+        at = EncodeProfilerTraceName(at, 1, counter_index, g_dani_profiler.counters[counter_index].name);
+    }
+    WriteProfilerTraceChunk(DANI_PROFILER_TRACE_CHUNK_NAMES, at);
+
+    at = g_dani_profiler_trace.encode_buffer + DANI_PROFILER_TRACE_CHUNK_HEADER_MAX;
+    at = EncodeProfilerTraceVarint(at, cpu_frequency);
+    at = EncodeProfilerTraceVarint(at, g_dani_profiler.start_ticks);
+    at = EncodeProfilerTraceVarint(at, g_dani_profiler.end_ticks);
+    at = EncodeProfilerTraceVarint(at, (u64)g_dani_profiler_trace.dropped_event_count);
+    WriteProfilerTraceChunk(DANI_PROFILER_TRACE_CHUNK_INFO, at);
+
+    CloseHandle(g_dani_profiler_trace.file_handle);
+    g_dani_profiler_trace.file_handle = 0;
+}
+#endif // DANI_PROFILER_ENABLED && DANI_PROFILER_TRACE
+
+#if DANI_PROFILER_ENABLED && DANI_PROFILER_RUNTIME_TOGGLE
+__DANI_PROFILER_DEF volatile b32 g_dani_profiler_is_active = DANI_PROFILER_INITIALLY_ACTIVE;
+
+__DANI_PROFILER_DEF void dani_SetProfilingActive(b32 is_active) {
+    g_dani_profiler_is_active = is_active;
+}
+
+#if DANI_PROFILER_TOGGLE_ON_CTRL_BREAK
+static BOOL WINAPI ProfilerConsoleCtrlHandler(DWORD ctrl_type) {
+    // The handler runs on its own thread, flipping the flag is all that is safe to do here
+    if (ctrl_type == CTRL_BREAK_EVENT) {
+        dani_SetProfilingActive(IsFalse(g_dani_profiler_is_active));
+        return (TRUE);
+    }
+
+    return (FALSE);
+}
+#endif // DANI_PROFILER_TOGGLE_ON_CTRL_BREAK
+#endif // DANI_PROFILER_ENABLED && DANI_PROFILER_RUNTIME_TOGGLE
+
+__DANI_PROFILER_DEF void dani_BeginProfiling(void) {
+    // Initialise profiling metrics if enabled
+#if DANI_PROFILER_PAGE_FAULTS
+    InitialiseOSProfilingMetrics();
+#endif // DANI_PROFILER_PAGE_FAULTS
+
+    // Reset global profiler in case it has been used before
+    memset(&g_dani_profiler, 0, sizeof(g_dani_profiler));
+
+#if DANI_PROFILER_ENABLED
+    // Hits that were skipped before this run don't belong to it
+    FlushProfilerSkippedHits(B32_FALSE);
+#endif // DANI_PROFILER_ENABLED
+
+    // Warmup profiler
+    ReadStartCPUTimer();
+    ReadStartCPUTimer();
+    ReadStartCPUTimer();
+    ReadEndCPUTimer();
+
+#if DANI_PROFILER_ENABLED && DANI_PROFILER_TRACE
+    StartProfilerTrace();
+#endif // DANI_PROFILER_ENABLED && DANI_PROFILER_TRACE
+
+#if DANI_PROFILER_ENABLED && DANI_PROFILER_RUNTIME_TOGGLE && DANI_PROFILER_TOGGLE_ON_CTRL_BREAK
+    SetConsoleCtrlHandler(ProfilerConsoleCtrlHandler, TRUE);
+#endif // DANI_PROFILER_ENABLED && DANI_PROFILER_RUNTIME_TOGGLE && DANI_PROFILER_TOGGLE_ON_CTRL_BREAK
+
+    // Start profiler
+#if DANI_PROFILER_PAGE_FAULTS
+    g_dani_profiler.start_page_faults = ReadOSPageFaultCount();
+#endif // DANI_PROFILER_PAGE_FAULTS
+
+    g_dani_profiler.start_ticks = ReadStartCPUTimer();
+}
+
+__DANI_PROFILER_DEF void dani_EndProfiling(void) {
+    g_dani_profiler.end_ticks = ReadEndCPUTimer();
+
+#if DANI_PROFILER_ENABLED
+    FlushProfilerSkippedHits(B32_TRUE);
+#endif // DANI_PROFILER_ENABLED
+
+#if DANI_PROFILER_PAGE_FAULTS
+    g_dani_profiler.end_page_faults = ReadOSPageFaultCount();
+#endif // DANI_PROFILER_PAGE_FAULTS
+
+#if DANI_PROFILER_ENABLED && DANI_PROFILER_TRACE
+    StopProfilerTrace(ReadCPUTimerFrequency(100));
+#endif // DANI_PROFILER_ENABLED && DANI_PROFILER_TRACE
+}
+
+static void FormatProfilingTimes(dani_format_buffer *report, u64 elapsed_ticks, u64 cpu_frequency) {
+    f64 seconds = ((f64)elapsed_ticks / (f64)cpu_frequency);
+    if (seconds < 1.0) {
+        f64 milliseconds = seconds * 1000.0;
+        if (milliseconds < 1.0) {
+            f64 microseconds = milliseconds * 1000.0;
+            if (microseconds < 1.0) {
+                f64 nanoseconds = microseconds * 1000.0;
+                dani_FormatPrint(report, "%0.4fs (%0.4fms, %0.4fus, %0.4fns)", seconds, milliseconds, microseconds, nanoseconds);
+            } else {
+                dani_FormatPrint(report, "%0.4fs (%0.4fms, %0.4fus)", seconds, milliseconds, microseconds);
+            }
+        } else {
+            dani_FormatPrint(report, "%0.4fs (%0.4fms)", seconds, milliseconds);
+        }
+    } else if (seconds >= 60.0) {
+        f64 minutes = (seconds / 60.0);
+        if (minutes >= 60.0) {
+            f64 hours = (minutes / 60.0);
+            dani_FormatPrint(report, "%0.4fh", hours);
+        } else {
+            dani_FormatPrint(report, "%0.4fmin", minutes);
+        }
+    } else {
+        dani_FormatPrint(report, "%0.4fs", seconds);
+    }
+}
+
+static void FlushProfilingReport(dani_format_buffer *report) {
+    DANI_PROFILER_WRITE(report->data, report->length);
+}
+
+// Prints a single value with one write, for programs that print their own results next to the profiler
+static __inline void PrintProfilingValueAsSIUnit(f64 value, const s8 *base_unit) {
+    s8 text[64];
+    dani_format_buffer report;
+    dani_InitialiseFormatBuffer(&report, text, sizeof(text), FlushProfilingReport);
+    dani_FormatSIUnit(&report, value, base_unit);
+    dani_FlushFormatBuffer(&report);
+}
+
+#if DANI_PROFILER_ENABLED
+
+static void FormatInclusiveAndExclusiveProfilingTimes(dani_format_buffer *report, u64 elapsed_inclusive, u64 elapsed_exclusive, u64 elapsed_total, u64 cpu_frequency) {
+    f64 inclusive_percentage = ((f64)elapsed_inclusive / (f64)elapsed_total) * 100.0;
+
+    if (elapsed_inclusive == elapsed_exclusive) {
+        dani_FormatPrint(report, "Incl/Excl[%0.2f%%]: ", inclusive_percentage);
+        FormatProfilingTimes(report, elapsed_inclusive, cpu_frequency);
+    } else {
+        dani_FormatPrint(report, "Incl[%0.2f%%]: ", inclusive_percentage);
+        FormatProfilingTimes(report, elapsed_inclusive, cpu_frequency);
+
+        f64 exclusive_percentage = ((f64)elapsed_exclusive / (f64)elapsed_total) * 100.0;
+
+        dani_FormatPrint(report, ", Excl[%0.2f%%]: ", exclusive_percentage);
+        FormatProfilingTimes(report, elapsed_exclusive, cpu_frequency);
+    }
+}
+
+static f64 g_dani_profiler_peak_read_bandwidth = 0.0;
+static f64 g_dani_profiler_peak_write_bandwidth = 0.0;
+
+__DANI_PROFILER_DEF void dani_SetProfilingPeakBandwidth(f64 read_bytes_per_second, f64 write_bytes_per_second) {
+    g_dani_profiler_peak_read_bandwidth = read_bytes_per_second;
+    g_dani_profiler_peak_write_bandwidth = write_bytes_per_second;
+}
+
+static void FormatProfilingBandwidth(dani_format_buffer *report, const s8 *label, f64 processed_bytes_count, u64 elapsed_inclusive, u64 cpu_frequency, f64 peak_bytes_per_second) {
+    f64 ticks_per_second = ((f64)elapsed_inclusive / (f64)cpu_frequency);
+    f64 bytes_per_second = (processed_bytes_count / ticks_per_second);
+    f64 bytes_per_cycle = (processed_bytes_count / (f64)elapsed_inclusive);
+
+    dani_FormatPrint(report, ", %s[", label);
+    dani_FormatByteCount(report, processed_bytes_count);
+    dani_FormatPrint(report, "]: ");
+    dani_FormatByteCount(report, bytes_per_second);
+    dani_FormatPrint(report, "/s (%0.2fbyte/cycle", bytes_per_cycle);
+    if (peak_bytes_per_second > 0.0) {
+        dani_FormatPrint(report, ", %0.2f%% of peak", (bytes_per_second / peak_bytes_per_second) * 100.0);
+    }
+    dani_FormatPrint(report, ")");
+}
+
+static void FormatProfilingItemThroughput(dani_format_buffer *report, f64 processed_items_count, u64 elapsed_inclusive, u64 cpu_frequency) {
+    f64 ticks_per_second = ((f64)elapsed_inclusive / (f64)cpu_frequency);
+    f64 items_per_second = (processed_items_count / ticks_per_second);
+    f64 items_per_cycle = (processed_items_count / (f64)elapsed_inclusive);
+
+    dani_FormatPrint(report, ", Items[");
+    dani_FormatSIUnit(report, processed_items_count, "");
+    dani_FormatPrint(report, "]: ");
+    dani_FormatSIUnit(report, items_per_second, "/s");
+    dani_FormatPrint(report, " (%0.4fitem/cycle)", items_per_cycle);
+}
+
+// Prints all throughput metrics of an entry. The counters are divided by hit_divisor to print averages.
+static void FormatProfilingEntryThroughput(dani_format_buffer *report, dani_profiler_entry *entry, f64 hit_divisor, u64 elapsed_inclusive, u64 cpu_frequency) {
+    if (entry->processed_bytes_counter) {
+        FormatProfilingBandwidth(report, "Bandwidth", (f64)entry->processed_bytes_counter / hit_divisor, elapsed_inclusive, cpu_frequency, g_dani_profiler_peak_read_bandwidth);
+    }
+    if (entry->read_bytes_counter) {
+        FormatProfilingBandwidth(report, "Read", (f64)entry->read_bytes_counter / hit_divisor, elapsed_inclusive, cpu_frequency, g_dani_profiler_peak_read_bandwidth);
+    }
+    if (entry->write_bytes_counter) {
+        FormatProfilingBandwidth(report, "Write", (f64)entry->write_bytes_counter / hit_divisor, elapsed_inclusive, cpu_frequency, g_dani_profiler_peak_write_bandwidth);
+    }
+    if (entry->processed_items_counter) {
+        FormatProfilingItemThroughput(report, (f64)entry->processed_items_counter / hit_divisor, elapsed_inclusive, cpu_frequency);
+    }
+}
+
+#if DANI_PROFILER_MIN_MAX
+static void FormatInclusiveMinAndMaxProfilingTimes(dani_format_buffer *report, u64 elapsed_min, u64 elapsed_max, u64 elapsed_total, u64 cpu_frequency) {
+    f64 percentage_min = ((f64)elapsed_min / (f64)elapsed_total) * 100.0;
+
+    dani_FormatPrint(report, "Min[%0.2f%%]: ", percentage_min);
+    FormatProfilingTimes(report, elapsed_min, cpu_frequency);
+
+    f64 percentage_max = ((f64)elapsed_max / (f64)elapsed_total) * 100.0;
+
+    dani_FormatPrint(report, ", Max[%0.2f%%]: ", percentage_max);
+    FormatProfilingTimes(report, elapsed_max, cpu_frequency);
+}
+#endif // DANI_PROFILER_MIN_MAX
+
+#if DANI_PROFILER_VARIANCE
+static void FormatProfilingDeviation(dani_format_buffer *report, dani_profiler_entry *entry, u64 cpu_frequency) {
+    // Sample standard deviation, so at least two samples are required
+    if (entry->variance_sample_counter > 1) {
+        f64 stddev_ticks = sqrt(entry->inclusive_ticks_m2 / (f64)(entry->variance_sample_counter - 1));
+        f64 cv_percentage = (entry->inclusive_ticks_mean > 0.0) ? (stddev_ticks / entry->inclusive_ticks_mean) * 100.0 : 0.0;
+
+        dani_FormatPrint(report, "\n    Deviation - Incl: ");
+        FormatProfilingTimes(report, (u64)stddev_ticks, cpu_frequency);
+        dani_FormatPrint(report, " (CV %0.2f%%)", cv_percentage);
+
+        if (entry->bandwidth_sample_counter > 1) {
+            f64 stddev_bytes_per_tick = sqrt(entry->bandwidth_m2 / (f64)(entry->bandwidth_sample_counter - 1));
+            f64 bandwidth_cv_percentage = (entry->bandwidth_mean > 0.0) ? (stddev_bytes_per_tick / entry->bandwidth_mean) * 100.0 : 0.0;
+
+            dani_FormatPrint(report, ", Bandwidth: ");
+            dani_FormatByteCount(report, stddev_bytes_per_tick * (f64)cpu_frequency);
+            dani_FormatPrint(report, "/s (CV %0.2f%%)", bandwidth_cv_percentage);
+        }
+    }
+}
+#endif // DANI_PROFILER_VARIANCE
+
+static volatile s32 g_dani_profiler_entry_index_conter = 0;
+
+__DANI_PROFILER_DEF u32 dani_GetNextProfilerZoneIndex(void) {
+    u32 result = (u32)AtomicIncrement32(&g_dani_profiler_entry_index_conter);
+    Assert(result != 0 && result < DANI_PROFILER_ENTRIES_MAX);
+    return (result);
+}
+
+static b32 IsProfilerNameEqual(const s8 *a, const s8 *b) {
+    while (*a && (*a == *b)) {
+        a += 1;
+        b += 1;
+    }
+
+    b32 result = (*a == *b);
+    return (result);
+}
+
+#if DANI_PROFILER_STACKS
+static u32 GetProfilerStackNode(u32 parent_node_index, u32 entry_index) {
+    dani_profiler_stack_node *parent = &g_dani_profiler.stack_nodes[parent_node_index];
+
+    u32 previous_node_index = 0;
+    u32 node_index = parent->first_child_node_index;
+    while (node_index) {
+        dani_profiler_stack_node *node = &g_dani_profiler.stack_nodes[node_index];
+        if (node->entry_index == entry_index) {
+            // Move the node to the front so hot paths are found right away next time
+            if (previous_node_index) {
+                g_dani_profiler.stack_nodes[previous_node_index].next_sibling_node_index = node->next_sibling_node_index;
+                node->next_sibling_node_index = parent->first_child_node_index;
+                parent->first_child_node_index = node_index;
+            }
+            return (node_index);
+        }
+
+        previous_node_index = node_index;
+        node_index = node->next_sibling_node_index;
+    }
+
+    // Node 0 is the root node, so the first node to hand out is 1
+    if (g_dani_profiler.stack_node_count == 0) {
+        g_dani_profiler.stack_node_count = 1;
+    }
+
+    // Attribute the zone to its parent if there are no nodes left
+    if (g_dani_profiler.stack_node_count >= DANI_PROFILER_STACK_NODES_MAX) {
+        return (parent_node_index);
+    }
+
+    u32 result = g_dani_profiler.stack_node_count;
+    g_dani_profiler.stack_node_count += 1;
+
+    dani_profiler_stack_node *node = &g_dani_profiler.stack_nodes[result];
+    node->entry_index = entry_index;
+    node->parent_node_index = parent_node_index;
+    node->next_sibling_node_index = parent->first_child_node_index;
+    parent->first_child_node_index = result;
+
+    return (result);
+}
+#endif // DANI_PROFILER_STACKS
+
+__DANI_PROFILER_DEF dani_profiler_zone dani_BeginProfilingZone(const s8 *name, u32 index, u64 byte_count) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    if (IsFalse(g_dani_profiler_is_active)) {
+        dani_profiler_zone inactive_zone = {0};
+        return (inactive_zone);
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    dani_profiler_zone result = {0};
+
+    result.name = name;
+
+    dani_profiler_entry *entry = &g_dani_profiler.entries[index];
+    entry->processed_bytes_counter += byte_count;
+    result.inclusive_ticks = entry->inclusive_ticks;
+
+    result.entry_index = index;
+    result.parent_index = g_dani_profiler_current_index;
+
+#if DANI_PROFILER_OUTLIERS || DANI_PROFILER_VARIANCE
+    result.byte_count = byte_count;
+#endif // DANI_PROFILER_OUTLIERS || DANI_PROFILER_VARIANCE
+
+    g_dani_profiler_current_index = index;
+
+#if DANI_PROFILER_STACKS
+    result.parent_node_index = g_dani_profiler_current_node_index;
+    result.node_index = GetProfilerStackNode(result.parent_node_index, index);
+    g_dani_profiler_current_node_index = result.node_index;
+#endif // DANI_PROFILER_STACKS
+    
+#if DANI_PROFILER_PAGE_FAULTS
+    result.start_page_faults = ReadOSPageFaultCount();
+#endif // DANI_PROFILER_PAGE_FAULTS
+
+#if DANI_PROFILER_TRACE
+    // Reserve the trace event before reading the timer so pushing it is not part of the zone
+    dani_profiler_trace_event *trace_event = PushProfilerTraceEvent(DANI_PROFILER_TRACE_EVENT_BEGIN, index);
+#endif // DANI_PROFILER_TRACE
+
+    result.start_ticks = ReadStartCPUTimer();
+
+#if DANI_PROFILER_TRACE
+    if (trace_event) {
+        trace_event->ticks = result.start_ticks;
+    }
+#endif // DANI_PROFILER_TRACE
+
+    return (result);
+}
+
+__DANI_PROFILER_DEF dani_profiler_zone dani_BeginProfilingZoneSampled(const s8 *name, u32 index, u32 skipped_hit_count) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    if (IsFalse(g_dani_profiler_is_active)) {
+        dani_profiler_zone inactive_zone = {0};
+        return (inactive_zone);
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    // Account for all invocations that were skipped since the last sample
+    dani_profiler_entry *entry = &g_dani_profiler.entries[index];
+    entry->hit_counter += skipped_hit_count;
+    entry->skipped_hit_counter += skipped_hit_count;
+
+    dani_profiler_zone result = dani_BeginProfilingZone(name, index, 0);
+    return (result);
+}
+
+__DANI_PROFILER_DEF u32 dani_GetNextProfilerSampledZoneIndex(u32 *skipped_hit_count) {
+    u32 result = dani_GetNextProfilerZoneIndex();
+    g_dani_profiler_sampled_skipped_hits[result] = skipped_hit_count;
+    return (result);
+}
+
+static u32 g_dani_profiler_sample_random_state = 0x2545F491;
+
+__DANI_PROFILER_DEF u32 dani_GetNextProfilerSampleInterval(u32 sample_rate) {
+    Assert(sample_rate >= 1);
+
+    // xorshift32
+    u32 x = g_dani_profiler_sample_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_dani_profiler_sample_random_state = x;
+
+    // Uniformly distributed in [0, 2 * (sample_rate - 1)], so the average interval between two samples is sample_rate
+    u32 result = 0;
+    if (sample_rate > 1) {
+        result = x % ((2 * (sample_rate - 1)) + 1);
+    }
+
+    return (result);
+}
+
+__DANI_PROFILER_DEF dani_profiler_zone dani_BeginProfilingZoneTagged(const s8 *name, u32 index, u64 byte_count, u64 tag) {
+    dani_profiler_zone result = dani_BeginProfilingZone(name, index, byte_count);
+
+#if DANI_PROFILER_OUTLIERS
+    result.tag = tag;
+#else
+    Unused(tag);
+#endif // DANI_PROFILER_OUTLIERS
+
+    return (result);
+}
+
+#if DANI_PROFILER_OUTLIERS
+static void RecordProfilerOutlier(dani_profiler_entry *entry, dani_profiler_outlier *outlier) {
+    dani_profiler_outlier *heap = entry->outliers;
+    u32 index;
+
+    if (entry->outlier_count < DANI_PROFILER_OUTLIERS_MAX) {
+        // Sift up
+        index = entry->outlier_count;
+        entry->outlier_count += 1;
+
+        while (index > 0) {
+            u32 parent_index = (index - 1) / 2;
+            if (heap[parent_index].inclusive_ticks <= outlier->inclusive_ticks) {
+                break;
+            }
+            heap[index] = heap[parent_index];
+            index = parent_index;
+        }
+    } else {
+        // Replace the fastest outlier and sift down
+        index = 0;
+
+        for (;;) {
+            u32 child_index = (index * 2) + 1;
+            if (child_index >= DANI_PROFILER_OUTLIERS_MAX) {
+                break;
+            }
+            if (child_index + 1 < DANI_PROFILER_OUTLIERS_MAX && heap[child_index + 1].inclusive_ticks < heap[child_index].inclusive_ticks) {
+                child_index += 1;
+            }
+            if (outlier->inclusive_ticks <= heap[child_index].inclusive_ticks) {
+                break;
+            }
+            heap[index] = heap[child_index];
+            index = child_index;
+        }
+    }
+
+    heap[index] = *outlier;
+}
+#endif // DANI_PROFILER_OUTLIERS
+
+__DANI_PROFILER_DEF dani_profiler_zone dani_BeginProfilingZoneEx(const s8 *name, u32 index, u64 read_byte_count, u64 write_byte_count, u64 item_count) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    if (IsFalse(g_dani_profiler_is_active)) {
+        dani_profiler_zone inactive_zone = {0};
+        return (inactive_zone);
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    dani_profiler_entry *entry = &g_dani_profiler.entries[index];
+    entry->read_bytes_counter += read_byte_count;
+    entry->write_bytes_counter += write_byte_count;
+    entry->processed_items_counter += item_count;
+
+    dani_profiler_zone result = dani_BeginProfilingZone(name, index, read_byte_count + write_byte_count);
+    return (result);
+}
+
+#if DANI_PROFILER_VARIANCE
+// Welford's online algorithm. Numerically stable even for long runs where a naive sum of squares would lose all precision.
+static void UpdateProfilerVariance(u64 *sample_counter, f64 *mean, f64 *m2, f64 value) {
+    *sample_counter += 1;
+    f64 delta = value - *mean;
+    *mean += delta / (f64)*sample_counter;
+    *m2 += delta * (value - *mean);
+}
+#endif // DANI_PROFILER_VARIANCE
+
+__DANI_PROFILER_DEF void dani_EndProfilingZone(dani_profiler_zone zone) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    // The zone was started while the profiler was inactive
+    if (zone.start_ticks == 0) {
+        return;
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    u64 end_ticks = ReadEndCPUTimer();
+    u64 elapsed_ticks = end_ticks - zone.start_ticks;
+
+#if DANI_PROFILER_TRACE
+    dani_profiler_trace_event *trace_event = PushProfilerTraceEvent(DANI_PROFILER_TRACE_EVENT_END, zone.entry_index);
+    if (trace_event) {
+        trace_event->ticks = end_ticks;
+    }
+#endif // DANI_PROFILER_TRACE
 
     dani_profiler_entry *parent = &g_dani_profiler.entries[zone.parent_index];
     dani_profiler_entry *entry = &g_dani_profiler.entries[zone.entry_index];
@@ -495,70 +1659,771 @@ __DANI_PROFILER_DEF void dani_EndProfilingZone(dani_profiler_zone zone) {
     }
 #endif // DANI_PROFILER_MIN_MAX
 
+#if DANI_PROFILER_VARIANCE
+    UpdateProfilerVariance(&entry->variance_sample_counter, &entry->inclusive_ticks_mean, &entry->inclusive_ticks_m2, (f64)elapsed_ticks);
+    if (zone.byte_count && elapsed_ticks) {
+        f64 bytes_per_tick = ((f64)zone.byte_count / (f64)elapsed_ticks);
+        UpdateProfilerVariance(&entry->bandwidth_sample_counter, &entry->bandwidth_mean, &entry->bandwidth_m2, bytes_per_tick);
+    }
+#endif // DANI_PROFILER_VARIANCE
+
+#if DANI_PROFILER_OUTLIERS
+    // The common case is a regular invocation that is faster than all recorded outliers
+    if (entry->outlier_count < DANI_PROFILER_OUTLIERS_MAX || elapsed_ticks > entry->outliers[0].inclusive_ticks) {
+        dani_profiler_outlier outlier;
+        outlier.inclusive_ticks = elapsed_ticks;
+        outlier.start_ticks = zone.start_ticks;
+        outlier.byte_count = zone.byte_count;
+#if DANI_PROFILER_PAGE_FAULTS
+        outlier.page_fault_count = end_page_faults - zone.start_page_faults;
+#else
+        outlier.page_fault_count = 0;
+#endif // DANI_PROFILER_PAGE_FAULTS
+        outlier.tag = zone.tag;
+        outlier.thread_id = GetCurrentThreadId();
+
+        RecordProfilerOutlier(entry, &outlier);
+    }
+#endif // DANI_PROFILER_OUTLIERS
+
     entry->hit_counter += 1;
 
-    g_dani_profiler.current_index = zone.parent_index;
+    g_dani_profiler_current_index = zone.parent_index;
+
+#if DANI_PROFILER_STACKS
+    g_dani_profiler.stack_nodes[zone.parent_node_index].exclusive_ticks -= elapsed_ticks;
+    g_dani_profiler.stack_nodes[zone.node_index].exclusive_ticks += elapsed_ticks;
+    g_dani_profiler_current_node_index = zone.parent_node_index;
+#endif // DANI_PROFILER_STACKS
+}
+
+// Counter indices are cached at the call sites, so the registered names have to outlive the reset in dani_BeginProfiling
+static volatile s32 g_dani_profiler_counter_index_counter = 0;
+static const s8 *g_dani_profiler_counter_names[DANI_PROFILER_COUNTERS_MAX];
+
+__DANI_PROFILER_DEF u32 dani_GetProfilerCounterIndex(const s8 *name) {
+    // Counters are shared by name, so look for an already registered one first
+    u32 counter_count = (u32)g_dani_profiler_counter_index_counter;
+    for (u32 counter_index = 1; counter_index <= counter_count; counter_index += 1) {
+        const s8 *counter_name = g_dani_profiler_counter_names[counter_index];
+        if (counter_name && IsProfilerNameEqual(counter_name, name)) {
+            return (counter_index);
+        }
+    }
+
+    u32 result = (u32)AtomicIncrement32(&g_dani_profiler_counter_index_counter);
+    Assert(result != 0 && result < DANI_PROFILER_COUNTERS_MAX);
+
+    g_dani_profiler_counter_names[result] = name;
+    return (result);
+}
+
+__DANI_PROFILER_DEF void dani_SetProfilingCounter(u32 index, f64 value) {
+    dani_profiler_counter *counter = &g_dani_profiler.counters[index];
+
+    if (counter->sample_counter == 0) {
+        counter->name = g_dani_profiler_counter_names[index];
+        counter->min_value = value;
+        counter->max_value = value;
+    } else {
+        if (value < counter->min_value) {
+            counter->min_value = value;
+        }
+        if (value > counter->max_value) {
+            counter->max_value = value;
+        }
+    }
+
+    counter->last_value = value;
+    counter->sum_value += value;
+    counter->sample_counter += 1;
+
+#if DANI_PROFILER_TRACE
+    dani_profiler_trace_event *trace_event = PushProfilerTraceEvent(DANI_PROFILER_TRACE_EVENT_COUNTER, index);
+    if (trace_event) {
+        trace_event->ticks = __rdtsc();
+        trace_event->value = value;
+    }
+#endif // DANI_PROFILER_TRACE
+}
+
+__DANI_PROFILER_DEF void dani_AddProfilingCounter(u32 index, f64 delta) {
+    f64 value = g_dani_profiler.counters[index].last_value + delta;
+    dani_SetProfilingCounter(index, value);
+}
+
+#if DANI_PROFILER_INSTRUMENT_FUNCTIONS
+#if defined(__GNUC__) || defined(__clang__)
+#define __DANI_PROFILER_NO_INSTRUMENT __attribute__((no_instrument_function))
+#else
+#define __DANI_PROFILER_NO_INSTRUMENT
+#endif
+
+// Entry index of a function that has been filtered out or didn't get an entry anymore
+#define DANI_PROFILER_FUNCTION_EXCLUDED 0xFFFFFFFF
+
+typedef struct __DANI_PROFILER_FUNCTION dani_profiler_function;
+struct __DANI_PROFILER_FUNCTION {
+    volatile s64 address; // 0 if the slot is empty
+    volatile s32 entry_index; // 0 while the function is being registered
+    s8 name[DANI_PROFILER_FUNCTION_NAME_LENGTH];
+};
+
+static dani_profiler_function g_dani_profiler_functions[DANI_PROFILER_FUNCTIONS_MAX];
+
+static const s8 *g_dani_profiler_function_filters[DANI_PROFILER_FUNCTION_FILTERS_MAX];
+static b32 g_dani_profiler_function_filter_is_include[DANI_PROFILER_FUNCTION_FILTERS_MAX];
+static u32 g_dani_profiler_function_filter_count = 0;
+static u32 g_dani_profiler_function_include_filter_count = 0;
+
+// DbgHelp is single threaded
+static SRWLOCK g_dani_profiler_symbol_lock = SRWLOCK_INIT;
+static b32 g_dani_profiler_symbols_are_initialised = B32_FALSE;
+
+static ThreadLocal dani_profiler_zone g_dani_profiler_function_zones[DANI_PROFILER_FUNCTION_STACK_DEPTH_MAX];
+static ThreadLocal u32 g_dani_profiler_function_depth = 0;
+static ThreadLocal b32 g_dani_profiler_function_is_in_hook = B32_FALSE;
+
+static void AddProfilingFunctionFilter(const s8 *name_prefix, b32 is_include) {
+    Assert(g_dani_profiler_function_filter_count < DANI_PROFILER_FUNCTION_FILTERS_MAX);
+
+    g_dani_profiler_function_filters[g_dani_profiler_function_filter_count] = name_prefix;
+    g_dani_profiler_function_filter_is_include[g_dani_profiler_function_filter_count] = is_include;
+    g_dani_profiler_function_filter_count += 1;
+
+    if (is_include) {
+        g_dani_profiler_function_include_filter_count += 1;
+    }
+}
+
+__DANI_PROFILER_DEF void dani_IncludeProfilingFunctions(const s8 *name_prefix) {
+    AddProfilingFunctionFilter(name_prefix, B32_TRUE);
+}
+
+__DANI_PROFILER_DEF void dani_ExcludeProfilingFunctions(const s8 *name_prefix) {
+    AddProfilingFunctionFilter(name_prefix, B32_FALSE);
+}
+
+__DANI_PROFILER_NO_INSTRUMENT static void ResolveProfilerFunctionName(dani_profiler_function *function) {
+    if (function->name[0]) {
+        return;
+    }
+
+    AcquireSRWLockExclusive(&g_dani_profiler_symbol_lock);
+
+    if (IsFalse(g_dani_profiler_symbols_are_initialised)) {
+        SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+        SymInitialize(GetCurrentProcess(), 0, TRUE);
+        g_dani_profiler_symbols_are_initialised = B32_TRUE;
+    }
+
+    union {
+        SYMBOL_INFO info;
+        u8 buffer[sizeof(SYMBOL_INFO) + DANI_PROFILER_FUNCTION_NAME_LENGTH];
+    } symbol = {0};
+    symbol.info.SizeOfStruct = sizeof(SYMBOL_INFO);
+    symbol.info.MaxNameLen = DANI_PROFILER_FUNCTION_NAME_LENGTH;
+
+    if (SymFromAddr(GetCurrentProcess(), (u64)function->address, 0, &symbol.info)) {
+        u32 name_length = Min(symbol.info.NameLen, DANI_PROFILER_FUNCTION_NAME_LENGTH - 1);
+        memcpy(function->name, symbol.info.Name, name_length);
+        function->name[name_length] = '\0';
+    } else {
+        snprintf(function->name, sizeof(function->name), "0x%llx", (u64)function->address);
+    }
+
+    ReleaseSRWLockExclusive(&g_dani_profiler_symbol_lock);
+}
+
+// Resolves the names of all registered functions. Without filters the names are only needed for the results, so this is deferred until then.
+__DANI_PROFILER_NO_INSTRUMENT static void ResolveProfilerFunctionNames(void) {
+    for (u32 function_index = 0; function_index < DANI_PROFILER_FUNCTIONS_MAX; function_index += 1) {
+        dani_profiler_function *function = &g_dani_profiler_functions[function_index];
+        if (function->address && function->entry_index != 0 && (u32)function->entry_index != DANI_PROFILER_FUNCTION_EXCLUDED) {
+            ResolveProfilerFunctionName(function);
+        }
+    }
+}
+
+__DANI_PROFILER_NO_INSTRUMENT static b32 IsProfilerFunctionIncluded(dani_profiler_function *function) {
+    if (g_dani_profiler_function_filter_count == 0) {
+        return (B32_TRUE);
+    }
+
+    ResolveProfilerFunctionName(function);
+
+    b32 result = (g_dani_profiler_function_include_filter_count == 0);
+    for (u32 filter_index = 0; filter_index < g_dani_profiler_function_filter_count; filter_index += 1) {
+        const s8 *prefix = g_dani_profiler_function_filters[filter_index];
+        const s8 *name = function->name;
+        while (*prefix && (*prefix == *name)) {
+            prefix += 1;
+            name += 1;
+        }
+
+        if (*prefix == '\0') {
+            if (IsFalse(g_dani_profiler_function_filter_is_include[filter_index])) {
+                return (B32_FALSE);
+            }
+            result = B32_TRUE;
+        }
+    }
+
+    return (result);
+}
+
+// Lock free open addressing table from function address to profiler entry. Slots are claimed with a compare exchange and never removed.
+__DANI_PROFILER_NO_INSTRUMENT static dani_profiler_function *GetProfilerFunction(u64 address) {
+    u32 mask = DANI_PROFILER_FUNCTIONS_MAX - 1;
+    u32 slot_index = (u32)((address * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+    for (u32 probe_count = 0; probe_count < DANI_PROFILER_FUNCTIONS_MAX; probe_count += 1) {
+        dani_profiler_function *function = &g_dani_profiler_functions[slot_index];
+
+        s64 slot_address = AtomicLoad64(&function->address, MEMORY_ORDER_ACQUIRE);
+        if (slot_address == (s64)address) {
+            return (function);
+        }
+
+        if (slot_address == 0) {
+            s64 previous_address = AtomicCompareExchange64(&function->address, 0, (s64)address, MEMORY_ORDER_SEQ_CST);
+            if (previous_address == 0) {
+                // This thread owns the slot and has to register the function
+                u32 entry_index = DANI_PROFILER_FUNCTION_EXCLUDED;
+                if (IsProfilerFunctionIncluded(function)) {
+                    // Other threads register functions at the same time, so the index is only taken while it is still below the limit
+                    s32 counter = AtomicLoad32(&g_dani_profiler_entry_index_conter, MEMORY_ORDER_ACQUIRE);
+                    while ((u32)counter + 1 < DANI_PROFILER_ENTRIES_MAX) {
+                        s32 previous_counter = AtomicCompareExchange32(&g_dani_profiler_entry_index_conter, counter, counter + 1, MEMORY_ORDER_SEQ_CST);
+                        if (previous_counter == counter) {
+                            entry_index = (u32)counter + 1;
+                            break;
+                        }
+                        counter = previous_counter;
+                    }
+                }
+                AtomicExchange32(&function->entry_index, (s32)entry_index, MEMORY_ORDER_SEQ_CST);
+                return (function);
+            }
+
+            if (previous_address == (s64)address) {
+                return (function);
+            }
+        }
+
+        slot_index = (slot_index + 1) & mask;
+    }
+
+    // The table is full
+    return (0);
+}
+
+__DANI_PROFILER_NO_INSTRUMENT void __cyg_profile_func_enter(void *function_address, void *call_site) {
+    Unused(call_site);
+
+    if (g_dani_profiler_function_is_in_hook) {
+        return;
+    }
+    g_dani_profiler_function_is_in_hook = B32_TRUE;
+
+    u32 depth = g_dani_profiler_function_depth;
+    g_dani_profiler_function_depth = depth + 1;
+
+    if (depth < DANI_PROFILER_FUNCTION_STACK_DEPTH_MAX) {
+        dani_profiler_zone *zone = &g_dani_profiler_function_zones[depth];
+        zone->start_ticks = 0;
+
+        // Only record functions while the profiler is running
+        b32 is_running = (g_dani_profiler.start_ticks != 0 && g_dani_profiler.end_ticks == 0);
+        if (is_running && __DANI_PROFILER_IS_ACTIVE) {
+            dani_profiler_function *function = GetProfilerFunction((u64)function_address);
+
+            // Another thread may still be registering the function, skip this call in that case
+            u32 entry_index = function ? (u32)AtomicLoad32(&function->entry_index, MEMORY_ORDER_ACQUIRE) : 0;
+            if (entry_index != 0 && entry_index != DANI_PROFILER_FUNCTION_EXCLUDED) {
+                *zone = dani_BeginProfilingZone(function->name, entry_index, 0);
+            }
+        }
+    }
+
+    g_dani_profiler_function_is_in_hook = B32_FALSE;
+}
+
+__DANI_PROFILER_NO_INSTRUMENT void __cyg_profile_func_exit(void *function_address, void *call_site) {
+    Unused(function_address);
+    Unused(call_site);
+
+    if (g_dani_profiler_function_is_in_hook || g_dani_profiler_function_depth == 0) {
+        return;
+    }
+    g_dani_profiler_function_is_in_hook = B32_TRUE;
+
+    g_dani_profiler_function_depth -= 1;
+    u32 depth = g_dani_profiler_function_depth;
+
+    if (depth < DANI_PROFILER_FUNCTION_STACK_DEPTH_MAX) {
+        dani_profiler_zone zone = g_dani_profiler_function_zones[depth];
+        if (zone.start_ticks && g_dani_profiler.end_ticks == 0) {
+            dani_EndProfilingZone(zone);
+        }
+    }
+
+    g_dani_profiler_function_is_in_hook = B32_FALSE;
+}
+#endif // DANI_PROFILER_INSTRUMENT_FUNCTIONS
+
+#if DANI_PROFILER_STACKS
+__DANI_PROFILER_DEF void dani_CaptureProfilingStacks(dani_profiler_stacks *stacks) {
+#if DANI_PROFILER_INSTRUMENT_FUNCTIONS
+    ResolveProfilerFunctionNames();
+#endif // DANI_PROFILER_INSTRUMENT_FUNCTIONS
+
+    memcpy(stacks->nodes, g_dani_profiler.stack_nodes, sizeof(stacks->nodes));
+    stacks->node_count = g_dani_profiler.stack_node_count;
+
+    for (u32 entry_index = 0; entry_index < ArrayCount(g_dani_profiler.entries); entry_index += 1) {
+        stacks->names[entry_index] = g_dani_profiler.entries[entry_index].name;
+    }
+}
+
+static void WriteProfilingFoldedStack(FILE *file, dani_profiler_stacks *stacks, u32 node_index) {
+    // Collect the path from the leaf to the root and write it in reverse
+    u32 path[DANI_PROFILER_STACK_NODES_MAX];
+    u32 path_length = 0;
+
+    while (node_index) {
+        path[path_length] = node_index;
+        path_length += 1;
+        node_index = stacks->nodes[node_index].parent_node_index;
+    }
+
+    while (path_length) {
+        path_length -= 1;
+
+        const s8 *name = stacks->names[stacks->nodes[path[path_length]].entry_index];
+        if (name == 0) {
+            name = (const s8 *)"(unknown)";
+        }
+
+        fprintf(file, (path_length == 0) ? "%s" : "%s;", name);
+    }
+}
+
+static s64 GetProfilingStackTicks(dani_profiler_stacks *stacks, u32 node_index) {
+    // The exclusive ticks are unsigned but can underflow temporarily while children are still running
+    s64 result = (s64)stacks->nodes[node_index].exclusive_ticks;
+    return (result > 0) ? result : 0;
+}
+
+__DANI_PROFILER_DEF void dani_WriteProfilingFoldedStacks(FILE *file, dani_profiler_stacks *stacks) {
+    for (u32 node_index = 1; node_index < stacks->node_count; node_index += 1) {
+        s64 ticks = GetProfilingStackTicks(stacks, node_index);
+        if (ticks) {
+            WriteProfilingFoldedStack(file, stacks, node_index);
+            fprintf(file, " %lld\n", ticks);
+        }
+    }
+}
+
+static u32 FindProfilingStackChild(dani_profiler_stacks *stacks, u32 parent_node_index, const s8 *name) {
+    u32 node_index = stacks->nodes[parent_node_index].first_child_node_index;
+    while (node_index) {
+        const s8 *node_name = stacks->names[stacks->nodes[node_index].entry_index];
+        if (node_name && IsProfilerNameEqual(node_name, name)) {
+            break;
+        }
+        node_index = stacks->nodes[node_index].next_sibling_node_index;
+    }
+
+    return (node_index);
+}
+
+__DANI_PROFILER_DEF void dani_WriteProfilingDiffFoldedStacks(FILE *file, dani_profiler_stacks *stacks_a, dani_profiler_stacks *stacks_b) {
+    // Zone indices can differ between two runs, so the paths are matched by zone name.
+    // Parents are always created before their children, which means a single pass in node order is enough to map every node of b to its counterpart in a.
+    static u32 a_node_of_b[DANI_PROFILER_STACK_NODES_MAX];
+    static b32 is_a_node_written[DANI_PROFILER_STACK_NODES_MAX];
+    memset(is_a_node_written, 0, sizeof(is_a_node_written));
+
+    a_node_of_b[0] = 0;
+    for (u32 node_index = 1; node_index < stacks_b->node_count; node_index += 1) {
+        dani_profiler_stack_node *node = &stacks_b->nodes[node_index];
+        const s8 *name = stacks_b->names[node->entry_index];
+
+        u32 a_parent_node_index = a_node_of_b[node->parent_node_index];
+        u32 a_node_index = 0;
+        if (name && (a_parent_node_index || node->parent_node_index == 0)) {
+            a_node_index = FindProfilingStackChild(stacks_a, a_parent_node_index, name);
+        }
+        a_node_of_b[node_index] = a_node_index;
+
+        s64 ticks_a = a_node_index ? GetProfilingStackTicks(stacks_a, a_node_index) : 0;
+        s64 ticks_b = GetProfilingStackTicks(stacks_b, node_index);
+        if (a_node_index) {
+            is_a_node_written[a_node_index] = B32_TRUE;
+        }
+
+        if (ticks_a || ticks_b) {
+            WriteProfilingFoldedStack(file, stacks_b, node_index);
+            fprintf(file, " %lld %lld\n", ticks_a, ticks_b);
+        }
+    }
+
+    // Paths that only exist in a
+    for (u32 node_index = 1; node_index < stacks_a->node_count; node_index += 1) {
+        s64 ticks_a = GetProfilingStackTicks(stacks_a, node_index);
+        if (IsFalse(is_a_node_written[node_index]) && ticks_a) {
+            WriteProfilingFoldedStack(file, stacks_a, node_index);
+            fprintf(file, " %lld 0\n", ticks_a);
+        }
+    }
+}
+#endif // DANI_PROFILER_STACKS
+
+static volatile s32 g_dani_profiler_lock_index_counter = 0;
+
+__DANI_PROFILER_DEF u32 dani_GetProfilerLockIndex(const s8 *name) {
+    // Locks are shared by name, so look for an already registered one first
+    u32 lock_count = (u32)g_dani_profiler_lock_index_counter;
+    for (u32 lock_index = 1; lock_index <= lock_count; lock_index += 1) {
+        const s8 *lock_name = g_dani_profiler.locks[lock_index].name;
+        if (lock_name && IsProfilerNameEqual(lock_name, name)) {
+            return (lock_index);
+        }
+    }
+
+    u32 result = (u32)AtomicIncrement32(&g_dani_profiler_lock_index_counter);
+    Assert(result != 0 && result < DANI_PROFILER_LOCKS_MAX);
+
+    g_dani_profiler.locks[result].name = name;
+    return (result);
+}
+
+static void RecordProfilerLockWait(u32 lock_index, u64 wait_start_ticks, u64 acquire_ticks) {
+    u64 wait_ticks = acquire_ticks - wait_start_ticks;
+
+    dani_profiler_lock *lock = &g_dani_profiler.locks[lock_index];
+    AtomicIncrement64(&lock->contended_counter);
+    AtomicAdd64(&lock->wait_ticks, (s64)wait_ticks, MEMORY_ORDER_RELAXED);
+
+    // Charge the wait time to the zone that is active on this thread. Waits outside of any zone only count for the lock.
+    u32 current_index = g_dani_profiler_current_index;
+    if (current_index) {
+        AtomicAdd64(&g_dani_profiler.entries[current_index].blocked_ticks, (s64)wait_ticks, MEMORY_ORDER_RELAXED);
+    }
+}
+
+__DANI_PROFILER_DEF void dani_RecordProfilingLockAcquire(u32 lock_index, const s8 *name, u64 wait_start_ticks, u64 acquire_ticks) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    if (IsFalse(g_dani_profiler_is_active)) {
+        return;
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    // A wait start of 0 marks an acquire that didn't have to wait
+    if (wait_start_ticks) {
+        RecordProfilerLockWait(lock_index, wait_start_ticks, acquire_ticks);
+    }
+
+    dani_profiler_lock *lock = &g_dani_profiler.locks[lock_index];
+    AtomicIncrement64(&lock->acquire_counter);
+    lock->name = name;
+}
+
+__DANI_PROFILER_DEF void dani_RecordProfilingLockHold(u32 lock_index, u64 hold_ticks) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    if (IsFalse(g_dani_profiler_is_active)) {
+        return;
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    AtomicAdd64(&g_dani_profiler.locks[lock_index].hold_ticks, (s64)hold_ticks, MEMORY_ORDER_RELAXED);
+}
+
+__DANI_PROFILER_DEF void dani_InitialiseMutex(dani_mutex *mutex, const s8 *name) {
+    InitializeSRWLock(&mutex->lock);
+    mutex->lock_index = dani_GetProfilerLockIndex(name);
+    mutex->acquire_ticks = 0;
+    mutex->name = name;
+}
+
+__DANI_PROFILER_DEF void dani_LockMutex(dani_mutex *mutex) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    // An acquire time of 0 marks the lock as untracked
+    if (IsFalse(g_dani_profiler_is_active)) {
+        AcquireSRWLockExclusive(&mutex->lock);
+        mutex->acquire_ticks = 0;
+        return;
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    // Only measure the wait time if the lock is actually contended
+    if (TryAcquireSRWLockExclusive(&mutex->lock)) {
+        mutex->acquire_ticks = __rdtsc();
+    } else {
+        u64 wait_start_ticks = __rdtsc();
+        AcquireSRWLockExclusive(&mutex->lock);
+        mutex->acquire_ticks = __rdtsc();
+
+        RecordProfilerLockWait(mutex->lock_index, wait_start_ticks, mutex->acquire_ticks);
+    }
+
+    // Locks are usually created before profiling starts, so the name is refreshed like the zone names are
+    dani_profiler_lock *lock = &g_dani_profiler.locks[mutex->lock_index];
+    AtomicIncrement64(&lock->acquire_counter);
+    lock->name = mutex->name;
+}
+
+__DANI_PROFILER_DEF void dani_UnlockMutex(dani_mutex *mutex) {
+    if (mutex->acquire_ticks) {
+        u64 hold_ticks = __rdtsc() - mutex->acquire_ticks;
+        AtomicAdd64(&g_dani_profiler.locks[mutex->lock_index].hold_ticks, (s64)hold_ticks, MEMORY_ORDER_RELAXED);
+    }
+
+    ReleaseSRWLockExclusive(&mutex->lock);
+}
+
+__DANI_PROFILER_DEF void dani_InitialiseRWLock(dani_rwlock *rwlock, const s8 *name) {
+    InitializeSRWLock(&rwlock->lock);
+    rwlock->lock_index = dani_GetProfilerLockIndex(name);
+    rwlock->acquire_ticks = 0;
+    rwlock->name = name;
+}
+
+__DANI_PROFILER_DEF void dani_LockRWLockExclusive(dani_rwlock *rwlock) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    // An acquire time of 0 marks the lock as untracked
+    if (IsFalse(g_dani_profiler_is_active)) {
+        AcquireSRWLockExclusive(&rwlock->lock);
+        rwlock->acquire_ticks = 0;
+        return;
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    if (TryAcquireSRWLockExclusive(&rwlock->lock)) {
+        rwlock->acquire_ticks = __rdtsc();
+    } else {
+        u64 wait_start_ticks = __rdtsc();
+        AcquireSRWLockExclusive(&rwlock->lock);
+        rwlock->acquire_ticks = __rdtsc();
+
+        RecordProfilerLockWait(rwlock->lock_index, wait_start_ticks, rwlock->acquire_ticks);
+    }
+
+    dani_profiler_lock *lock = &g_dani_profiler.locks[rwlock->lock_index];
+    AtomicIncrement64(&lock->acquire_counter);
+    lock->name = rwlock->name;
+}
+
+__DANI_PROFILER_DEF void dani_UnlockRWLockExclusive(dani_rwlock *rwlock) {
+    if (rwlock->acquire_ticks) {
+        u64 hold_ticks = __rdtsc() - rwlock->acquire_ticks;
+        AtomicAdd64(&g_dani_profiler.locks[rwlock->lock_index].hold_ticks, (s64)hold_ticks, MEMORY_ORDER_RELAXED);
+    }
+
+    ReleaseSRWLockExclusive(&rwlock->lock);
+}
+
+__DANI_PROFILER_DEF u64 dani_LockRWLockShared(dani_rwlock *rwlock) {
+#if DANI_PROFILER_RUNTIME_TOGGLE
+    if (IsFalse(g_dani_profiler_is_active)) {
+        AcquireSRWLockShared(&rwlock->lock);
+        return (0);
+    }
+#endif // DANI_PROFILER_RUNTIME_TOGGLE
+
+    u64 result;
+
+    if (TryAcquireSRWLockShared(&rwlock->lock)) {
+        result = __rdtsc();
+    } else {
+        u64 wait_start_ticks = __rdtsc();
+        AcquireSRWLockShared(&rwlock->lock);
+        result = __rdtsc();
+
+        RecordProfilerLockWait(rwlock->lock_index, wait_start_ticks, result);
+    }
+
+    dani_profiler_lock *lock = &g_dani_profiler.locks[rwlock->lock_index];
+    AtomicIncrement64(&lock->acquire_counter);
+    lock->name = rwlock->name;
+
+    return (result);
+}
+
+__DANI_PROFILER_DEF void dani_UnlockRWLockShared(dani_rwlock *rwlock, u64 acquire_ticks) {
+    if (acquire_ticks) {
+        u64 hold_ticks = __rdtsc() - acquire_ticks;
+        AtomicAdd64(&g_dani_profiler.locks[rwlock->lock_index].hold_ticks, (s64)hold_ticks, MEMORY_ORDER_RELAXED);
+    }
+
+    ReleaseSRWLockShared(&rwlock->lock);
+}
+
+static void FormatProfilingLocks(dani_format_buffer *report, u64 elapsed_total_ticks, u64 cpu_frequency) {
+    for (u32 lock_index = 0; lock_index < ArrayCount(g_dani_profiler.locks); lock_index += 1) {
+        dani_profiler_lock *lock = &g_dani_profiler.locks[lock_index];
+        if (lock->acquire_counter) {
+            f64 contended_percentage = ((f64)lock->contended_counter / (f64)lock->acquire_counter) * 100.0;
+            f64 wait_percentage = ((f64)lock->wait_ticks / (f64)elapsed_total_ticks) * 100.0;
+            f64 hold_percentage = ((f64)lock->hold_ticks / (f64)elapsed_total_ticks) * 100.0;
+
+            dani_FormatPrint(report, "  %s[", lock->name);
+            dani_FormatSIUnit(report, (f64)lock->acquire_counter, "");
+            dani_FormatPrint(report, "] Lock - Contended[%0.2f%%]: ", contended_percentage);
+            dani_FormatSIUnit(report, (f64)lock->contended_counter, "");
+            dani_FormatPrint(report, ", Wait[%0.2f%%]: ", wait_percentage);
+            FormatProfilingTimes(report, (u64)lock->wait_ticks, cpu_frequency);
+            dani_FormatPrint(report, ", Hold[%0.2f%%]: ", hold_percentage);
+            FormatProfilingTimes(report, (u64)lock->hold_ticks, cpu_frequency);
+            dani_FormatPrint(report, "\n");
+        }
+    }
+}
+
+#if DANI_PROFILER_OUTLIERS
+static void FormatProfilingOutliers(dani_format_buffer *report, dani_profiler_entry *entry, u64 elapsed_total_ticks, u64 cpu_frequency) {
+    // Sort a copy of the heap from slowest to fastest
+    dani_profiler_outlier outliers[DANI_PROFILER_OUTLIERS_MAX];
+    u32 outlier_count = entry->outlier_count;
+
+    for (u32 outlier_index = 0; outlier_index < outlier_count; outlier_index += 1) {
+        dani_profiler_outlier outlier = entry->outliers[outlier_index];
+
+        u32 insert_index = outlier_index;
+        while (insert_index > 0 && outliers[insert_index - 1].inclusive_ticks < outlier.inclusive_ticks) {
+            outliers[insert_index] = outliers[insert_index - 1];
+            insert_index -= 1;
+        }
+        outliers[insert_index] = outlier;
+    }
+
+    for (u32 outlier_index = 0; outlier_index < outlier_count; outlier_index += 1) {
+        dani_profiler_outlier *outlier = &outliers[outlier_index];
+        f64 percentage = ((f64)outlier->inclusive_ticks / (f64)elapsed_total_ticks) * 100.0;
+
+        dani_FormatPrint(report, "\n    Outlier #%u - Incl[%0.2f%%]: ", outlier_index + 1, percentage);
+        FormatProfilingTimes(report, outlier->inclusive_ticks, cpu_frequency);
+        dani_FormatPrint(report, ", At: ");
+        FormatProfilingTimes(report, outlier->start_ticks - g_dani_profiler.start_ticks, cpu_frequency);
+        dani_FormatPrint(report, ", Thread: %u", outlier->thread_id);
+
+        if (outlier->byte_count) {
+            dani_FormatPrint(report, ", Bytes: ");
+            dani_FormatByteCount(report, (f64)outlier->byte_count);
+        }
+        if (outlier->page_fault_count) {
+            dani_FormatPrint(report, ", Page faults: ");
+            dani_FormatSIUnit(report, (f64)outlier->page_fault_count, "");
+        }
+        if (outlier->tag) {
+            dani_FormatPrint(report, ", Tag: %llu", outlier->tag);
+        }
+    }
+}
+#endif // DANI_PROFILER_OUTLIERS
+
+static void FormatProfilingCounters(dani_format_buffer *report) {
+    for (u32 counter_index = 0; counter_index < ArrayCount(g_dani_profiler.counters); counter_index += 1) {
+        dani_profiler_counter *counter = &g_dani_profiler.counters[counter_index];
+        if (counter->sample_counter) {
+            f64 average_value = counter->sum_value / (f64)counter->sample_counter;
+
+            dani_FormatPrint(report, "  %s[", counter->name);
+            dani_FormatSIUnit(report, (f64)counter->sample_counter, "");
+            dani_FormatPrint(report, "] Counter - Last: %0.2f, Min: %0.2f, Max: %0.2f, Average: %0.2f\n", counter->last_value, counter->min_value, counter->max_value, average_value);
+        }
+    }
 }
 
 #endif // DANI_PROFILER_ENABLED
 
+static s8 g_dani_profiler_report_data[DANI_PROFILER_REPORT_SIZE];
+
 __DANI_PROFILER_DEF void dani_PrintProfilingResults(void) {
     u64 cpu_frequency = ReadCPUTimerFrequency(100);
     u64 elapsed_total_ticks = g_dani_profiler.end_ticks - g_dani_profiler.start_ticks;
 
+    // The whole report is formatted into one buffer and written at once
+    dani_format_buffer report_buffer;
+    dani_format_buffer *report = &report_buffer;
+    dani_InitialiseFormatBuffer(report, g_dani_profiler_report_data, sizeof(g_dani_profiler_report_data), FlushProfilingReport);
+
     if (cpu_frequency) {
-        DANI_PROFILER_PRINTF("Total time: ");
-        PrintProfilingTimes(elapsed_total_ticks, cpu_frequency);
-        DANI_PROFILER_PRINTF(" @ ");
-        PrintProfilingValueAsSIUnit((f64)cpu_frequency, "Hz");
-        DANI_PROFILER_PRINTF("\n");
+        dani_FormatPrint(report, "Total time: ");
+        FormatProfilingTimes(report, elapsed_total_ticks, cpu_frequency);
+        dani_FormatPrint(report, " @ ");
+        dani_FormatSIUnit(report, (f64)cpu_frequency, "Hz");
+        dani_FormatPrint(report, "\n");
 
 #if DANI_PROFILER_PAGE_FAULTS
         u64 total_page_faults = g_dani_profiler.end_page_faults - g_dani_profiler.start_page_faults;
-        DANI_PROFILER_PRINTF("Total page faults: ");
-        PrintProfilingValueAsSIUnit((f64)total_page_faults, "");
-        DANI_PROFILER_PRINTF("\n");
+        dani_FormatPrint(report, "Total page faults: ");
+        dani_FormatSIUnit(report, (f64)total_page_faults, "");
+        dani_FormatPrint(report, "\n");
 #endif // DANI_PROFILER_PAGE_FAULTS
 
 #if DANI_PROFILER_ENABLED
+#if DANI_PROFILER_INSTRUMENT_FUNCTIONS
+        ResolveProfilerFunctionNames();
+#endif // DANI_PROFILER_INSTRUMENT_FUNCTIONS
+
         for (u32 entry_index = 0; entry_index < ArrayCount(g_dani_profiler.entries); entry_index += 1) {
             dani_profiler_entry *entry = &g_dani_profiler.entries[entry_index];
             if (entry->inclusive_ticks) {
+                u64 inclusive_ticks = entry->inclusive_ticks;
+                u64 exclusive_ticks = entry->exclusive_ticks;
+
+                // Scale sampled zones up to an estimate for all hits
+                u64 timed_hit_counter = entry->hit_counter - entry->skipped_hit_counter;
+                if (entry->skipped_hit_counter && timed_hit_counter) {
+                    f64 sample_scale = (f64)entry->hit_counter / (f64)timed_hit_counter;
+                    inclusive_ticks = (u64)((f64)inclusive_ticks * sample_scale);
+                    exclusive_ticks = (u64)((f64)exclusive_ticks * sample_scale);
+                }
+
                 // Total time
-                DANI_PROFILER_PRINTF("  %s[", entry->name);
-                PrintProfilingValueAsSIUnit((f64)entry->hit_counter, "");
-                DANI_PROFILER_PRINTF("] Total - ");
-                PrintInclusiveAndExclusiveProfilingTimes(entry->inclusive_ticks, entry->exclusive_ticks, elapsed_total_ticks, cpu_frequency);
+                dani_FormatPrint(report, "  %s[", entry->name);
+                dani_FormatSIUnit(report, (f64)entry->hit_counter, "");
+                if (entry->skipped_hit_counter) {
+                    dani_FormatPrint(report, "] Sampled[");
+                    dani_FormatSIUnit(report, (f64)timed_hit_counter, "");
+                    dani_FormatPrint(report, "] Estimated Total - ");
+                } else {
+                    dani_FormatPrint(report, "] Total - ");
+                }
+                FormatInclusiveAndExclusiveProfilingTimes(report, inclusive_ticks, exclusive_ticks, elapsed_total_ticks, cpu_frequency);
+
+                FormatProfilingEntryThroughput(report, entry, 1.0, inclusive_ticks, cpu_frequency);
 
-                if (entry->processed_bytes_counter) {
-                    PrintProfilingBandwidth((f64)entry->processed_bytes_counter, entry->inclusive_ticks, cpu_frequency);
+                if (entry->blocked_ticks) {
+                    f64 blocked_percentage = ((f64)entry->blocked_ticks / (f64)elapsed_total_ticks) * 100.0;
+                    dani_FormatPrint(report, ", Blocked[%0.2f%%]: ", blocked_percentage);
+                    FormatProfilingTimes(report, entry->blocked_ticks, cpu_frequency);
                 }
 
 #if DANI_PROFILER_PAGE_FAULTS
                 if (entry->page_fault_counter) {
-                    DANI_PROFILER_PRINTF(", Page faults: ");
-                    PrintProfilingValueAsSIUnit((f64)entry->page_fault_counter, "");
+                    dani_FormatPrint(report, ", Page faults: ");
+                    dani_FormatSIUnit(report, (f64)entry->page_fault_counter, "");
                 }
 #endif // DANI_PROFILER_PAGE_FAULTS
 
                 // Average time
                 if (entry->hit_counter > 1) {
-                    u64 average_inclusive = entry->inclusive_ticks / entry->hit_counter;
-                    u64 average_exclusive = entry->exclusive_ticks / entry->hit_counter;
+                    u64 average_inclusive = inclusive_ticks / entry->hit_counter;
+                    u64 average_exclusive = exclusive_ticks / entry->hit_counter;
 
-                    DANI_PROFILER_PRINTF("\n    Average - ");
-                    PrintInclusiveAndExclusiveProfilingTimes(average_inclusive, average_exclusive, elapsed_total_ticks, cpu_frequency);
+                    dani_FormatPrint(report, "\n    Average - ");
+                    FormatInclusiveAndExclusiveProfilingTimes(report, average_inclusive, average_exclusive, elapsed_total_ticks, cpu_frequency);
 
-                    if (entry->processed_bytes_counter) {
-                        f64 average_bytes = ((f64)entry->processed_bytes_counter / (f64)entry->hit_counter);
-                        PrintProfilingBandwidth(average_bytes, average_inclusive, cpu_frequency);
-                    }
+                    FormatProfilingEntryThroughput(report, entry, (f64)entry->hit_counter, average_inclusive, cpu_frequency);
 
 #if DANI_PROFILER_PAGE_FAULTS
                     if (entry->page_fault_counter) {
                         f64 average_page_faults = ((f64)entry->page_fault_counter / (f64)entry->hit_counter);
-                        DANI_PROFILER_PRINTF(", Page faults: ");
-                        PrintProfilingValueAsSIUnit(average_page_faults, "");
+                        dani_FormatPrint(report, ", Page faults: ");
+                        dani_FormatSIUnit(report, average_page_faults, "");
                     }
 #endif // DANI_PROFILER_PAGE_FAULTS
                 }
@@ -566,17 +2431,40 @@ __DANI_PROFILER_DEF void dani_PrintProfilingResults(void) {
 #if DANI_PROFILER_MIN_MAX
                 // Max & max time
                 if (entry->hit_counter > 1 && entry->inclusive_ticks_max) {
-                    DANI_PROFILER_PRINTF("\n    Extreme - ");
-                    PrintInclusiveMinAndMaxProfilingTimes(entry->inclusive_ticks_min, entry->inclusive_ticks_max, elapsed_total_ticks, cpu_frequency);
+                    dani_FormatPrint(report, "\n    Extreme - ");
+                    FormatInclusiveMinAndMaxProfilingTimes(report, entry->inclusive_ticks_min, entry->inclusive_ticks_max, elapsed_total_ticks, cpu_frequency);
                 }
 #endif // DANI_PROFILER_MIN_MAX
-                DANI_PROFILER_PRINTF("\n");
+
+#if DANI_PROFILER_VARIANCE
+                FormatProfilingDeviation(report, entry, cpu_frequency);
+#endif // DANI_PROFILER_VARIANCE
+
+#if DANI_PROFILER_OUTLIERS
+                if (entry->hit_counter > 1) {
+                    FormatProfilingOutliers(report, entry, elapsed_total_ticks, cpu_frequency);
+                }
+#endif // DANI_PROFILER_OUTLIERS
+                dani_FormatPrint(report, "\n");
             }
         }
+
+        FormatProfilingCounters(report);
+        FormatProfilingLocks(report, elapsed_total_ticks, cpu_frequency);
+
+#if DANI_PROFILER_TRACE
+        dani_FormatPrint(report, "Trace: ");
+        dani_FormatByteCount(report, (f64)g_dani_profiler_trace.written_byte_count);
+        dani_FormatPrint(report, " written to %s, ", DANI_PROFILER_TRACE_FILE);
+        dani_FormatSIUnit(report, (f64)g_dani_profiler_trace.dropped_event_count, "");
+        dani_FormatPrint(report, " events dropped\n");
+#endif // DANI_PROFILER_TRACE
 #endif // DANI_PROFILER_ENABLED
     } else {
-        DANI_PROFILER_PRINTF("Total ticks: %llu (Failed to estimate CPU frequency!)\n", elapsed_total_ticks);
+        dani_FormatPrint(report, "Total ticks: %llu (Failed to estimate CPU frequency!)\n", elapsed_total_ticks);
     }
+
+    dani_FlushFormatBuffer(report);
 }
 
 #endif // DANI_LIB_PROFILER_IMPLEMENTATION
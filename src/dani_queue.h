@@ -0,0 +1,242 @@
+// Danilib - dani_queue.h
+// Types and functions for a bounded lock free multi producer multi consumer queue.
+//
+// Author: Dani Drywa (dani@drywa.me)
+// This library is based on the bounded MPMC queue by Dmitry Vyukov at https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types and atomics
+// Windows.h - for VirtualAlloc and VirtualFree
+// string.h - for memset
+//
+// Notes:
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_QUEUE_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_QUEUE_STATIC before including this file.
+// The queue stores pointer sized values. Any number of threads can enqueue and dequeue at the same time without locks.
+// The capacity must be a power of 2. Every slot of the queue has a sequence number that tells producers and consumers if the slot is free or filled for their position, so the only shared writes are the CAS on the enqueue or dequeue position and the slot itself.
+// The queue is cache line aligned and the enqueue and dequeue positions are DANI_QUEUE_FALSE_SHARING_SIZE (default FALSE_SHARING_SIZE) bytes apart, so producers and consumers don't invalidate each others lines, not even through the adjacent line prefetcher. The distance can be changed by specifying DANI_QUEUE_FALSE_SHARING_SIZE before including this file.
+// Enqueue and dequeue never block. They return B32_FALSE if the queue is full or empty. The batch versions return how many values have been enqueued or dequeued, which can be less than requested. A batch claims all of its slots with a single CAS.
+//
+// How to use:
+//
+// dani_queue queue;
+// if (dani_InitialiseQueue(&queue, 1024)) {
+//     // Producer threads
+//     while (IsFalse(dani_Enqueue(&queue, job))) {
+//         CpuPause(); // Full
+//     }
+//
+//     // Consumer threads
+//     void *jobs[32];
+//     u32 job_count = dani_DequeueBatch(&queue, jobs, ArrayCount(jobs));
+//
+//     dani_ReleaseQueue(&queue);
+// }
+//
+#ifndef __DANI_LIB_QUEUE_H
+#define __DANI_LIB_QUEUE_H
+
+#ifdef DANI_QUEUE_STATIC
+#define __DANI_QUEUE_DEC static
+#define __DANI_QUEUE_DEF static
+#else
+#define __DANI_QUEUE_DEC extern
+#define __DANI_QUEUE_DEF
+#endif
+
+#ifndef DANI_QUEUE_FALSE_SHARING_SIZE
+#define DANI_QUEUE_FALSE_SHARING_SIZE FALSE_SHARING_SIZE
+#endif
+
+typedef struct __DANI_QUEUE_SLOT dani_queue_slot;
+struct __DANI_QUEUE_SLOT {
+    volatile s64 sequence;
+    void *value;
+};
+
+typedef struct __DANI_QUEUE dani_queue;
+struct CacheAligned __DANI_QUEUE {
+    dani_queue_slot *slots;
+    u64 mask;
+    u8 padding0[DANI_QUEUE_FALSE_SHARING_SIZE - sizeof(dani_queue_slot *) - sizeof(u64)];
+
+    volatile s64 enqueue_position;
+    u8 padding1[DANI_QUEUE_FALSE_SHARING_SIZE - sizeof(s64)];
+
+    volatile s64 dequeue_position;
+    u8 padding2[DANI_QUEUE_FALSE_SHARING_SIZE - sizeof(s64)];
+};
+
+__DANI_QUEUE_DEC b32 dani_InitialiseQueue(dani_queue *queue, u64 capacity);
+__DANI_QUEUE_DEC void dani_ReleaseQueue(dani_queue *queue);
+
+__DANI_QUEUE_DEC b32 dani_Enqueue(dani_queue *queue, void *value);
+__DANI_QUEUE_DEC b32 dani_Dequeue(dani_queue *queue, void **value);
+__DANI_QUEUE_DEC u32 dani_EnqueueBatch(dani_queue *queue, void **values, u32 value_count);
+__DANI_QUEUE_DEC u32 dani_DequeueBatch(dani_queue *queue, void **values, u32 value_count_max);
+
+#endif // __DANI_LIB_QUEUE_H
+
+#ifdef DANI_LIB_QUEUE_IMPLEMENTATION
+
+__DANI_QUEUE_DEF b32 dani_InitialiseQueue(dani_queue *queue, u64 capacity) {
+    memset(queue, 0, sizeof(*queue));
+
+    Assert(capacity >= 2 && IsPower2(capacity));
+    if (capacity < 2 || !IsPower2(capacity)) {
+        return (B32_FAILURE);
+    }
+
+    queue->slots = (dani_queue_slot *)VirtualAlloc(0, capacity * sizeof(dani_queue_slot), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (queue->slots == 0) {
+        return (B32_FAILURE);
+    }
+
+    // A slot is free for the producer whose position equals its sequence
+    for (u64 slot_index = 0; slot_index < capacity; slot_index += 1) {
+        queue->slots[slot_index].sequence = (s64)slot_index;
+    }
+
+    queue->mask = capacity - 1;
+    return (B32_SUCCESS);
+}
+
+__DANI_QUEUE_DEF void dani_ReleaseQueue(dani_queue *queue) {
+    if (queue->slots) {
+        VirtualFree(queue->slots, 0, MEM_RELEASE);
+    }
+
+    queue->slots = 0;
+}
+
+__DANI_QUEUE_DEF b32 dani_Enqueue(dani_queue *queue, void *value) {
+    u32 result = dani_EnqueueBatch(queue, &value, 1);
+    return (result == 1);
+}
+
+__DANI_QUEUE_DEF b32 dani_Dequeue(dani_queue *queue, void **value) {
+    u32 result = dani_DequeueBatch(queue, value, 1);
+    return (result == 1);
+}
+
+__DANI_QUEUE_DEF u32 dani_EnqueueBatch(dani_queue *queue, void **values, u32 value_count) {
+    s64 position = AtomicLoad64(&queue->enqueue_position, MEMORY_ORDER_RELAXED);
+    u32 claim_count;
+
+    for (;;) {
+        // Count the free slots from the current position. Only the producer that claims a position can change its slot, so they stay free until the CAS below.
+        claim_count = 0;
+        while (claim_count < value_count) {
+            s64 claim_position = position + claim_count;
+            if (AtomicLoad64(&queue->slots[claim_position & queue->mask].sequence, MEMORY_ORDER_ACQUIRE) != claim_position) {
+                break;
+            }
+            claim_count += 1;
+        }
+
+        if (claim_count == 0) {
+            s64 sequence = AtomicLoad64(&queue->slots[position & queue->mask].sequence, MEMORY_ORDER_ACQUIRE);
+            if (sequence < position) {
+                // The consumer of the previous lap didn't free the slot yet
+                return (0);
+            }
+
+            // Another producer claimed this position
+            position = AtomicLoad64(&queue->enqueue_position, MEMORY_ORDER_RELAXED);
+            continue;
+        }
+
+        s64 previous_position = AtomicCompareExchange64(&queue->enqueue_position, position, position + claim_count, MEMORY_ORDER_RELAXED);
+        if (previous_position == position) {
+            break;
+        }
+
+        position = previous_position;
+    }
+
+    for (u32 value_index = 0; value_index < claim_count; value_index += 1) {
+        dani_queue_slot *slot = &queue->slots[(position + value_index) & queue->mask];
+        slot->value = values[value_index];
+        AtomicStore64(&slot->sequence, position + value_index + 1, MEMORY_ORDER_RELEASE);
+    }
+
+    return (claim_count);
+}
+
+__DANI_QUEUE_DEF u32 dani_DequeueBatch(dani_queue *queue, void **values, u32 value_count_max) {
+    s64 position = AtomicLoad64(&queue->dequeue_position, MEMORY_ORDER_RELAXED);
+    u32 claim_count;
+
+    for (;;) {
+        // Count the filled slots from the current position. Only the consumer that claims a position can change its slot, so they stay filled until the CAS below.
+        claim_count = 0;
+        while (claim_count < value_count_max) {
+            s64 claim_position = position + claim_count;
+            if (AtomicLoad64(&queue->slots[claim_position & queue->mask].sequence, MEMORY_ORDER_ACQUIRE) != claim_position + 1) {
+                break;
+            }
+            claim_count += 1;
+        }
+
+        if (claim_count == 0) {
+            s64 sequence = AtomicLoad64(&queue->slots[position & queue->mask].sequence, MEMORY_ORDER_ACQUIRE);
+            if (sequence < position + 1) {
+                // The producer for this position didn't fill the slot yet
+                return (0);
+            }
+
+            // Another consumer claimed this position
+            position = AtomicLoad64(&queue->dequeue_position, MEMORY_ORDER_RELAXED);
+            continue;
+        }
+
+        s64 previous_position = AtomicCompareExchange64(&queue->dequeue_position, position, position + claim_count, MEMORY_ORDER_RELAXED);
+        if (previous_position == position) {
+            break;
+        }
+
+        position = previous_position;
+    }
+
+    for (u32 value_index = 0; value_index < claim_count; value_index += 1) {
+        dani_queue_slot *slot = &queue->slots[(position + value_index) & queue->mask];
+        values[value_index] = slot->value;
+
+        // Free the slot for the producer of the next lap
+        AtomicStore64(&slot->sequence, position + value_index + (s64)queue->mask + 1, MEMORY_ORDER_RELEASE);
+    }
+
+    return (claim_count);
+}
+
+#endif // DANI_LIB_QUEUE_IMPLEMENTATION
+
+/*
+Danilib - dani_queue.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
@@ -0,0 +1,278 @@
+// Danilib - dani_repetition.h
+// Types and functions for repetition testing small pieces of code.
+//
+// Author: Dani Drywa (dani@drywa.me)
+// This library is based on the repetition tester from Casey Muratori's performance aware programming course at https://www.computerenhance.com/
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types
+// dani_profiler.h - for the CPU timer, page fault counter, and format helpers. The profiler implementation has to be included in the same translation unit before this file with DANI_PROFILER_ENABLED and DANI_PROFILER_PAGE_FAULTS set to 1.
+//
+// Notes:
+// This library is *NOT* thread safe. Every thread needs its own tester.
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_REPETITION_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_REPETITION_STATIC before including this file.
+// A test runs until it could not find a new minimum time for the given amount of seconds. This makes sure the minimum is actually the best case and not just a lucky run.
+// Every repetition has to process the same amount of bytes. Count them with dani_CountRepetitionBytes, a mismatch is reported as an error.
+// New minimums are printed while testing. To turn this off set print_new_minimums in the tester to B32_FALSE after calling dani_NewRepetitionTestWave.
+//
+// How to use:
+//
+// dani_repetition_tester tester = {0};
+// u64 cpu_frequency = ReadCPUTimerFrequency(100); // From the profiler implementation
+// dani_NewRepetitionTestWave(&tester, buffer_size, cpu_frequency, 10);
+// while (dani_IsRepetitionTesting(&tester)) {
+//     dani_BeginRepetitionTime(&tester);
+//     // The code you want to test
+//     dani_EndRepetitionTime(&tester);
+//     dani_CountRepetitionBytes(&tester, buffer_size);
+// }
+//
+// Multiple waves can be run with the same tester. The results of the previous wave are kept as a baseline, so the minimum of a new wave is only printed once it beats the previous one.
+//
+#ifndef __DANI_LIB_REPETITION_H
+#define __DANI_LIB_REPETITION_H
+
+#ifdef DANI_REPETITION_STATIC
+#define __DANI_REPETITION_DEC static
+#define __DANI_REPETITION_DEF static
+#else
+#define __DANI_REPETITION_DEC extern
+#define __DANI_REPETITION_DEF
+#endif
+
+#define DANI_REPETITION_STATE_UNINITIALISED 0
+#define DANI_REPETITION_STATE_TESTING 1
+#define DANI_REPETITION_STATE_COMPLETED 2
+#define DANI_REPETITION_STATE_ERROR 3
+
+typedef struct __DANI_REPETITION_VALUE dani_repetition_value;
+struct __DANI_REPETITION_VALUE {
+    u64 test_count;
+    u64 ticks;
+    u64 page_fault_count;
+    u64 byte_count;
+};
+
+typedef struct __DANI_REPETITION_RESULTS dani_repetition_results;
+struct __DANI_REPETITION_RESULTS {
+    dani_repetition_value total;
+    dani_repetition_value min;
+    dani_repetition_value max;
+};
+
+typedef struct __DANI_REPETITION_TESTER dani_repetition_tester;
+struct __DANI_REPETITION_TESTER {
+    u64 target_byte_count;
+    u64 cpu_frequency;
+    u64 try_for_ticks;
+    u64 tests_started_at;
+
+    u32 state;
+    b32 print_new_minimums;
+    u32 open_block_count;
+    u32 close_block_count;
+    const s8 *error_message;
+
+    dani_repetition_value accumulated_on_this_test;
+    dani_repetition_results results;
+};
+
+__DANI_REPETITION_DEC void dani_NewRepetitionTestWave(dani_repetition_tester *tester, u64 target_byte_count, u64 cpu_frequency, u32 seconds_to_try);
+__DANI_REPETITION_DEC b32 dani_IsRepetitionTesting(dani_repetition_tester *tester);
+
+__DANI_REPETITION_DEC void dani_BeginRepetitionTime(dani_repetition_tester *tester);
+__DANI_REPETITION_DEC void dani_EndRepetitionTime(dani_repetition_tester *tester);
+__DANI_REPETITION_DEC void dani_CountRepetitionBytes(dani_repetition_tester *tester, u64 byte_count);
+__DANI_REPETITION_DEC void dani_SetRepetitionError(dani_repetition_tester *tester, const s8 *message);
+
+__DANI_REPETITION_DEC void dani_PrintRepetitionResults(dani_repetition_results *results, u64 cpu_frequency);
+
+#endif // __DANI_LIB_REPETITION_H
+
+#ifdef DANI_LIB_REPETITION_IMPLEMENTATION
+
+static void FormatRepetitionValue(dani_format_buffer *report, const s8 *label, dani_repetition_value *value, u64 cpu_frequency) {
+    f64 divisor = (value->test_count) ? (f64)value->test_count : 1.0;
+    u64 ticks = (u64)((f64)value->ticks / divisor);
+    f64 byte_count = (f64)value->byte_count / divisor;
+    f64 page_fault_count = (f64)value->page_fault_count / divisor;
+
+    dani_FormatPrint(report, "%s: ", label);
+    FormatProfilingTimes(report, ticks, cpu_frequency);
+
+    if (byte_count > 0.0 && ticks) {
+        FormatProfilingBandwidth(report, "Bandwidth", byte_count, ticks, cpu_frequency, g_dani_profiler_peak_read_bandwidth);
+    }
+
+    if (page_fault_count > 0.0) {
+        dani_FormatPrint(report, ", Page faults: ");
+        dani_FormatSIUnit(report, page_fault_count, "");
+        if (byte_count > 0.0) {
+            dani_FormatPrint(report, " (%0.4fKiB/fault)", (byte_count / page_fault_count) / 1024.0);
+        }
+    }
+}
+
+__DANI_REPETITION_DEF void dani_NewRepetitionTestWave(dani_repetition_tester *tester, u64 target_byte_count, u64 cpu_frequency, u32 seconds_to_try) {
+    InitialiseOSProfilingMetrics();
+
+    if (tester->state == DANI_REPETITION_STATE_UNINITIALISED) {
+        tester->state = DANI_REPETITION_STATE_TESTING;
+        tester->target_byte_count = target_byte_count;
+        tester->cpu_frequency = cpu_frequency;
+        tester->print_new_minimums = B32_TRUE;
+        tester->results.min.ticks = U64_MAX;
+    } else if (tester->state == DANI_REPETITION_STATE_COMPLETED) {
+        tester->state = DANI_REPETITION_STATE_TESTING;
+
+        if (tester->target_byte_count != target_byte_count) {
+            dani_SetRepetitionError(tester, "Target byte count changed");
+        }
+        if (tester->cpu_frequency != cpu_frequency) {
+            dani_SetRepetitionError(tester, "CPU frequency changed");
+        }
+    }
+
+    tester->try_for_ticks = (u64)seconds_to_try * cpu_frequency;
+    tester->tests_started_at = ReadStartCPUTimer();
+}
+
+__DANI_REPETITION_DEF void dani_SetRepetitionError(dani_repetition_tester *tester, const s8 *message) {
+    tester->state = DANI_REPETITION_STATE_ERROR;
+    tester->error_message = message;
+    DANI_PROFILER_PRINTF("ERROR: %s\n", message);
+}
+
+__DANI_REPETITION_DEF void dani_BeginRepetitionTime(dani_repetition_tester *tester) {
+    tester->open_block_count += 1;
+
+    dani_repetition_value *accumulated = &tester->accumulated_on_this_test;
+    accumulated->page_fault_count -= ReadOSPageFaultCount();
+    accumulated->ticks -= ReadStartCPUTimer();
+}
+
+__DANI_REPETITION_DEF void dani_EndRepetitionTime(dani_repetition_tester *tester) {
+    dani_repetition_value *accumulated = &tester->accumulated_on_this_test;
+    accumulated->ticks += ReadEndCPUTimer();
+    accumulated->page_fault_count += ReadOSPageFaultCount();
+
+    tester->close_block_count += 1;
+}
+
+__DANI_REPETITION_DEF void dani_CountRepetitionBytes(dani_repetition_tester *tester, u64 byte_count) {
+    tester->accumulated_on_this_test.byte_count += byte_count;
+}
+
+__DANI_REPETITION_DEF b32 dani_IsRepetitionTesting(dani_repetition_tester *tester) {
+    if (tester->state == DANI_REPETITION_STATE_TESTING) {
+        dani_repetition_value accumulated = tester->accumulated_on_this_test;
+        u64 current_ticks = ReadStartCPUTimer();
+
+        // Don't count a test that didn't time anything yet, like the first call of the loop
+        if (tester->open_block_count) {
+            if (tester->open_block_count != tester->close_block_count) {
+                dani_SetRepetitionError(tester, "Unbalanced dani_BeginRepetitionTime/dani_EndRepetitionTime");
+            }
+
+            if (accumulated.byte_count != tester->target_byte_count) {
+                dani_SetRepetitionError(tester, "Processed byte count mismatch");
+            }
+
+            if (tester->state == DANI_REPETITION_STATE_TESTING) {
+                dani_repetition_results *results = &tester->results;
+
+                accumulated.test_count = 1;
+                results->total.test_count += 1;
+                results->total.ticks += accumulated.ticks;
+                results->total.page_fault_count += accumulated.page_fault_count;
+                results->total.byte_count += accumulated.byte_count;
+
+                if (results->max.ticks < accumulated.ticks) {
+                    results->max = accumulated;
+                }
+
+                if (results->min.ticks > accumulated.ticks) {
+                    results->min = accumulated;
+
+                    // Every new minimum restarts the wait
+                    tester->tests_started_at = current_ticks;
+
+                    if (tester->print_new_minimums) {
+                        s8 line[512];
+                        dani_format_buffer report;
+                        dani_InitialiseFormatBuffer(&report, line, sizeof(line), FlushProfilingReport);
+                        FormatRepetitionValue(&report, "Min", &results->min, tester->cpu_frequency);
+                        dani_FormatPrint(&report, "                                   \r");
+                        dani_FlushFormatBuffer(&report);
+                    }
+                }
+
+                tester->open_block_count = 0;
+                tester->close_block_count = 0;
+                memset(&tester->accumulated_on_this_test, 0, sizeof(tester->accumulated_on_this_test));
+            }
+        }
+
+        if ((current_ticks - tester->tests_started_at) > tester->try_for_ticks) {
+            tester->state = DANI_REPETITION_STATE_COMPLETED;
+
+            DANI_PROFILER_PRINTF("                                                                                                    \r");
+            dani_PrintRepetitionResults(&tester->results, tester->cpu_frequency);
+        }
+    }
+
+    b32 result = (tester->state == DANI_REPETITION_STATE_TESTING);
+    return (result);
+}
+
+__DANI_REPETITION_DEF void dani_PrintRepetitionResults(dani_repetition_results *results, u64 cpu_frequency) {
+    s8 lines[1536];
+    dani_format_buffer report;
+    dani_InitialiseFormatBuffer(&report, lines, sizeof(lines), FlushProfilingReport);
+
+    FormatRepetitionValue(&report, "Min", &results->min, cpu_frequency);
+    dani_FormatPrint(&report, "\n");
+
+    FormatRepetitionValue(&report, "Max", &results->max, cpu_frequency);
+    dani_FormatPrint(&report, "\n");
+
+    if (results->total.test_count) {
+        FormatRepetitionValue(&report, "Avg", &results->total, cpu_frequency);
+        dani_FormatPrint(&report, "\n");
+    }
+
+    dani_FlushFormatBuffer(&report);
+}
+
+#endif // DANI_LIB_REPETITION_IMPLEMENTATION
+
+/*
+Danilib - dani_repetition.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
@@ -0,0 +1,283 @@
+// Danilib - dani_ring.h
+// Types and functions for a wait free single producer single consumer ring buffer.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types and atomics
+// Windows.h - for VirtualAlloc2, VirtualFree, CreateFileMappingA, MapViewOfFile3, UnmapViewOfFile, CloseHandle, and GetSystemInfo. Requires Windows 10 version 1803 or newer. Link with onecore.lib.
+// string.h - for memset and memcpy
+//
+// Notes:
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_RING_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_RING_STATIC before including this file.
+// Exactly one thread can write to the ring and exactly one thread can read from it at the same time. Neither of them ever waits for the other, reserve and peek simply return less space if the other side is behind.
+// The capacity is rounded up to a multiple of the allocation granularity (usually 64KiB). The memory of the ring is mapped twice back to back, so every reserved or peeked region is contiguous even if it wraps around the end of the ring. This allows to write and read messages in place without copying them.
+// Each side keeps a local copy of the position of the other side and only reloads it when the copy says there is not enough space or data. This keeps the cache line of the other side from bouncing between the cores on every operation. The ring is cache line aligned and the fields of both sides are DANI_RING_FALSE_SHARING_SIZE (default FALSE_SHARING_SIZE) bytes apart, so they don't share a line, not even through the adjacent line prefetcher. The distance can be changed by specifying DANI_RING_FALSE_SHARING_SIZE before including this file.
+// To count how often each side had to reload the position of the other side specify DANI_RING_STATISTICS before including this file. Every reload is a cache line that has to be fetched from the other core, so it is a good estimate of the cache misses caused by the ring.
+//
+// How to use:
+//
+// dani_ring ring;
+// if (dani_InitialiseRing(&ring, MiB(1))) {
+//     // Writer thread
+//     u8 *write = dani_ReserveRingWrite(&ring, message_size);
+//     if (write) {
+//         // Write up to message_size bytes
+//         dani_CommitRingWrite(&ring, message_size);
+//     }
+//
+//     // Reader thread
+//     u64 available_size;
+//     u8 *read = dani_PeekRingRead(&ring, &available_size);
+//     if (available_size) {
+//         // Read up to available_size bytes
+//         dani_CommitRingRead(&ring, available_size);
+//     }
+//
+//     dani_ReleaseRing(&ring);
+// }
+//
+#ifndef __DANI_LIB_RING_H
+#define __DANI_LIB_RING_H
+
+#ifdef DANI_RING_STATIC
+#define __DANI_RING_DEC static
+#define __DANI_RING_DEF static
+#else
+#define __DANI_RING_DEC extern
+#define __DANI_RING_DEF
+#endif
+
+#ifndef DANI_RING_FALSE_SHARING_SIZE
+#define DANI_RING_FALSE_SHARING_SIZE FALSE_SHARING_SIZE
+#endif
+
+typedef struct __DANI_RING dani_ring;
+struct CacheAligned __DANI_RING {
+    u8 *base;
+    u64 capacity;
+    HANDLE section;
+    u8 padding0[DANI_RING_FALSE_SHARING_SIZE - sizeof(u8 *) - sizeof(u64) - sizeof(HANDLE)];
+
+    // Written by the writer
+    volatile u64 write_position;
+    u64 write_offset;
+    u64 cached_read_position;
+    u64 read_position_load_count;
+    u8 padding1[DANI_RING_FALSE_SHARING_SIZE - 4 * sizeof(u64)];
+
+    // Written by the reader
+    volatile u64 read_position;
+    u64 read_offset;
+    u64 cached_write_position;
+    u64 write_position_load_count;
+    u8 padding2[DANI_RING_FALSE_SHARING_SIZE - 4 * sizeof(u64)];
+};
+
+__DANI_RING_DEC b32 dani_InitialiseRing(dani_ring *ring, u64 capacity);
+__DANI_RING_DEC void dani_ReleaseRing(dani_ring *ring);
+
+__DANI_RING_DEC u8 *dani_ReserveRingWrite(dani_ring *ring, u64 size);
+__DANI_RING_DEC void dani_CommitRingWrite(dani_ring *ring, u64 size);
+__DANI_RING_DEC u8 *dani_PeekRingRead(dani_ring *ring, u64 *available_size);
+__DANI_RING_DEC void dani_CommitRingRead(dani_ring *ring, u64 size);
+
+__DANI_RING_DEC b32 dani_WriteRing(dani_ring *ring, const void *data, u64 size);
+__DANI_RING_DEC b32 dani_ReadRing(dani_ring *ring, void *data, u64 size);
+
+#endif // __DANI_LIB_RING_H
+
+#ifdef DANI_LIB_RING_IMPLEMENTATION
+
+static void LoadRingReadPosition(dani_ring *ring) {
+    ring->cached_read_position = (u64)AtomicLoad64((volatile s64 *)&ring->read_position, MEMORY_ORDER_ACQUIRE);
+
+#ifdef DANI_RING_STATISTICS
+    ring->read_position_load_count += 1;
+#endif
+}
+
+static void LoadRingWritePosition(dani_ring *ring) {
+    ring->cached_write_position = (u64)AtomicLoad64((volatile s64 *)&ring->write_position, MEMORY_ORDER_ACQUIRE);
+
+#ifdef DANI_RING_STATISTICS
+    ring->write_position_load_count += 1;
+#endif
+}
+
+__DANI_RING_DEF b32 dani_InitialiseRing(dani_ring *ring, u64 capacity) {
+    memset(ring, 0, sizeof(*ring));
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    // Views have to start at a multiple of the allocation granularity
+    capacity = AlignPower2(Max(capacity, 1), (u64)system_info.dwAllocationGranularity);
+
+    // Reserve both halves as one placeholder and split it, so nobody else can map anything in between
+    u8 *placeholder = (u8 *)VirtualAlloc2(0, 0, 2 * capacity, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, 0, 0);
+    if (placeholder == 0) {
+        return (B32_FAILURE);
+    }
+    VirtualFree(placeholder, capacity, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER);
+
+    HANDLE section = CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, (DWORD)(capacity >> 32), (DWORD)capacity, 0);
+    if (section == 0) {
+        VirtualFree(placeholder, 0, MEM_RELEASE);
+        VirtualFree(placeholder + capacity, 0, MEM_RELEASE);
+        return (B32_FAILURE);
+    }
+
+    void *first_view = MapViewOfFile3(section, 0, placeholder, 0, capacity, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, 0, 0);
+    void *second_view = MapViewOfFile3(section, 0, placeholder + capacity, 0, capacity, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, 0, 0);
+    if (first_view == 0 || second_view == 0) {
+        if (first_view) {
+            UnmapViewOfFile(first_view);
+        } else {
+            VirtualFree(placeholder, 0, MEM_RELEASE);
+        }
+
+        if (second_view) {
+            UnmapViewOfFile(second_view);
+        } else {
+            VirtualFree(placeholder + capacity, 0, MEM_RELEASE);
+        }
+
+        CloseHandle(section);
+        return (B32_FAILURE);
+    }
+
+    ring->base = placeholder;
+    ring->capacity = capacity;
+    ring->section = section;
+
+    return (B32_SUCCESS);
+}
+
+__DANI_RING_DEF void dani_ReleaseRing(dani_ring *ring) {
+    if (ring->base) {
+        UnmapViewOfFile(ring->base);
+        UnmapViewOfFile(ring->base + ring->capacity);
+        CloseHandle(ring->section);
+    }
+
+    ring->base = 0;
+}
+
+__DANI_RING_DEF u8 *dani_ReserveRingWrite(dani_ring *ring, u64 size) {
+    u64 free_size = ring->capacity - (ring->write_position - ring->cached_read_position);
+    if (free_size < size) {
+        LoadRingReadPosition(ring);
+
+        free_size = ring->capacity - (ring->write_position - ring->cached_read_position);
+        if (free_size < size) {
+            return (0);
+        }
+    }
+
+    u8 *result = ring->base + ring->write_offset;
+    return (result);
+}
+
+__DANI_RING_DEF void dani_CommitRingWrite(dani_ring *ring, u64 size) {
+    Assert(size <= ring->capacity - (ring->write_position - ring->cached_read_position));
+
+    ring->write_offset += size;
+    if (ring->write_offset >= ring->capacity) {
+        ring->write_offset -= ring->capacity;
+    }
+
+    // The data has to be written before the reader can see the new position
+    AtomicStore64((volatile s64 *)&ring->write_position, (s64)(ring->write_position + size), MEMORY_ORDER_RELEASE);
+}
+
+__DANI_RING_DEF u8 *dani_PeekRingRead(dani_ring *ring, u64 *available_size) {
+    u64 size = ring->cached_write_position - ring->read_position;
+    if (size == 0) {
+        LoadRingWritePosition(ring);
+
+        size = ring->cached_write_position - ring->read_position;
+    }
+
+    *available_size = size;
+
+    u8 *result = ring->base + ring->read_offset;
+    return (result);
+}
+
+__DANI_RING_DEF void dani_CommitRingRead(dani_ring *ring, u64 size) {
+    Assert(size <= ring->cached_write_position - ring->read_position);
+
+    ring->read_offset += size;
+    if (ring->read_offset >= ring->capacity) {
+        ring->read_offset -= ring->capacity;
+    }
+
+    // The data has to be read before the writer can overwrite it
+    AtomicStore64((volatile s64 *)&ring->read_position, (s64)(ring->read_position + size), MEMORY_ORDER_RELEASE);
+}
+
+__DANI_RING_DEF b32 dani_WriteRing(dani_ring *ring, const void *data, u64 size) {
+    u8 *write = dani_ReserveRingWrite(ring, size);
+    if (write == 0) {
+        return (B32_FALSE);
+    }
+
+    memcpy(write, data, size);
+    dani_CommitRingWrite(ring, size);
+
+    return (B32_TRUE);
+}
+
+__DANI_RING_DEF b32 dani_ReadRing(dani_ring *ring, void *data, u64 size) {
+    u64 available_size;
+    u8 *read = dani_PeekRingRead(ring, &available_size);
+
+    if (available_size < size) {
+        // The cached position might just be behind
+        LoadRingWritePosition(ring);
+
+        available_size = ring->cached_write_position - ring->read_position;
+        if (available_size < size) {
+            return (B32_FALSE);
+        }
+    }
+
+    memcpy(data, read, size);
+    dani_CommitRingRead(ring, size);
+
+    return (B32_TRUE);
+}
+
+#endif // DANI_LIB_RING_IMPLEMENTATION
+
+/*
+Danilib - dani_ring.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
@@ -0,0 +1,588 @@
+// Danilib - dani_string.h
+// Types and functions for length based string slices and vectorised byte searches.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types, ByteSplat64, and bit scans
+// string.h - for memcpy and strlen
+// immintrin.h - for the SSE2 and AVX2 intrinsics on GCC and Clang. On MSVC intrin.h is enough, which is included by dani_base.h.
+//
+// Notes:
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_STRING_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_STRING_STATIC before including this file.
+// A dani_string is a pointer and a length. It doesn't own its memory and doesn't have to be zero terminated, so taking a part of a string never copies anything.
+// The functions that search a string return the index of the first match or the length of the string if there is none.
+// Every search function has three versions: SWAR, SSE2, and AVX2. SWAR works on 8 bytes at once in a u64 with ByteSplat64 and the "has zero byte" trick and runs everywhere. SSE2 is used on all x64 targets. AVX2 is used if the compiler targets it (/arch:AVX2 on MSVC, -mavx2 on GCC and Clang), there is no runtime check. To force the SWAR versions specify DANI_STRING_SWAR, to stop at SSE2 specify DANI_STRING_NO_AVX2 before including this file.
+// dani_FindStringAnyByte compares every position against every byte of the set, which is fast for small sets like separators. Sets with more than DANI_STRING_FIND_ANY_SET_MAX (default 16) bytes use a lookup table instead.
+// dani_ToLowerString only changes the ASCII letters A-Z, all other bytes (including UTF-8 sequences) stay as they are.
+//
+// How to use:
+//
+// dani_string text = dani_MakeString(file_data, file_size);
+// u64 line_count = dani_CountStringNewlines(text);
+//
+// while (text.length) {
+//     u64 line_end = dani_FindStringByte(text, '\n');
+//     dani_string line = dani_SubString(text, 0, line_end);
+//     text = dani_SkipString(text, line_end + 1);
+//
+//     u64 separator = dani_FindStringAnyByte(line, dani_StringLiteral(",;\t"));
+//     if (dani_IsStringEqual(dani_SubString(line, 0, separator), dani_StringLiteral("name"))) {
+//         // ...
+//     }
+// }
+//
+#ifndef __DANI_LIB_STRING_H
+#define __DANI_LIB_STRING_H
+
+#ifdef DANI_STRING_STATIC
+#define __DANI_STRING_DEC static
+#define __DANI_STRING_DEF static
+#else
+#define __DANI_STRING_DEC extern
+#define __DANI_STRING_DEF
+#endif
+
+#ifndef DANI_STRING_FIND_ANY_SET_MAX
+#define DANI_STRING_FIND_ANY_SET_MAX 16
+#endif
+
+typedef struct __DANI_STRING dani_string;
+struct __DANI_STRING {
+    u8 *data;
+    u64 length;
+};
+
+static __inline dani_string dani_MakeString(void *data, u64 length) {
+    dani_string result;
+    result.data = (u8 *)data;
+    result.length = length;
+    return (result);
+}
+
+#define dani_StringLiteral(literal) dani_MakeString((void *)(literal), sizeof(literal) - 1)
+#define dani_StringFromCString(c_string) dani_MakeString((void *)(c_string), strlen((const char *)(c_string)))
+
+__DANI_STRING_DEC dani_string dani_SubString(dani_string string, u64 first, u64 one_past_last);
+__DANI_STRING_DEC dani_string dani_SkipString(dani_string string, u64 count);
+
+__DANI_STRING_DEC u64 dani_FindStringByte(dani_string string, u8 byte);
+__DANI_STRING_DEC u64 dani_FindStringAnyByte(dani_string string, dani_string set);
+__DANI_STRING_DEC u64 dani_CountStringByte(dani_string string, u8 byte);
+__DANI_STRING_DEC s32 dani_CompareString(dani_string a, dani_string b);
+__DANI_STRING_DEC void dani_ToLowerString(dani_string string);
+
+#define dani_CountStringNewlines(string) dani_CountStringByte((string), '\n')
+#define dani_IsStringEqual(a, b) ((a).length == (b).length && dani_CompareString((a), (b)) == 0)
+
+#endif // __DANI_LIB_STRING_H
+
+#ifdef DANI_LIB_STRING_IMPLEMENTATION
+
+#if !defined(DANI_STRING_SWAR) && (defined(_M_X64) || defined(__SSE2__))
+#define DANI_STRING_SSE2 1
+#endif
+
+#if defined(DANI_STRING_SSE2) && defined(__AVX2__) && !defined(DANI_STRING_NO_AVX2)
+#define DANI_STRING_AVX2 1
+#endif
+
+__DANI_STRING_DEF dani_string dani_SubString(dani_string string, u64 first, u64 one_past_last) {
+    one_past_last = Min(one_past_last, string.length);
+    first = Min(first, one_past_last);
+
+    dani_string result = dani_MakeString(string.data + first, one_past_last - first);
+    return (result);
+}
+
+__DANI_STRING_DEF dani_string dani_SkipString(dani_string string, u64 count) {
+    count = Min(count, string.length);
+
+    dani_string result = dani_MakeString(string.data + count, string.length - count);
+    return (result);
+}
+
+// SWAR versions
+
+static u64 LoadStringWord(const u8 *data) {
+    u64 result;
+    memcpy(&result, data, sizeof(result));
+    return (result);
+}
+
+static u64 GetStringZeroByteMask(u64 word) {
+    // Sets the top bit of every byte that is zero. Unlike the shorter (word - 0x01...) & ~word & 0x80... version this has no false positives above a zero byte, so the bits can be counted.
+    u64 low_bits = (word & ByteSplat64(0x7Full)) + ByteSplat64(0x7Full);
+    u64 result = ~(low_bits | word | ByteSplat64(0x7Full));
+    return (result);
+}
+
+static b32 IsStringByteInSet(u8 byte, dani_string set) {
+    for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+        if (set.data[set_index] == byte) {
+            return (B32_TRUE);
+        }
+    }
+
+    return (B32_FALSE);
+}
+
+static u64 FindStringAnyByteTable(dani_string string, dani_string set) {
+    u8 table[256] = {0};
+    for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+        table[set.data[set_index]] = 1;
+    }
+
+    for (u64 index = 0; index < string.length; index += 1) {
+        if (table[string.data[index]]) {
+            return (index);
+        }
+    }
+
+    return (string.length);
+}
+
+static u64 FindStringByteSWAR(dani_string string, u8 byte) {
+    u64 pattern = ByteSplat64((u64)byte);
+
+    u64 index = 0;
+    for (; index + 8 <= string.length; index += 8) {
+        u64 mask = GetStringZeroByteMask(LoadStringWord(string.data + index) ^ pattern);
+        if (mask) {
+            return (index + (CountTrailingZeros64(mask) >> 3));
+        }
+    }
+
+    for (; index < string.length; index += 1) {
+        if (string.data[index] == byte) {
+            return (index);
+        }
+    }
+
+    return (string.length);
+}
+
+static u64 FindStringAnyByteSWAR(dani_string string, dani_string set) {
+    if (set.length > DANI_STRING_FIND_ANY_SET_MAX) {
+        return (FindStringAnyByteTable(string, set));
+    }
+
+    u64 patterns[DANI_STRING_FIND_ANY_SET_MAX];
+    for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+        patterns[set_index] = ByteSplat64((u64)set.data[set_index]);
+    }
+
+    u64 index = 0;
+    for (; index + 8 <= string.length; index += 8) {
+        u64 word = LoadStringWord(string.data + index);
+
+        u64 mask = 0;
+        for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+            mask |= GetStringZeroByteMask(word ^ patterns[set_index]);
+        }
+
+        if (mask) {
+            return (index + (CountTrailingZeros64(mask) >> 3));
+        }
+    }
+
+    for (; index < string.length; index += 1) {
+        if (IsStringByteInSet(string.data[index], set)) {
+            return (index);
+        }
+    }
+
+    return (string.length);
+}
+
+static u64 CountStringByteSWAR(dani_string string, u8 byte) {
+    u64 pattern = ByteSplat64((u64)byte);
+    u64 result = 0;
+
+    u64 index = 0;
+    for (; index + 8 <= string.length; index += 8) {
+        // Every matching byte becomes 1, the multiplication adds all bytes up in the top byte
+        u64 mask = GetStringZeroByteMask(LoadStringWord(string.data + index) ^ pattern);
+        result += ((mask >> 7) * ByteSplat64(0x01ull)) >> 56;
+    }
+
+    for (; index < string.length; index += 1) {
+        result += (string.data[index] == byte);
+    }
+
+    return (result);
+}
+
+static s32 CompareStringSWAR(dani_string a, dani_string b) {
+    u64 length = Min(a.length, b.length);
+
+    u64 index = 0;
+    for (; index + 8 <= length; index += 8) {
+        u64 difference = LoadStringWord(a.data + index) ^ LoadStringWord(b.data + index);
+        if (difference) {
+            index += CountTrailingZeros64(difference) >> 3;
+            return ((s32)a.data[index] - (s32)b.data[index]);
+        }
+    }
+
+    for (; index < length; index += 1) {
+        if (a.data[index] != b.data[index]) {
+            return ((s32)a.data[index] - (s32)b.data[index]);
+        }
+    }
+
+    s32 result = (a.length < b.length) ? -1 : (a.length > b.length) ? 1 : 0;
+    return (result);
+}
+
+static void ToLowerStringSWAR(dani_string string) {
+    u64 index = 0;
+    for (; index + 8 <= string.length; index += 8) {
+        u64 word = LoadStringWord(string.data + index);
+
+        // Adding to the lower 7 bits of every byte can't carry into the next byte. The top bit is set for bytes >= 'A' in one sum and for bytes > 'Z' in the other, so they only differ for upper case letters.
+        u64 low_bits = word & ByteSplat64(0x7Full);
+        u64 is_above_z = low_bits + ByteSplat64((u64)(0x7F - 'Z'));
+        u64 is_at_least_a = low_bits + ByteSplat64((u64)(0x80 - 'A'));
+        u64 is_upper = (is_at_least_a ^ is_above_z) & ~word & ByteSplat64(0x80ull);
+
+        word |= is_upper >> 2;
+        memcpy(string.data + index, &word, sizeof(word));
+    }
+
+    for (; index < string.length; index += 1) {
+        u8 byte = string.data[index];
+        if (byte >= 'A' && byte <= 'Z') {
+            string.data[index] = byte | 0x20;
+        }
+    }
+}
+
+// SSE2 versions
+
+#ifdef DANI_STRING_SSE2
+static u64 FindStringByteSSE2(dani_string string, u8 byte) {
+    __m128i pattern = _mm_set1_epi8((char)byte);
+
+    u64 index = 0;
+    for (; index + 64 <= string.length; index += 64) {
+        // Four chunks per iteration with a single branch, the masks are only combined once a chunk matched
+        const __m128i *chunks = (const __m128i *)(string.data + index);
+        __m128i matches0 = _mm_cmpeq_epi8(_mm_loadu_si128(chunks + 0), pattern);
+        __m128i matches1 = _mm_cmpeq_epi8(_mm_loadu_si128(chunks + 1), pattern);
+        __m128i matches2 = _mm_cmpeq_epi8(_mm_loadu_si128(chunks + 2), pattern);
+        __m128i matches3 = _mm_cmpeq_epi8(_mm_loadu_si128(chunks + 3), pattern);
+
+        __m128i any_matches = _mm_or_si128(_mm_or_si128(matches0, matches1), _mm_or_si128(matches2, matches3));
+        if (_mm_movemask_epi8(any_matches)) {
+            u64 mask = (u64)(u32)_mm_movemask_epi8(matches0) | ((u64)(u32)_mm_movemask_epi8(matches1) << 16) |
+                       ((u64)(u32)_mm_movemask_epi8(matches2) << 32) | ((u64)(u32)_mm_movemask_epi8(matches3) << 48);
+            return (index + CountTrailingZeros64(mask));
+        }
+    }
+
+    for (; index + 16 <= string.length; index += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(string.data + index));
+        u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern));
+        if (mask) {
+            return (index + CountTrailingZeros32(mask));
+        }
+    }
+
+    dani_string rest = dani_SkipString(string, index);
+    return (index + FindStringByteSWAR(rest, byte));
+}
+
+static u64 FindStringAnyByteSSE2(dani_string string, dani_string set) {
+    if (set.length > DANI_STRING_FIND_ANY_SET_MAX) {
+        return (FindStringAnyByteTable(string, set));
+    }
+
+    __m128i patterns[DANI_STRING_FIND_ANY_SET_MAX];
+    for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+        patterns[set_index] = _mm_set1_epi8((char)set.data[set_index]);
+    }
+
+    u64 index = 0;
+    for (; index + 16 <= string.length; index += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(string.data + index));
+
+        __m128i matches = _mm_setzero_si128();
+        for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, patterns[set_index]));
+        }
+
+        u32 mask = (u32)_mm_movemask_epi8(matches);
+        if (mask) {
+            return (index + CountTrailingZeros32(mask));
+        }
+    }
+
+    dani_string rest = dani_SkipString(string, index);
+    return (index + FindStringAnyByteSWAR(rest, set));
+}
+
+static u64 CountStringByteSSE2(dani_string string, u8 byte) {
+    __m128i pattern = _mm_set1_epi8((char)byte);
+    __m128i totals = _mm_setzero_si128();
+
+    u64 index = 0;
+    while (index + 16 <= string.length) {
+        // Matches are -1, so subtracting them counts up every byte lane. A lane overflows after 255 chunks, then the lanes are summed into the totals with psadbw.
+        u64 chunk_count = Min((string.length - index) / 16, 255);
+        __m128i counts = _mm_setzero_si128();
+        for (u64 chunk_index = 0; chunk_index < chunk_count; chunk_index += 1) {
+            __m128i chunk = _mm_loadu_si128((const __m128i *)(string.data + index));
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(chunk, pattern));
+            index += 16;
+        }
+
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(counts, _mm_setzero_si128()));
+    }
+
+    u64 result = (u64)_mm_cvtsi128_si64(totals) + (u64)_mm_cvtsi128_si64(_mm_unpackhi_epi64(totals, totals));
+
+    dani_string rest = dani_SkipString(string, index);
+    result += CountStringByteSWAR(rest, byte);
+    return (result);
+}
+
+static s32 CompareStringSSE2(dani_string a, dani_string b) {
+    u64 length = Min(a.length, b.length);
+
+    u64 index = 0;
+    for (; index + 64 <= length; index += 64) {
+        // Equal chunks are skipped four at a time, a difference is located by the loop below
+        const __m128i *chunks_a = (const __m128i *)(a.data + index);
+        const __m128i *chunks_b = (const __m128i *)(b.data + index);
+        __m128i equal01 = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(chunks_a + 0), _mm_loadu_si128(chunks_b + 0)), _mm_cmpeq_epi8(_mm_loadu_si128(chunks_a + 1), _mm_loadu_si128(chunks_b + 1)));
+        __m128i equal23 = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(chunks_a + 2), _mm_loadu_si128(chunks_b + 2)), _mm_cmpeq_epi8(_mm_loadu_si128(chunks_a + 3), _mm_loadu_si128(chunks_b + 3)));
+        if (_mm_movemask_epi8(_mm_and_si128(equal01, equal23)) != 0xFFFF) {
+            break;
+        }
+    }
+
+    for (; index + 16 <= length; index += 16) {
+        __m128i chunk_a = _mm_loadu_si128((const __m128i *)(a.data + index));
+        __m128i chunk_b = _mm_loadu_si128((const __m128i *)(b.data + index));
+        u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b));
+        if (mask != 0xFFFF) {
+            index += CountTrailingZeros32(~mask);
+            return ((s32)a.data[index] - (s32)b.data[index]);
+        }
+    }
+
+    s32 result = CompareStringSWAR(dani_SkipString(a, index), dani_SkipString(b, index));
+    return (result);
+}
+
+static void ToLowerStringSSE2(dani_string string) {
+    // Bytes >= 0x80 are negative in the signed compares, so they are never treated as letters
+    __m128i before_a = _mm_set1_epi8('A' - 1);
+    __m128i after_z = _mm_set1_epi8('Z' + 1);
+    __m128i lower_case_bit = _mm_set1_epi8(0x20);
+
+    u64 index = 0;
+    for (; index + 16 <= string.length; index += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(string.data + index));
+        __m128i is_upper = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_a), _mm_cmplt_epi8(chunk, after_z));
+        chunk = _mm_or_si128(chunk, _mm_and_si128(is_upper, lower_case_bit));
+        _mm_storeu_si128((__m128i *)(string.data + index), chunk);
+    }
+
+    ToLowerStringSWAR(dani_SkipString(string, index));
+}
+#endif // DANI_STRING_SSE2
+
+// AVX2 versions
+
+#ifdef DANI_STRING_AVX2
+static u64 FindStringByteAVX2(dani_string string, u8 byte) {
+    __m256i pattern = _mm256_set1_epi8((char)byte);
+
+    u64 index = 0;
+    for (; index + 64 <= string.length; index += 64) {
+        const __m256i *chunks = (const __m256i *)(string.data + index);
+        __m256i matches0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(chunks + 0), pattern);
+        __m256i matches1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(chunks + 1), pattern);
+
+        if (_mm256_movemask_epi8(_mm256_or_si256(matches0, matches1))) {
+            u64 mask = (u64)(u32)_mm256_movemask_epi8(matches0) | ((u64)(u32)_mm256_movemask_epi8(matches1) << 32);
+            return (index + CountTrailingZeros64(mask));
+        }
+    }
+
+    for (; index + 32 <= string.length; index += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(string.data + index));
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, pattern));
+        if (mask) {
+            return (index + CountTrailingZeros32(mask));
+        }
+    }
+
+    dani_string rest = dani_SkipString(string, index);
+    return (index + FindStringByteSSE2(rest, byte));
+}
+
+static u64 FindStringAnyByteAVX2(dani_string string, dani_string set) {
+    if (set.length > DANI_STRING_FIND_ANY_SET_MAX) {
+        return (FindStringAnyByteTable(string, set));
+    }
+
+    __m256i patterns[DANI_STRING_FIND_ANY_SET_MAX];
+    for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+        patterns[set_index] = _mm256_set1_epi8((char)set.data[set_index]);
+    }
+
+    u64 index = 0;
+    for (; index + 32 <= string.length; index += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(string.data + index));
+
+        __m256i matches = _mm256_setzero_si256();
+        for (u64 set_index = 0; set_index < set.length; set_index += 1) {
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(chunk, patterns[set_index]));
+        }
+
+        u32 mask = (u32)_mm256_movemask_epi8(matches);
+        if (mask) {
+            return (index + CountTrailingZeros32(mask));
+        }
+    }
+
+    dani_string rest = dani_SkipString(string, index);
+    return (index + FindStringAnyByteSSE2(rest, set));
+}
+
+static u64 CountStringByteAVX2(dani_string string, u8 byte) {
+    __m256i pattern = _mm256_set1_epi8((char)byte);
+    __m256i totals = _mm256_setzero_si256();
+
+    u64 index = 0;
+    while (index + 32 <= string.length) {
+        u64 chunk_count = Min((string.length - index) / 32, 255);
+        __m256i counts = _mm256_setzero_si256();
+        for (u64 chunk_index = 0; chunk_index < chunk_count; chunk_index += 1) {
+            __m256i chunk = _mm256_loadu_si256((const __m256i *)(string.data + index));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(chunk, pattern));
+            index += 32;
+        }
+
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    __m128i half_totals = _mm_add_epi64(_mm256_castsi256_si128(totals), _mm256_extracti128_si256(totals, 1));
+    u64 result = (u64)_mm_cvtsi128_si64(half_totals) + (u64)_mm_cvtsi128_si64(_mm_unpackhi_epi64(half_totals, half_totals));
+
+    dani_string rest = dani_SkipString(string, index);
+    result += CountStringByteSSE2(rest, byte);
+    return (result);
+}
+
+static s32 CompareStringAVX2(dani_string a, dani_string b) {
+    u64 length = Min(a.length, b.length);
+
+    u64 index = 0;
+    for (; index + 64 <= length; index += 64) {
+        const __m256i *chunks_a = (const __m256i *)(a.data + index);
+        const __m256i *chunks_b = (const __m256i *)(b.data + index);
+        __m256i equal = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(chunks_a + 0), _mm256_loadu_si256(chunks_b + 0)), _mm256_cmpeq_epi8(_mm256_loadu_si256(chunks_a + 1), _mm256_loadu_si256(chunks_b + 1)));
+        if ((u32)_mm256_movemask_epi8(equal) != 0xFFFFFFFF) {
+            break;
+        }
+    }
+
+    for (; index + 32 <= length; index += 32) {
+        __m256i chunk_a = _mm256_loadu_si256((const __m256i *)(a.data + index));
+        __m256i chunk_b = _mm256_loadu_si256((const __m256i *)(b.data + index));
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk_a, chunk_b));
+        if (mask != 0xFFFFFFFF) {
+            index += CountTrailingZeros32(~mask);
+            return ((s32)a.data[index] - (s32)b.data[index]);
+        }
+    }
+
+    s32 result = CompareStringSSE2(dani_SkipString(a, index), dani_SkipString(b, index));
+    return (result);
+}
+
+static void ToLowerStringAVX2(dani_string string) {
+    __m256i before_a = _mm256_set1_epi8('A' - 1);
+    __m256i after_z = _mm256_set1_epi8('Z' + 1);
+    __m256i lower_case_bit = _mm256_set1_epi8(0x20);
+
+    u64 index = 0;
+    for (; index + 32 <= string.length; index += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(string.data + index));
+        __m256i is_upper = _mm256_and_si256(_mm256_cmpgt_epi8(chunk, before_a), _mm256_cmpgt_epi8(after_z, chunk));
+        chunk = _mm256_or_si256(chunk, _mm256_and_si256(is_upper, lower_case_bit));
+        _mm256_storeu_si256((__m256i *)(string.data + index), chunk);
+    }
+
+    ToLowerStringSSE2(dani_SkipString(string, index));
+}
+#endif // DANI_STRING_AVX2
+
+#if defined(DANI_STRING_AVX2)
+#define __DANI_STRING_VERSION(name) name##AVX2
+#elif defined(DANI_STRING_SSE2)
+#define __DANI_STRING_VERSION(name) name##SSE2
+#else
+#define __DANI_STRING_VERSION(name) name##SWAR
+#endif
+
+__DANI_STRING_DEF u64 dani_FindStringByte(dani_string string, u8 byte) {
+    u64 result = __DANI_STRING_VERSION(FindStringByte)(string, byte);
+    return (result);
+}
+
+__DANI_STRING_DEF u64 dani_FindStringAnyByte(dani_string string, dani_string set) {
+    u64 result = __DANI_STRING_VERSION(FindStringAnyByte)(string, set);
+    return (result);
+}
+
+__DANI_STRING_DEF u64 dani_CountStringByte(dani_string string, u8 byte) {
+    u64 result = __DANI_STRING_VERSION(CountStringByte)(string, byte);
+    return (result);
+}
+
+__DANI_STRING_DEF s32 dani_CompareString(dani_string a, dani_string b) {
+    s32 result = __DANI_STRING_VERSION(CompareString)(a, b);
+    return (result);
+}
+
+__DANI_STRING_DEF void dani_ToLowerString(dani_string string) {
+    __DANI_STRING_VERSION(ToLowerString)(string);
+}
+
+#endif // DANI_LIB_STRING_IMPLEMENTATION
+
+/*
+Danilib - dani_string.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
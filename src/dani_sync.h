@@ -0,0 +1,515 @@
+// Danilib - dani_sync.h
+// Types and functions for lightweight synchronisation primitives: an adaptive mutex, a ticket lock, events, and a semaphore.
+//
+// Author: Dani Drywa (dani@drywa.me)
+// The mutex is based on the paper "Futexes Are Tricky" by Ulrich Drepper.
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types and atomics
+// Windows.h - for WaitOnAddress, WakeByAddressSingle, WakeByAddressAll, and SwitchToThread. Requires Windows 8 or newer. Link with Synchronization.lib.
+// string.h - for memset
+// dani_profiler.h - for dani_GetProfilerLockIndex, dani_RecordProfilingLockAcquire, and dani_RecordProfilingLockHold if DANI_SYNC_STATISTICS is enabled.
+//
+// Notes:
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_SYNC_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_SYNC_STATIC before including this file.
+// All primitives live in user memory and never need to be released. A primitive that was zeroed is initialised, the initialise functions only exist to set the name and the event type.
+// Waiting threads first spin for DANI_SYNC_SPIN_COUNT (default 128) attempts before they go to sleep with WaitOnAddress, which is the Windows version of a futex. Releasing a primitive only calls into WakeByAddress if somebody is actually sleeping on it.
+// dani_sync_mutex is a single 32 bit value (unless DANI_SYNC_STATISTICS is enabled). It is unlocked (0), locked (1), or locked with possible sleepers (2). Lock and unlock are a single interlocked operation each as long as nobody has to sleep. The mutex is not recursive and not fair.
+// dani_ticket_lock hands out the lock in the order of arrival and never sleeps. Waiters back off proportionally to their distance from the current owner and give up the rest of their time slice with SwitchToThread once they spun DANI_SYNC_SPIN_COUNT times. Only use it for very short critical sections with fewer threads than logical processors, a preempted waiter blocks everybody behind it until it gets to run again.
+// dani_sync_event is either one-shot or auto-reset. A one-shot event stays signaled forever after it was signaled the first time and releases every waiter. An auto-reset event releases exactly one waiter per signal and resets itself. Signals on an auto-reset event that is already signaled are lost, just like with SetEvent.
+// dani_sync_semaphore is a counting semaphore. Posting N releases up to N waiters.
+// To count how often each primitive was acquired, how often it was contended, how often a waiter had to sleep, and how long waiters waited in total, specify DANI_SYNC_STATISTICS before including this file. The counters are kept in the statistics member of every primitive and are also reported as locks by dani_PrintProfilingResults, which charges the wait time to the zone that was active while waiting. The mutex and ticket lock report their hold time as well.
+//
+// How to use:
+//
+// static dani_sync_mutex mutex; // Zero is unlocked
+// dani_InitialiseSyncMutex(&mutex, "Queue Lock"); // Only needed for the name used by DANI_SYNC_STATISTICS
+// dani_LockSyncMutex(&mutex);
+// // Critical section
+// dani_UnlockSyncMutex(&mutex);
+//
+// dani_sync_event is_ready;
+// dani_InitialiseSyncEvent(&is_ready, B32_FALSE, "Ready"); // B32_FALSE for one-shot, B32_TRUE for auto-reset
+// // Thread A
+// dani_SignalSyncEvent(&is_ready);
+// // Thread B
+// dani_WaitSyncEvent(&is_ready);
+//
+// dani_sync_semaphore free_slots;
+// dani_InitialiseSyncSemaphore(&free_slots, slot_count, "Free Slots");
+// dani_WaitSyncSemaphore(&free_slots);
+// dani_PostSyncSemaphore(&free_slots, 1);
+//
+#ifndef __DANI_LIB_SYNC_H
+#define __DANI_LIB_SYNC_H
+
+#ifdef DANI_SYNC_STATIC
+#define __DANI_SYNC_DEC static
+#define __DANI_SYNC_DEF static
+#else
+#define __DANI_SYNC_DEC extern
+#define __DANI_SYNC_DEF
+#endif
+
+#ifndef DANI_SYNC_SPIN_COUNT
+#define DANI_SYNC_SPIN_COUNT 128
+#endif
+
+#ifdef DANI_SYNC_STATISTICS
+typedef struct __DANI_SYNC_STATISTICS dani_sync_statistics;
+struct __DANI_SYNC_STATISTICS {
+    volatile s64 acquire_counter;
+    volatile s64 contended_counter;
+    volatile s64 sleep_counter;
+    volatile s64 wait_ticks;
+    volatile s64 hold_ticks;
+    u64 acquire_ticks; // Only used by the mutex and the ticket lock, which have a single owner
+
+    const s8 *name;
+    u32 lock_index;
+};
+#endif // DANI_SYNC_STATISTICS
+
+typedef struct __DANI_SYNC_MUTEX dani_sync_mutex;
+struct __DANI_SYNC_MUTEX {
+    volatile s32 state;
+
+#ifdef DANI_SYNC_STATISTICS
+    dani_sync_statistics statistics;
+#endif // DANI_SYNC_STATISTICS
+};
+
+typedef struct __DANI_TICKET_LOCK dani_ticket_lock;
+struct __DANI_TICKET_LOCK {
+    volatile s32 next_ticket;
+    volatile s32 serving_ticket;
+
+#ifdef DANI_SYNC_STATISTICS
+    dani_sync_statistics statistics;
+#endif // DANI_SYNC_STATISTICS
+};
+
+typedef struct __DANI_SYNC_EVENT dani_sync_event;
+struct __DANI_SYNC_EVENT {
+    volatile s32 is_signaled;
+    volatile s32 sleeper_count;
+    b32 is_auto_reset;
+
+#ifdef DANI_SYNC_STATISTICS
+    dani_sync_statistics statistics;
+#endif // DANI_SYNC_STATISTICS
+};
+
+typedef struct __DANI_SYNC_SEMAPHORE dani_sync_semaphore;
+struct __DANI_SYNC_SEMAPHORE {
+    volatile s32 count;
+    volatile s32 sleeper_count;
+
+#ifdef DANI_SYNC_STATISTICS
+    dani_sync_statistics statistics;
+#endif // DANI_SYNC_STATISTICS
+};
+
+__DANI_SYNC_DEC void dani_InitialiseSyncMutex(dani_sync_mutex *mutex, const s8 *name);
+__DANI_SYNC_DEC b32 dani_TryLockSyncMutex(dani_sync_mutex *mutex);
+__DANI_SYNC_DEC void dani_LockSyncMutex(dani_sync_mutex *mutex);
+__DANI_SYNC_DEC void dani_UnlockSyncMutex(dani_sync_mutex *mutex);
+
+__DANI_SYNC_DEC void dani_InitialiseTicketLock(dani_ticket_lock *lock, const s8 *name);
+__DANI_SYNC_DEC void dani_LockTicketLock(dani_ticket_lock *lock);
+__DANI_SYNC_DEC void dani_UnlockTicketLock(dani_ticket_lock *lock);
+
+__DANI_SYNC_DEC void dani_InitialiseSyncEvent(dani_sync_event *event, b32 is_auto_reset, const s8 *name);
+__DANI_SYNC_DEC void dani_SignalSyncEvent(dani_sync_event *event);
+__DANI_SYNC_DEC b32 dani_TryWaitSyncEvent(dani_sync_event *event);
+__DANI_SYNC_DEC void dani_WaitSyncEvent(dani_sync_event *event);
+
+__DANI_SYNC_DEC void dani_InitialiseSyncSemaphore(dani_sync_semaphore *semaphore, s32 count, const s8 *name);
+__DANI_SYNC_DEC void dani_PostSyncSemaphore(dani_sync_semaphore *semaphore, s32 count);
+__DANI_SYNC_DEC b32 dani_TryWaitSyncSemaphore(dani_sync_semaphore *semaphore);
+__DANI_SYNC_DEC void dani_WaitSyncSemaphore(dani_sync_semaphore *semaphore);
+
+#endif // __DANI_LIB_SYNC_H
+
+#ifdef DANI_LIB_SYNC_IMPLEMENTATION
+
+#define DANI_SYNC_MUTEX_UNLOCKED 0
+#define DANI_SYNC_MUTEX_LOCKED 1
+#define DANI_SYNC_MUTEX_SLEEPING 2
+
+#ifdef DANI_SYNC_STATISTICS
+static void InitialiseSyncStatistics(dani_sync_statistics *statistics, const s8 *name) {
+    memset(statistics, 0, sizeof(*statistics));
+    statistics->name = name;
+    statistics->lock_index = dani_GetProfilerLockIndex(name);
+}
+
+static u64 RecordSyncAcquire(dani_sync_statistics *statistics, u64 wait_start_ticks, b32 has_slept) {
+    u64 acquire_ticks = __rdtsc();
+
+    AtomicAdd64(&statistics->acquire_counter, 1, MEMORY_ORDER_RELAXED);
+    if (wait_start_ticks) {
+        AtomicAdd64(&statistics->contended_counter, 1, MEMORY_ORDER_RELAXED);
+        AtomicAdd64(&statistics->wait_ticks, (s64)(acquire_ticks - wait_start_ticks), MEMORY_ORDER_RELAXED);
+    }
+    if (has_slept) {
+        AtomicAdd64(&statistics->sleep_counter, 1, MEMORY_ORDER_RELAXED);
+    }
+
+    dani_RecordProfilingLockAcquire(statistics->lock_index, statistics->name, wait_start_ticks, acquire_ticks);
+    return (acquire_ticks);
+}
+
+static void RecordSyncRelease(dani_sync_statistics *statistics) {
+    u64 hold_ticks = __rdtsc() - statistics->acquire_ticks;
+
+    AtomicAdd64(&statistics->hold_ticks, (s64)hold_ticks, MEMORY_ORDER_RELAXED);
+    dani_RecordProfilingLockHold(statistics->lock_index, hold_ticks);
+}
+#endif // DANI_SYNC_STATISTICS
+
+__DANI_SYNC_DEF void dani_InitialiseSyncMutex(dani_sync_mutex *mutex, const s8 *name) {
+    mutex->state = DANI_SYNC_MUTEX_UNLOCKED;
+
+#ifdef DANI_SYNC_STATISTICS
+    InitialiseSyncStatistics(&mutex->statistics, name);
+#else
+    Unused(name);
+#endif // DANI_SYNC_STATISTICS
+}
+
+static b32 LockSyncMutexContended(dani_sync_mutex *mutex) {
+    // The owner is most likely about to leave a short critical section, so spinning is cheaper than sleeping
+    for (u32 spin_count = 0; spin_count < DANI_SYNC_SPIN_COUNT; spin_count += 1) {
+        CpuPause();
+
+        s32 state = AtomicLoad32(&mutex->state, MEMORY_ORDER_RELAXED);
+        if (state == DANI_SYNC_MUTEX_UNLOCKED && AtomicCompareExchange32(&mutex->state, DANI_SYNC_MUTEX_UNLOCKED, DANI_SYNC_MUTEX_LOCKED, MEMORY_ORDER_ACQUIRE) == DANI_SYNC_MUTEX_UNLOCKED) {
+            return (B32_FALSE);
+        }
+    }
+
+    // Mark the mutex as having sleepers before going to sleep, so the owner knows it has to wake somebody.
+    // The mutex stays marked after this thread got it, because there might be other sleepers left.
+    // Only an actual WaitOnAddress counts as sleeping, the first exchange can already get the mutex.
+    s32 sleeping_state = DANI_SYNC_MUTEX_SLEEPING;
+    b32 has_slept = B32_FALSE;
+    while (AtomicExchange32(&mutex->state, DANI_SYNC_MUTEX_SLEEPING, MEMORY_ORDER_ACQUIRE) != DANI_SYNC_MUTEX_UNLOCKED) {
+        WaitOnAddress((volatile VOID *)&mutex->state, &sleeping_state, sizeof(sleeping_state), INFINITE);
+        has_slept = B32_TRUE;
+    }
+
+    return (has_slept);
+}
+
+__DANI_SYNC_DEF b32 dani_TryLockSyncMutex(dani_sync_mutex *mutex) {
+    if (AtomicCompareExchange32(&mutex->state, DANI_SYNC_MUTEX_UNLOCKED, DANI_SYNC_MUTEX_LOCKED, MEMORY_ORDER_ACQUIRE) != DANI_SYNC_MUTEX_UNLOCKED) {
+        return (B32_FALSE);
+    }
+
+#ifdef DANI_SYNC_STATISTICS
+    mutex->statistics.acquire_ticks = RecordSyncAcquire(&mutex->statistics, 0, B32_FALSE);
+#endif // DANI_SYNC_STATISTICS
+
+    return (B32_TRUE);
+}
+
+__DANI_SYNC_DEF void dani_LockSyncMutex(dani_sync_mutex *mutex) {
+#ifdef DANI_SYNC_STATISTICS
+    u64 wait_start_ticks = 0;
+    b32 has_slept = B32_FALSE;
+    if (AtomicCompareExchange32(&mutex->state, DANI_SYNC_MUTEX_UNLOCKED, DANI_SYNC_MUTEX_LOCKED, MEMORY_ORDER_ACQUIRE) != DANI_SYNC_MUTEX_UNLOCKED) {
+        wait_start_ticks = __rdtsc();
+        has_slept = LockSyncMutexContended(mutex);
+    }
+
+    mutex->statistics.acquire_ticks = RecordSyncAcquire(&mutex->statistics, wait_start_ticks, has_slept);
+#else
+    if (AtomicCompareExchange32(&mutex->state, DANI_SYNC_MUTEX_UNLOCKED, DANI_SYNC_MUTEX_LOCKED, MEMORY_ORDER_ACQUIRE) != DANI_SYNC_MUTEX_UNLOCKED) {
+        LockSyncMutexContended(mutex);
+    }
+#endif // DANI_SYNC_STATISTICS
+}
+
+__DANI_SYNC_DEF void dani_UnlockSyncMutex(dani_sync_mutex *mutex) {
+#ifdef DANI_SYNC_STATISTICS
+    RecordSyncRelease(&mutex->statistics);
+#endif // DANI_SYNC_STATISTICS
+
+    if (AtomicExchange32(&mutex->state, DANI_SYNC_MUTEX_UNLOCKED, MEMORY_ORDER_RELEASE) == DANI_SYNC_MUTEX_SLEEPING) {
+        WakeByAddressSingle((PVOID)&mutex->state);
+    }
+}
+
+__DANI_SYNC_DEF void dani_InitialiseTicketLock(dani_ticket_lock *lock, const s8 *name) {
+    lock->next_ticket = 0;
+    lock->serving_ticket = 0;
+
+#ifdef DANI_SYNC_STATISTICS
+    InitialiseSyncStatistics(&lock->statistics, name);
+#else
+    Unused(name);
+#endif // DANI_SYNC_STATISTICS
+}
+
+__DANI_SYNC_DEF void dani_LockTicketLock(dani_ticket_lock *lock) {
+    s32 ticket = AtomicAdd32(&lock->next_ticket, 1, MEMORY_ORDER_RELAXED);
+
+#ifdef DANI_SYNC_STATISTICS
+    u64 wait_start_ticks = 0;
+#endif // DANI_SYNC_STATISTICS
+
+    // The distance wraps around together with the tickets, so it stays correct after 2^32 acquires
+    s32 distance;
+    u32 spin_count = 0;
+    while ((distance = ticket - AtomicLoad32(&lock->serving_ticket, MEMORY_ORDER_ACQUIRE)) != 0) {
+#ifdef DANI_SYNC_STATISTICS
+        if (wait_start_ticks == 0) {
+            wait_start_ticks = __rdtsc();
+        }
+#endif // DANI_SYNC_STATISTICS
+
+        // Every waiter in front of this one needs at least a short critical section, so there is no point in checking more often
+        for (s32 pause_index = 0; pause_index < distance; pause_index += 1) {
+            CpuPause();
+        }
+
+        // The owner or a waiter in front of this one might not be running at all, so let them have the core
+        spin_count += 1;
+        if (spin_count >= DANI_SYNC_SPIN_COUNT) {
+            SwitchToThread();
+            spin_count = 0;
+        }
+    }
+
+#ifdef DANI_SYNC_STATISTICS
+    lock->statistics.acquire_ticks = RecordSyncAcquire(&lock->statistics, wait_start_ticks, B32_FALSE);
+#endif // DANI_SYNC_STATISTICS
+}
+
+__DANI_SYNC_DEF void dani_UnlockTicketLock(dani_ticket_lock *lock) {
+#ifdef DANI_SYNC_STATISTICS
+    RecordSyncRelease(&lock->statistics);
+#endif // DANI_SYNC_STATISTICS
+
+    // Only the owner writes the serving ticket, so it doesn't need an interlocked increment
+    AtomicStore32(&lock->serving_ticket, lock->serving_ticket + 1, MEMORY_ORDER_RELEASE);
+}
+
+__DANI_SYNC_DEF void dani_InitialiseSyncEvent(dani_sync_event *event, b32 is_auto_reset, const s8 *name) {
+    event->is_signaled = B32_FALSE;
+    event->sleeper_count = 0;
+    event->is_auto_reset = is_auto_reset;
+
+#ifdef DANI_SYNC_STATISTICS
+    InitialiseSyncStatistics(&event->statistics, name);
+#else
+    Unused(name);
+#endif // DANI_SYNC_STATISTICS
+}
+
+__DANI_SYNC_DEF void dani_SignalSyncEvent(dani_sync_event *event) {
+    AtomicExchange32(&event->is_signaled, B32_TRUE, MEMORY_ORDER_SEQ_CST);
+
+    // A sleeper registers itself before it checks the event one last time, so it either sees the signal or gets woken up
+    if (AtomicLoad32(&event->sleeper_count, MEMORY_ORDER_SEQ_CST) > 0) {
+        if (event->is_auto_reset) {
+            WakeByAddressSingle((PVOID)&event->is_signaled);
+        } else {
+            WakeByAddressAll((PVOID)&event->is_signaled);
+        }
+    }
+}
+
+static b32 ConsumeSyncEvent(dani_sync_event *event) {
+    b32 result;
+
+    if (event->is_auto_reset) {
+        result = (AtomicCompareExchange32(&event->is_signaled, B32_TRUE, B32_FALSE, MEMORY_ORDER_ACQUIRE) == B32_TRUE);
+    } else {
+        result = (AtomicLoad32(&event->is_signaled, MEMORY_ORDER_ACQUIRE) == B32_TRUE);
+    }
+
+    return (result);
+}
+
+__DANI_SYNC_DEF b32 dani_TryWaitSyncEvent(dani_sync_event *event) {
+    b32 result = ConsumeSyncEvent(event);
+
+#ifdef DANI_SYNC_STATISTICS
+    if (result) {
+        RecordSyncAcquire(&event->statistics, 0, B32_FALSE);
+    }
+#endif // DANI_SYNC_STATISTICS
+
+    return (result);
+}
+
+__DANI_SYNC_DEF void dani_WaitSyncEvent(dani_sync_event *event) {
+    if (ConsumeSyncEvent(event)) {
+#ifdef DANI_SYNC_STATISTICS
+        RecordSyncAcquire(&event->statistics, 0, B32_FALSE);
+#endif // DANI_SYNC_STATISTICS
+        return;
+    }
+
+#ifdef DANI_SYNC_STATISTICS
+    u64 wait_start_ticks = __rdtsc();
+#endif // DANI_SYNC_STATISTICS
+
+    for (u32 spin_count = 0; spin_count < DANI_SYNC_SPIN_COUNT; spin_count += 1) {
+        CpuPause();
+
+        if (AtomicLoad32(&event->is_signaled, MEMORY_ORDER_RELAXED) && ConsumeSyncEvent(event)) {
+#ifdef DANI_SYNC_STATISTICS
+            RecordSyncAcquire(&event->statistics, wait_start_ticks, B32_FALSE);
+#endif // DANI_SYNC_STATISTICS
+            return;
+        }
+    }
+
+    AtomicIncrement32(&event->sleeper_count);
+
+    s32 unsignaled_state = B32_FALSE;
+    b32 has_slept = B32_FALSE;
+    while (IsFalse(ConsumeSyncEvent(event))) {
+        WaitOnAddress((volatile VOID *)&event->is_signaled, &unsignaled_state, sizeof(unsignaled_state), INFINITE);
+        has_slept = B32_TRUE;
+    }
+
+    AtomicDecrement32(&event->sleeper_count);
+
+#ifdef DANI_SYNC_STATISTICS
+    RecordSyncAcquire(&event->statistics, wait_start_ticks, has_slept);
+#else
+    Unused(has_slept);
+#endif // DANI_SYNC_STATISTICS
+}
+
+__DANI_SYNC_DEF void dani_InitialiseSyncSemaphore(dani_sync_semaphore *semaphore, s32 count, const s8 *name) {
+    Assert(count >= 0);
+
+    semaphore->count = count;
+    semaphore->sleeper_count = 0;
+
+#ifdef DANI_SYNC_STATISTICS
+    InitialiseSyncStatistics(&semaphore->statistics, name);
+#else
+    Unused(name);
+#endif // DANI_SYNC_STATISTICS
+}
+
+__DANI_SYNC_DEF void dani_PostSyncSemaphore(dani_sync_semaphore *semaphore, s32 count) {
+    Assert(count > 0);
+
+    AtomicAdd32(&semaphore->count, count, MEMORY_ORDER_SEQ_CST);
+
+    // A sleeper registers itself before it checks the count one last time, so it either sees the new count or gets woken up
+    if (AtomicLoad32(&semaphore->sleeper_count, MEMORY_ORDER_SEQ_CST) > 0) {
+        if (count == 1) {
+            WakeByAddressSingle((PVOID)&semaphore->count);
+        } else {
+            WakeByAddressAll((PVOID)&semaphore->count);
+        }
+    }
+}
+
+static b32 DecrementSyncSemaphore(dani_sync_semaphore *semaphore) {
+    s32 count = AtomicLoad32(&semaphore->count, MEMORY_ORDER_RELAXED);
+    while (count > 0) {
+        s32 previous_count = AtomicCompareExchange32(&semaphore->count, count, count - 1, MEMORY_ORDER_ACQUIRE);
+        if (previous_count == count) {
+            return (B32_TRUE);
+        }
+
+        count = previous_count;
+    }
+
+    return (B32_FALSE);
+}
+
+__DANI_SYNC_DEF b32 dani_TryWaitSyncSemaphore(dani_sync_semaphore *semaphore) {
+    b32 result = DecrementSyncSemaphore(semaphore);
+
+#ifdef DANI_SYNC_STATISTICS
+    if (result) {
+        RecordSyncAcquire(&semaphore->statistics, 0, B32_FALSE);
+    }
+#endif // DANI_SYNC_STATISTICS
+
+    return (result);
+}
+
+__DANI_SYNC_DEF void dani_WaitSyncSemaphore(dani_sync_semaphore *semaphore) {
+    if (DecrementSyncSemaphore(semaphore)) {
+#ifdef DANI_SYNC_STATISTICS
+        RecordSyncAcquire(&semaphore->statistics, 0, B32_FALSE);
+#endif // DANI_SYNC_STATISTICS
+        return;
+    }
+
+#ifdef DANI_SYNC_STATISTICS
+    u64 wait_start_ticks = __rdtsc();
+#endif // DANI_SYNC_STATISTICS
+
+    for (u32 spin_count = 0; spin_count < DANI_SYNC_SPIN_COUNT; spin_count += 1) {
+        CpuPause();
+
+        if (DecrementSyncSemaphore(semaphore)) {
+#ifdef DANI_SYNC_STATISTICS
+            RecordSyncAcquire(&semaphore->statistics, wait_start_ticks, B32_FALSE);
+#endif // DANI_SYNC_STATISTICS
+            return;
+        }
+    }
+
+    AtomicIncrement32(&semaphore->sleeper_count);
+
+    s32 empty_count = 0;
+    b32 has_slept = B32_FALSE;
+    while (IsFalse(DecrementSyncSemaphore(semaphore))) {
+        WaitOnAddress((volatile VOID *)&semaphore->count, &empty_count, sizeof(empty_count), INFINITE);
+        has_slept = B32_TRUE;
+    }
+
+    AtomicDecrement32(&semaphore->sleeper_count);
+
+#ifdef DANI_SYNC_STATISTICS
+    RecordSyncAcquire(&semaphore->statistics, wait_start_ticks, has_slept);
+#else
+    Unused(has_slept);
+#endif // DANI_SYNC_STATISTICS
+}
+
+#endif // DANI_LIB_SYNC_IMPLEMENTATION
+
+/*
+Danilib - dani_sync.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/
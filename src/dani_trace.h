@@ -0,0 +1,598 @@
+// Danilib - dani_trace.h
+// Types and functions for reading binary trace files written by dani_profiler.h.
+//
+// Author: Dani Drywa (dani@drywa.me)
+//
+// Last change: 2026/10/16 (yyyy/mm/dd)
+//
+// License: See end of file
+//
+// Dependencies:
+// dani_base.h - for the basic types
+// Windows.h - for CreateFileA, GetFileSizeEx, ReadFile, and VirtualAlloc
+// stdio.h - for printf and fprintf. (printf can be replaced by specifying DANI_TRACE_PRINTF)
+// string.h - for memset, memcpy, and memcmp
+//
+// Notes:
+// All dependencies must be included before including this file.
+// To include the implementation specify DANI_LIB_TRACE_IMPLEMENTATION before including this file.
+// To use static versions of the functions specify DANI_TRACE_STATIC before including this file.
+// The trace is loaded into memory as a whole. Names are not copied and point directly into the loaded file.
+// By default the reader supports the same amount of zones and counters as the profiler does (1024 and 256). If the profiler was configured differently specify DANI_TRACE_ZONES_MAX and DANI_TRACE_COUNTERS_MAX before including this file.
+// The aggregate report keeps a zone stack per thread. It supports up to 64 threads with a stack depth of 256 each. These limits can be changed by specifying DANI_TRACE_THREADS_MAX and DANI_TRACE_STACK_DEPTH_MAX before including this file.
+//
+// File format:
+// The file starts with the 8 byte magic "DANITRCE" followed by a 4 byte little endian version number.
+// After the header follows a list of chunks. Each chunk starts with a 1 byte chunk type and a varint payload size.
+// All varints are unsigned LEB128 encoded.
+//
+// Events chunk (1): varint thread id, varint event count, varint base ticks, followed by the events.
+//   Each event is a varint (index << 2 | type) followed by a varint tick delta to the previous event (or the base ticks for the first one).
+//   Counter events (type 2) are followed by the raw 8 byte f64 value. Deltas wrap around, so they have to be added with unsigned 64 bit arithmetic.
+//   Event chunks of the same thread are always written in order.
+// Names chunk (2): a list of varint kind (0 = zone, 1 = counter), varint index, varint length, followed by length bytes of the name.
+// Info chunk (3): varint cpu frequency, varint start ticks, varint end ticks, varint dropped event count.
+//
+// How to use:
+//
+// dani_trace trace;
+// if (dani_LoadTrace(&trace, "profile.dtrace")) {
+//     dani_trace_iterator iterator = dani_BeginTraceIteration(&trace);
+//     dani_trace_event event;
+//     while (dani_NextTraceEvent(&iterator, &event)) {
+//         // Do something with the event
+//     }
+//
+//     dani_PrintTraceAggregate(&trace);
+//     dani_WriteTraceJSON(&trace, json_file); // Chrome trace event format, can be opened with chrome://tracing or https://ui.perfetto.dev
+//     dani_FreeTrace(&trace);
+// }
+//
+#ifndef __DANI_LIB_TRACE_H
+#define __DANI_LIB_TRACE_H
+
+#ifdef DANI_TRACE_STATIC
+#define __DANI_TRACE_DEC static
+#define __DANI_TRACE_DEF static
+#else
+#define __DANI_TRACE_DEC extern
+#define __DANI_TRACE_DEF
+#endif
+
+#ifndef DANI_TRACE_ZONES_MAX
+#define DANI_TRACE_ZONES_MAX 1024
+#endif
+
+#ifndef DANI_TRACE_COUNTERS_MAX
+#define DANI_TRACE_COUNTERS_MAX 256
+#endif
+
+#ifndef DANI_TRACE_THREADS_MAX
+#define DANI_TRACE_THREADS_MAX 64
+#endif
+
+#ifndef DANI_TRACE_STACK_DEPTH_MAX
+#define DANI_TRACE_STACK_DEPTH_MAX 256
+#endif
+
+#ifndef DANI_TRACE_PRINTF
+#define DANI_TRACE_PRINTF(...) printf(__VA_ARGS__)
+#endif
+
+#define DANI_TRACE_EVENT_BEGIN 0
+#define DANI_TRACE_EVENT_END 1
+#define DANI_TRACE_EVENT_COUNTER 2
+
+#define DANI_TRACE_CHUNK_EVENTS 1
+#define DANI_TRACE_CHUNK_NAMES 2
+#define DANI_TRACE_CHUNK_INFO 3
+
+typedef struct __DANI_TRACE_NAME dani_trace_name;
+struct __DANI_TRACE_NAME {
+    const s8 *data;
+    u32 length;
+};
+
+typedef struct __DANI_TRACE dani_trace;
+struct __DANI_TRACE {
+    u8 *data;
+    u64 size;
+
+    u64 cpu_frequency;
+    u64 start_ticks;
+    u64 end_ticks;
+    u64 dropped_event_count;
+
+    dani_trace_name zone_names[DANI_TRACE_ZONES_MAX];
+    dani_trace_name counter_names[DANI_TRACE_COUNTERS_MAX];
+};
+
+typedef struct __DANI_TRACE_EVENT dani_trace_event;
+struct __DANI_TRACE_EVENT {
+    u64 ticks;
+    f64 value; // Only valid for counter events
+
+    u32 thread_id;
+    u32 index;
+    u32 type;
+};
+
+typedef struct __DANI_TRACE_ITERATOR dani_trace_iterator;
+struct __DANI_TRACE_ITERATOR {
+    const u8 *at;
+    const u8 *end;
+
+    const u8 *chunk_end;
+    u32 chunk_thread_id;
+    u32 chunk_events_left;
+    u64 chunk_ticks;
+};
+
+__DANI_TRACE_DEC b32 dani_LoadTrace(dani_trace *trace, const s8 *file_name);
+__DANI_TRACE_DEC void dani_FreeTrace(dani_trace *trace);
+
+__DANI_TRACE_DEC dani_trace_iterator dani_BeginTraceIteration(dani_trace *trace);
+__DANI_TRACE_DEC b32 dani_NextTraceEvent(dani_trace_iterator *iterator, dani_trace_event *event);
+
+__DANI_TRACE_DEC void dani_PrintTraceAggregate(dani_trace *trace);
+__DANI_TRACE_DEC void dani_WriteTraceJSON(dani_trace *trace, FILE *file);
+
+#endif // __DANI_LIB_TRACE_H
+
+#ifdef DANI_LIB_TRACE_IMPLEMENTATION
+
+#define DANI_TRACE_FILE_HEADER_SIZE 12
+
+static u64 DecodeTraceVarint(const u8 **at, const u8 *end) {
+    u64 result = 0;
+    u32 shift = 0;
+
+    const u8 *read = *at;
+    while (read < end && shift < 64) {
+        u8 byte = *read++;
+        result |= ((u64)(byte & 0x7F)) << shift;
+        shift += 7;
+
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+
+    *at = read;
+    return (result);
+}
+
+static b32 NextTraceChunk(const u8 **at, const u8 *end, u8 *chunk_type, const u8 **payload, const u8 **payload_end) {
+    if (*at >= end) {
+        return (B32_FALSE);
+    }
+
+    *chunk_type = **at;
+    *at += 1;
+
+    u64 payload_size = DecodeTraceVarint(at, end);
+    if (payload_size > (u64)(end - *at)) {
+        // Truncated file, e.g. the program crashed while writing
+        return (B32_FALSE);
+    }
+
+    *payload = *at;
+    *payload_end = *at + payload_size;
+    *at = *payload_end;
+
+    return (B32_TRUE);
+}
+
+static void ReadTraceNames(dani_trace *trace, const u8 *at, const u8 *end) {
+    while (at < end) {
+        u64 kind = DecodeTraceVarint(&at, end);
+        u64 index = DecodeTraceVarint(&at, end);
+        u64 length = DecodeTraceVarint(&at, end);
+        if (length > (u64)(end - at)) {
+            break;
+        }
+
+        dani_trace_name name;
+        name.data = (const s8 *)at;
+        name.length = (u32)length;
+
+        if (kind == 0 && index < DANI_TRACE_ZONES_MAX) {
+            trace->zone_names[index] = name;
+        } else if (kind == 1 && index < DANI_TRACE_COUNTERS_MAX) {
+            trace->counter_names[index] = name;
+        }
+
+        at += length;
+    }
+}
+
+static void ReadTraceInfo(dani_trace *trace, const u8 *at, const u8 *end) {
+    trace->cpu_frequency = DecodeTraceVarint(&at, end);
+    trace->start_ticks = DecodeTraceVarint(&at, end);
+    trace->end_ticks = DecodeTraceVarint(&at, end);
+    trace->dropped_event_count = DecodeTraceVarint(&at, end);
+}
+
+__DANI_TRACE_DEF b32 dani_LoadTrace(dani_trace *trace, const s8 *file_name) {
+    memset(trace, 0, sizeof(*trace));
+
+    void *file_handle = CreateFileA((const char *)file_name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return (B32_FAILURE);
+    }
+
+    b32 result = B32_FAILURE;
+
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file_handle, &file_size) && file_size.QuadPart >= DANI_TRACE_FILE_HEADER_SIZE) {
+        trace->size = (u64)file_size.QuadPart;
+        trace->data = (u8 *)VirtualAlloc(0, trace->size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+        if (trace->data) {
+            // ReadFile can only read up to 4GiB at once
+            u64 read_total = 0;
+            while (read_total < trace->size) {
+                u64 read_size = Min(trace->size - read_total, (u64)GiB(1));
+                DWORD read = 0;
+                if (!ReadFile(file_handle, trace->data + read_total, (DWORD)read_size, &read, 0) || read == 0) {
+                    break;
+                }
+                read_total += read;
+            }
+
+            const u8 magic[8] = { 'D', 'A', 'N', 'I', 'T', 'R', 'C', 'E' };
+            if (read_total == trace->size && memcmp(trace->data, magic, sizeof(magic)) == 0) {
+                result = B32_SUCCESS;
+            }
+        }
+    }
+
+    CloseHandle(file_handle);
+
+    if (IsSuccess(result)) {
+        const u8 *at = trace->data + DANI_TRACE_FILE_HEADER_SIZE;
+        const u8 *end = trace->data + trace->size;
+
+        u8 chunk_type;
+        const u8 *payload;
+        const u8 *payload_end;
+        while (NextTraceChunk(&at, end, &chunk_type, &payload, &payload_end)) {
+            if (chunk_type == DANI_TRACE_CHUNK_NAMES) {
+                ReadTraceNames(trace, payload, payload_end);
+            } else if (chunk_type == DANI_TRACE_CHUNK_INFO) {
+                ReadTraceInfo(trace, payload, payload_end);
+            }
+        }
+    } else {
+        dani_FreeTrace(trace);
+    }
+
+    return (result);
+}
+
+__DANI_TRACE_DEF void dani_FreeTrace(dani_trace *trace) {
+    if (trace->data) {
+        VirtualFree(trace->data, 0, MEM_RELEASE);
+    }
+
+    memset(trace, 0, sizeof(*trace));
+}
+
+__DANI_TRACE_DEF dani_trace_iterator dani_BeginTraceIteration(dani_trace *trace) {
+    dani_trace_iterator result = {0};
+
+    if (trace->data) {
+        result.at = trace->data + DANI_TRACE_FILE_HEADER_SIZE;
+        result.end = trace->data + trace->size;
+    }
+
+    return (result);
+}
+
+__DANI_TRACE_DEF b32 dani_NextTraceEvent(dani_trace_iterator *iterator, dani_trace_event *event) {
+    // Skip to the next events chunk if the current one is done
+    while (iterator->chunk_events_left == 0) {
+        if (iterator->chunk_end) {
+            iterator->at = iterator->chunk_end;
+            iterator->chunk_end = 0;
+        }
+
+        u8 chunk_type;
+        const u8 *payload;
+        const u8 *payload_end;
+        if (!NextTraceChunk(&iterator->at, iterator->end, &chunk_type, &payload, &payload_end)) {
+            return (B32_FALSE);
+        }
+
+        if (chunk_type == DANI_TRACE_CHUNK_EVENTS) {
+            iterator->at = payload;
+            iterator->chunk_end = payload_end;
+            iterator->chunk_thread_id = (u32)DecodeTraceVarint(&iterator->at, payload_end);
+            iterator->chunk_events_left = (u32)DecodeTraceVarint(&iterator->at, payload_end);
+            iterator->chunk_ticks = DecodeTraceVarint(&iterator->at, payload_end);
+        }
+    }
+
+    u64 index_and_type = DecodeTraceVarint(&iterator->at, iterator->chunk_end);
+    iterator->chunk_ticks += DecodeTraceVarint(&iterator->at, iterator->chunk_end);
+
+    event->ticks = iterator->chunk_ticks;
+    event->value = 0.0;
+    event->thread_id = iterator->chunk_thread_id;
+    event->index = (u32)(index_and_type >> 2);
+    event->type = (u32)(index_and_type & 0x3);
+
+    if (event->type == DANI_TRACE_EVENT_COUNTER) {
+        if ((u64)(iterator->chunk_end - iterator->at) >= sizeof(event->value)) {
+            memcpy(&event->value, iterator->at, sizeof(event->value));
+        }
+        iterator->at += sizeof(event->value);
+    }
+
+    iterator->chunk_events_left -= 1;
+
+    // Never read past a corrupted chunk
+    if (iterator->at > iterator->chunk_end) {
+        iterator->chunk_events_left = 0;
+        return (B32_FALSE);
+    }
+
+    return (B32_TRUE);
+}
+
+typedef struct __DANI_TRACE_FRAME dani_trace_frame;
+struct __DANI_TRACE_FRAME {
+    u64 start_ticks;
+    u64 children_ticks;
+    u32 index;
+};
+
+typedef struct __DANI_TRACE_THREAD dani_trace_thread;
+struct __DANI_TRACE_THREAD {
+    u32 thread_id;
+    u32 depth;
+    dani_trace_frame frames[DANI_TRACE_STACK_DEPTH_MAX];
+};
+
+typedef struct __DANI_TRACE_AGGREGATE_ZONE dani_trace_aggregate_zone;
+struct __DANI_TRACE_AGGREGATE_ZONE {
+    u64 inclusive_ticks;
+    u64 exclusive_ticks;
+    u64 hit_counter;
+};
+
+typedef struct __DANI_TRACE_AGGREGATE_COUNTER dani_trace_aggregate_counter;
+struct __DANI_TRACE_AGGREGATE_COUNTER {
+    f64 last_value;
+    f64 min_value;
+    f64 max_value;
+    f64 sum_value;
+    u64 sample_counter;
+};
+
+typedef struct __DANI_TRACE_AGGREGATE dani_trace_aggregate;
+struct __DANI_TRACE_AGGREGATE {
+    dani_trace_aggregate_zone zones[DANI_TRACE_ZONES_MAX];
+    dani_trace_aggregate_counter counters[DANI_TRACE_COUNTERS_MAX];
+    dani_trace_thread threads[DANI_TRACE_THREADS_MAX];
+    u32 thread_count;
+};
+
+static dani_trace_thread *GetTraceThread(dani_trace_aggregate *aggregate, u32 thread_id) {
+    for (u32 thread_index = 0; thread_index < aggregate->thread_count; thread_index += 1) {
+        if (aggregate->threads[thread_index].thread_id == thread_id) {
+            return (&aggregate->threads[thread_index]);
+        }
+    }
+
+    dani_trace_thread *result = 0;
+    if (aggregate->thread_count < DANI_TRACE_THREADS_MAX) {
+        result = &aggregate->threads[aggregate->thread_count];
+        result->thread_id = thread_id;
+        result->depth = 0;
+        aggregate->thread_count += 1;
+    }
+
+    return (result);
+}
+
+static void AggregateTraceEvent(dani_trace_aggregate *aggregate, dani_trace_event *event) {
+    if (event->type == DANI_TRACE_EVENT_COUNTER) {
+        if (event->index < DANI_TRACE_COUNTERS_MAX) {
+            dani_trace_aggregate_counter *counter = &aggregate->counters[event->index];
+            if (counter->sample_counter == 0) {
+                counter->min_value = event->value;
+                counter->max_value = event->value;
+            } else {
+                counter->min_value = Min(counter->min_value, event->value);
+                counter->max_value = Max(counter->max_value, event->value);
+            }
+            counter->last_value = event->value;
+            counter->sum_value += event->value;
+            counter->sample_counter += 1;
+        }
+        return;
+    }
+
+    dani_trace_thread *thread = GetTraceThread(aggregate, event->thread_id);
+    if (thread == 0 || event->index >= DANI_TRACE_ZONES_MAX) {
+        return;
+    }
+
+    if (event->type == DANI_TRACE_EVENT_BEGIN) {
+        if (thread->depth < DANI_TRACE_STACK_DEPTH_MAX) {
+            dani_trace_frame *frame = &thread->frames[thread->depth];
+            frame->start_ticks = event->ticks;
+            frame->children_ticks = 0;
+            frame->index = event->index;
+        }
+        thread->depth += 1;
+    } else if (event->type == DANI_TRACE_EVENT_END && thread->depth > 0) {
+        // Frames above the stack limit are not stored, so their ends can't be matched
+        if (thread->depth > DANI_TRACE_STACK_DEPTH_MAX) {
+            thread->depth -= 1;
+            return;
+        }
+
+        // The end closes the innermost frame of its zone. Frames above it lost their end to a full trace and are discarded, an end without a begin is ignored.
+        u32 depth = thread->depth;
+        while (depth > 0 && thread->frames[depth - 1].index != event->index) {
+            depth -= 1;
+        }
+
+        if (depth > 0) {
+            thread->depth = depth - 1;
+            dani_trace_frame *frame = &thread->frames[thread->depth];
+            u64 elapsed_ticks = event->ticks - frame->start_ticks;
+
+            dani_trace_aggregate_zone *zone = &aggregate->zones[frame->index];
+            zone->exclusive_ticks += elapsed_ticks - frame->children_ticks;
+            zone->hit_counter += 1;
+
+            // Recursive zones must only count their outermost invocation as inclusive time
+            b32 is_recursive = B32_FALSE;
+            for (u32 frame_index = 0; frame_index < thread->depth; frame_index += 1) {
+                if (thread->frames[frame_index].index == frame->index) {
+                    is_recursive = B32_TRUE;
+                    break;
+                }
+            }
+
+            if (IsFalse(is_recursive)) {
+                zone->inclusive_ticks += elapsed_ticks;
+            }
+
+            if (thread->depth > 0) {
+                thread->frames[thread->depth - 1].children_ticks += elapsed_ticks;
+            }
+        }
+    }
+}
+
+__DANI_TRACE_DEF void dani_PrintTraceAggregate(dani_trace *trace) {
+    dani_trace_aggregate *aggregate = (dani_trace_aggregate *)VirtualAlloc(0, sizeof(dani_trace_aggregate), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (aggregate == 0) {
+        return;
+    }
+
+    dani_trace_iterator iterator = dani_BeginTraceIteration(trace);
+    dani_trace_event event;
+    while (dani_NextTraceEvent(&iterator, &event)) {
+        AggregateTraceEvent(aggregate, &event);
+    }
+
+    u64 elapsed_total_ticks = trace->end_ticks - trace->start_ticks;
+    f64 cpu_frequency = (f64)trace->cpu_frequency;
+
+    if (trace->cpu_frequency && elapsed_total_ticks) {
+        DANI_TRACE_PRINTF("Total time: %0.4fms @ %0.2fGHz, Threads: %u, Dropped events: %llu\n", ((f64)elapsed_total_ticks / cpu_frequency) * 1000.0, cpu_frequency / 1000000000.0, aggregate->thread_count, trace->dropped_event_count);
+
+        for (u32 zone_index = 0; zone_index < DANI_TRACE_ZONES_MAX; zone_index += 1) {
+            dani_trace_aggregate_zone *zone = &aggregate->zones[zone_index];
+            if (zone->hit_counter) {
+                dani_trace_name *name = &trace->zone_names[zone_index];
+                f64 inclusive_percentage = ((f64)zone->inclusive_ticks / (f64)elapsed_total_ticks) * 100.0;
+                f64 exclusive_percentage = ((f64)zone->exclusive_ticks / (f64)elapsed_total_ticks) * 100.0;
+
+                DANI_TRACE_PRINTF("  %.*s[%llu] Incl[%0.2f%%]: %0.4fms, Excl[%0.2f%%]: %0.4fms\n", name->length, name->data, zone->hit_counter,
+                    inclusive_percentage, ((f64)zone->inclusive_ticks / cpu_frequency) * 1000.0,
+                    exclusive_percentage, ((f64)zone->exclusive_ticks / cpu_frequency) * 1000.0);
+            }
+        }
+
+        for (u32 counter_index = 0; counter_index < DANI_TRACE_COUNTERS_MAX; counter_index += 1) {
+            dani_trace_aggregate_counter *counter = &aggregate->counters[counter_index];
+            if (counter->sample_counter) {
+                dani_trace_name *name = &trace->counter_names[counter_index];
+                f64 average_value = counter->sum_value / (f64)counter->sample_counter;
+
+                DANI_TRACE_PRINTF("  %.*s[%llu] Counter - Last: %0.2f, Min: %0.2f, Max: %0.2f, Average: %0.2f\n", name->length, name->data, counter->sample_counter,
+                    counter->last_value, counter->min_value, counter->max_value, average_value);
+            }
+        }
+    } else {
+        DANI_TRACE_PRINTF("Trace is missing its info chunk (the program did not call dani_EndProfiling)\n");
+    }
+
+    VirtualFree(aggregate, 0, MEM_RELEASE);
+}
+
+static void WriteTraceJSONName(FILE *file, dani_trace_name *name) {
+    fputc('"', file);
+    for (u32 char_index = 0; char_index < name->length; char_index += 1) {
+        s8 c = name->data[char_index];
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+        }
+        fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+__DANI_TRACE_DEF void dani_WriteTraceJSON(dani_trace *trace, FILE *file) {
+    // Without a frequency timestamps are written as raw ticks
+    f64 ticks_to_microseconds = 1.0;
+    if (trace->cpu_frequency) {
+        ticks_to_microseconds = 1000000.0 / (f64)trace->cpu_frequency;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+
+    b32 is_first = B32_TRUE;
+    dani_trace_iterator iterator = dani_BeginTraceIteration(trace);
+    dani_trace_event event;
+    while (dani_NextTraceEvent(&iterator, &event)) {
+        dani_trace_name *name = 0;
+        if (event.type == DANI_TRACE_EVENT_COUNTER && event.index < DANI_TRACE_COUNTERS_MAX) {
+            name = &trace->counter_names[event.index];
+        } else if (event.type != DANI_TRACE_EVENT_COUNTER && event.index < DANI_TRACE_ZONES_MAX) {
+            name = &trace->zone_names[event.index];
+        }
+
+        if (name == 0) {
+            continue;
+        }
+
+        f64 timestamp = (f64)(event.ticks - trace->start_ticks) * ticks_to_microseconds;
+
+        fprintf(file, is_first ? "{\"name\":" : ",\n{\"name\":");
+        WriteTraceJSONName(file, name);
+
+        if (event.type == DANI_TRACE_EVENT_COUNTER) {
+            fprintf(file, ",\"ph\":\"C\",\"ts\":%0.3f,\"pid\":0,\"args\":{\"value\":%f}}", timestamp, event.value);
+        } else {
+            fprintf(file, ",\"ph\":\"%c\",\"ts\":%0.3f,\"pid\":0,\"tid\":%u}", (event.type == DANI_TRACE_EVENT_BEGIN) ? 'B' : 'E', timestamp, event.thread_id);
+        }
+
+        is_first = B32_FALSE;
+    }
+
+    fprintf(file, "\n]}\n");
+}
+
+#endif // DANI_LIB_TRACE_IMPLEMENTATION
+
+/*
+Danilib - dani_trace.h License:
+---------------------------------------------------------------------------------
+Copyright (c) 2026 Dani Drywa (dani@drywa.me)
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+4. If you use this software in a product, a donation to the original author
+   (https://ko-fi.com/danicrunch) would be appreciated but is not required.
+---------------------------------------------------------------------------------
+*/